@@ -3,6 +3,22 @@
  *   Module for image convolution functions.
  *
  *   MODIFICATION HISTORY:
+ *     17 Oct 2026: FFT convolution no longer re-zeros the padded input array or
+ * uses a separate product array; the 1/N rescaling is folded into the PSF
+ * transform; the padded input array can be written to directly by the caller.
+ *     17 Oct 2026: Added spatially varying PSF convolution using a PSF basis;
+ * FFTW plans are now shared separately from PSF transforms.
+ *     17 Oct 2026: Added tiled (overlap-save) FFT convolution, for images too
+ * large to convolve with a single FFT.
+ *     17 Oct 2026: PSF transforms and FFTW plans are now shared by all Convolver
+ * objects with the same padded size, PSF, and FFT settings.
+ *     17 Oct 2026: Added optional single-precision (fftwf) FFT convolution.
+ *     17 Oct 2026: Added direct and separable (spatial-domain) convolution, with
+ * automatic choice between FFT and direct convolution at setup.
+ *     17 Oct 2026: Padded image sizes are now rounded up to FFT-friendly values
+ * (products of 2, 3, 5, and 7).
+ *     17 Oct 2026: Added selectable FFTW planning rigor, with FFTW wisdom saved
+ * to (and re-used from) a file.
  *     [v0.2]: 31 May/1 June 2010: Fixed bug in dealing with non-square images:
  * calls to fftw_plan_* functions had nRows and nColumns in the wrong order!
  *     [v0.1]: 15 April 2010: More or less usable now (thought not thoroughly tested,
@@ -79,6 +95,13 @@
 // 			A. Normalize PSF (if necessary)
 // 			B. ShiftAndWrapPSF()
 // 			C. fftw_execute(plan_psf)
+//
+// 	[Steps 5 and 6 -- and the allocation of psf_fft -- are skipped if another
+// 	Convolver with the same padded size, PSF, etc. already exists; the PSF
+// 	transform and the plan_inputImage and plan_inverse plans are then shared
+// 	via the SharedConvolutionResources registry, with each Convolver using
+// 	its own image_in, image_fft, multiplied, and convolvedData arrays. Convolvers
+// 	with different PSFs but the same padded size share just the plans.]
 // 
 // REPEAT FROM MODELOBJECT TILL DONE:
 // 	1. Copy modelVector [double] into image_in [fftw_complex]
@@ -109,19 +132,230 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <algorithm>
 
 #include "fftw3.h"
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_linalg.h>
 
 #ifdef FFTW_THREADING
 #include <unistd.h>
 #endif  // FFTW_THREADING
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "definitions.h"
 #include "convolver.h"
 #include "count_cpu_cores.h"
 
 #define DEFAULT_OPENMP_CHUNK_SIZE  10
 
+static bool  fftwWisdomImported = false;
+static bool  fftwfWisdomImported = false;
+
+// Approximate relative cost (per element) of FFTW's passes for factors of 2, 3, 5,
+// and 7 (roughly proportional to log2(p), with extra penalty for larger radices)
+const int  N_SMALL_PRIMES = 4;
+const int  SMALL_PRIMES[N_SMALL_PRIMES] = {2, 3, 5, 7};
+const double  SMALL_PRIME_COSTS[N_SMALL_PRIMES] = {1.0, 1.7, 2.6, 3.4};
+
+// Terms in the separable (SVD) decomposition of the PSF are kept until the
+// remaining terms account for less than this fraction of the PSF (in the sense of
+// the Frobenius norm); this is comparable to the precision of single-precision
+// (32-bit floating-point) PSF images. Since the result is then only approximate,
+// separable convolution is never chosen automatically.
+const double  SEPARABLE_PSF_TOLERANCE = 1.0e-7;
+
+// Two PSFs are considered identical (for sharing PSF transforms) if corresponding
+// pixel values agree to within this relative tolerance; this allows for the
+// roundoff differences produced when the same PSF array is normalized more
+// than once (e.g., by several OversampledRegion objects sharing an oversampled PSF)
+const double  PSF_MATCH_TOLERANCE = 1.0e-12;
+
+
+/// FFTW plans for the forward and inverse FFTs of padded images, which can be
+/// shared by all Convolver objects with the same padded image size, precision, and
+/// FFTW planning options, regardless of their PSFs.
+struct SharedFFTWPlans
+{
+  // identifying information
+  int  nColumns_padded, nRows_padded;
+  bool  useFloatFFT;
+  int  fftwPlanningMode, nThreads;
+  // shared data
+  fftw_plan  plan_inputImage, plan_inverse;
+  fftwf_plan  plan_inputImage_f, plan_inverse_f;
+  int  nUsers;
+};
+
+/// PSF transform and FFTW plans for FFT convolution, which can be shared by all
+/// Convolver objects with the same padded image size, PSF, precision, and FFTW
+/// planning options. Since each Convolver executes the plans with its own arrays 
+/// (via fftw_execute_dft_r2c, etc.), these are never modified after creation.
+struct SharedConvolutionResources
+{
+  // identifying information
+  int  nColumns_padded, nRows_padded;
+  int  nColumns_psf, nRows_psf;
+  bool  useFloatFFT;
+  int  fftwPlanningMode, nThreads;
+  vector<double>  psfPixels;   // copy of (normalized) PSF image
+  // shared data
+  fftw_complex  *psf_fft_cmplx;
+  fftwf_complex  *psf_fft_cmplx_f;
+  SharedFFTWPlans  *plans;   // (possibly also used with other PSFs)
+  int  nUsers;
+};
+
+// All currently existing shared resources and plans. Note that this (like FFTW
+// planning itself) is not thread-safe: Convolver setup and deletion should not be
+// done from multiple threads at once.
+static vector<SharedConvolutionResources *>  sharedResourcesRegistry;
+static vector<SharedFFTWPlans *>  sharedPlansRegistry;
+
+
+
+/* ---------------- FUNCTION: FFTCostPerElement ----------------------- */
+// Returns the approximate cost per element of a 1D FFT of size n, or -1 if n has
+// prime factors larger than 7 (which FFTW handles much more slowly)
+static double FFTCostPerElement( int n )
+{
+  double  cost = 0.0;
+  
+  for (int k = 0; k < N_SMALL_PRIMES; k++) {
+    while ((n % SMALL_PRIMES[k]) == 0) {
+      n /= SMALL_PRIMES[k];
+      cost += SMALL_PRIME_COSTS[k];
+    }
+  }
+  if (n > 1)
+    return -1.0;
+  return cost;
+}
+
+
+/* ---------------- FUNCTION: GetFFTFriendlyPaddedSize ----------------- */
+/// Chooses padded dimensions (nColumns_padded >= minColumns, nRows_padded >= minRows)
+/// for which FFTs will be fast. Sizes with only small prime factors (2, 3, 5, 7)
+/// up to the next power of 2 are considered for each axis; each combination is
+/// assigned an estimated cost for the 2D FFT -- nRows*nColumns*(c(nRows) + c(nColumns)),
+/// where c(n) is the cost per element of a 1D FFT of size n -- and the cheapest
+/// combination is chosen. Since the input image is placed at the origin and the
+/// PSF is wrapped around the origin, any padded size >= image size + PSF size - 1
+/// gives the same convolution.
+void GetFFTFriendlyPaddedSize( int minColumns, int minRows, int& nColumns_padded,
+								int& nRows_padded )
+{
+  vector<int>  candidateColumns, candidateRows;
+  vector<double>  costColumns, costRows;
+  double  cost, bestCost = -1.0;
+  int  n, upperLimit;
+  
+  upperLimit = 1;
+  while (upperLimit < minColumns)
+    upperLimit *= 2;
+  for (n = minColumns; n <= upperLimit; n++) {
+    cost = FFTCostPerElement(n);
+    if (cost >= 0.0) {
+      candidateColumns.push_back(n);
+      costColumns.push_back(cost);
+    }
+  }
+  upperLimit = 1;
+  while (upperLimit < minRows)
+    upperLimit *= 2;
+  for (n = minRows; n <= upperLimit; n++) {
+    cost = FFTCostPerElement(n);
+    if (cost >= 0.0) {
+      candidateRows.push_back(n);
+      costRows.push_back(cost);
+    }
+  }
+  
+  nColumns_padded = minColumns;
+  nRows_padded = minRows;
+  for (int i = 0; i < (int)candidateRows.size(); i++) {
+    for (int j = 0; j < (int)candidateColumns.size(); j++) {
+      cost = (double)candidateRows[i] * (double)candidateColumns[j] * (costRows[i] + costColumns[j]);
+      if ((bestCost < 0.0) || (cost < bestCost)) {
+        bestCost = cost;
+        nRows_padded = candidateRows[i];
+        nColumns_padded = candidateColumns[j];
+      }
+    }
+  }
+}
+
+
+/* ---------------- FUNCTION: GetFFTWPlannerFlags ---------------------- */
+/// Translates our planning mode into the corresponding FFTW planner flag.
+/// Note that anything more rigorous than FFTW_ESTIMATE means that FFTW will
+/// overwrite the input arrays during planning.
+unsigned GetFFTWPlannerFlags( int planningMode )
+{
+  switch (planningMode) {
+    case FFTW_PLANNING_MEASURE:
+      return FFTW_MEASURE;
+    case FFTW_PLANNING_PATIENT:
+      return FFTW_PATIENT;
+    case FFTW_PLANNING_EXHAUSTIVE:
+      return FFTW_EXHAUSTIVE;
+    default:
+      return FFTW_ESTIMATE;
+  }
+}
+
+
+/* ---------------- FUNCTION: ExportFFTWWisdom ------------------------- */
+// Called automatically when the program exits (see UseFFTWWisdomFile)
+static void ExportFFTWWisdom( )
+{
+  if (fftw_export_wisdom_to_filename(FFTW_WISDOM_FILENAME) == 0)
+    fprintf(stderr, "*** WARNING: Unable to save FFTW wisdom to file \"%s\"!\n", 
+    		FFTW_WISDOM_FILENAME);
+}
+
+
+/* ---------------- FUNCTION: ExportFFTWFWisdom ------------------------ */
+// Single-precision version of ExportFFTWWisdom
+static void ExportFFTWFWisdom( )
+{
+  if (fftwf_export_wisdom_to_filename(FFTW_WISDOM_FILENAME_FLOAT) == 0)
+    fprintf(stderr, "*** WARNING: Unable to save FFTW wisdom to file \"%s\"!\n", 
+    		FFTW_WISDOM_FILENAME_FLOAT);
+}
+
+
+/* ---------------- FUNCTION: UseFFTWWisdomFile ------------------------ */
+/// Imports any FFTW wisdom (results of previous FFTW_MEASURE, etc. planning)
+/// saved by previous runs, so that planning for transforms of the same size,
+/// direction (r2c or c2r), and number of threads is nearly instantaneous; FFTW
+/// identifies each entry by these properties, so one file serves for all
+/// transforms. The first call also registers an exit function which writes
+/// the accumulated wisdom (old and new) back to the file.
+/// Single-precision (fftwf) wisdom is separate, and is kept in its own file.
+void UseFFTWWisdomFile( bool singlePrecision )
+{
+  if (singlePrecision) {
+    if (fftwfWisdomImported)
+      return;
+    fftwf_import_wisdom_from_filename(FFTW_WISDOM_FILENAME_FLOAT);
+    atexit(ExportFFTWFWisdom);
+    fftwfWisdomImported = true;
+    return;
+  }
+  if (fftwWisdomImported)
+    return;
+  // returns 0 (which we can ignore) if file doesn't exist yet
+  fftw_import_wisdom_from_filename(FFTW_WISDOM_FILENAME);
+  atexit(ExportFFTWWisdom);
+  fftwWisdomImported = true;
+}
+
 
 			
 /* ---------------- CONSTRUCTOR ---------------------------------------- */
@@ -132,9 +366,21 @@ Convolver::Convolver( )
   psfInfoSet = false;
   imageInfoSet = false;
   fftVectorsAllocated = false;
-  fftPlansCreated = false;
+  sharedResources = nullptr;
   normalizePSF = true;   // default is to normalize the PSF
   maxRequestedThreads = 0;   // default value --> use all available processors/cores
+  fftwPlanningMode = FFTW_PLANNING_ESTIMATE;
+  convolutionEngine = CONVOLUTION_ENGINE_AUTO;
+  useFloatFFT = false;
+  separableRank = 0;
+  separableKernelsAllocated = false;
+  spatialVectorsAllocated = false;
+  tileSize = 0;
+  nColumns_tile = nRows_tile = 0;
+  nTileThreads = 0;
+  tiledOutput = nullptr;
+  basisInput = basisSum = nullptr;
+  basisVectorsAllocated = false;
 }
 
 
@@ -144,18 +390,339 @@ Convolver::Convolver( )
 Convolver::~Convolver( )
 {
 
-  if (fftPlansCreated) {
-    fftw_destroy_plan(plan_inputImage);
-    fftw_destroy_plan(plan_psf);
-    fftw_destroy_plan(plan_inverse);
+  FreeFFTVectors();
+  FreeSpatialVectors();
+  if (separableKernelsAllocated) {
+    free(separableColumnKernels);
+    free(separableRowKernels);
+  }
+  for (Convolver *basisConvolver : basisConvolvers)
+    delete basisConvolver;
+  if (basisVectorsAllocated) {
+    free(basisInput);
+    free(basisSum);
   }
+}
+
+
+/* ---------------- FreeFFTVectors ------------------------------------- */
+/// Frees FFTW arrays and releases PSF transform and FFTW plans (e.g., when we're 
+/// using spatial-domain convolution)
+void Convolver::FreeFFTVectors( )
+{
+  ReleaseSharedResources();
   if (fftVectorsAllocated) {
-    fftw_free(image_in_padded);
-    fftw_free(image_fft_cmplx);
+    if (useFloatFFT) {
+      fftwf_free(image_in_padded_f);
+      fftwf_free(image_fft_cmplx_f);
+      fftwf_free(convolvedImage_out_f);
+    } else {
+      fftw_free(image_in_padded);
+      fftw_free(image_fft_cmplx);
+      fftw_free(convolvedImage_out);
+    }
+    fftVectorsAllocated = false;
+  }
+  // extra working arrays for tiled convolution (element 0 = arrays freed above)
+  for (size_t n = 1; n < tileInputArrays.size(); n++) {
+    fftw_free(tileInputArrays[n]);
+    fftw_free(tileFFTArrays[n]);
+    fftw_free(tileOutputArrays[n]);
+  }
+  tileInputArrays.clear();
+  tileFFTArrays.clear();
+  tileOutputArrays.clear();
+  free(tiledOutput);
+  tiledOutput = nullptr;
+}
+
+
+/* ---------------- AcquireSharedResources ----------------------------- */
+/// Finds the PSF transform and FFTW plans from an existing Convolver with the same
+/// padded size, (normalized) PSF, and FFT settings; if there is none, we allocate
+/// the PSF transform, make the plans, and compute the PSF transform, and store
+/// the results for use by later Convolvers. Must be called after the PSF has been
+/// normalized and the working arrays (image_in_padded, etc.) have been allocated.
+int Convolver::AcquireSharedResources( unsigned fftwFlags, int nThreads )
+{
+  SharedConvolutionResources  *resources;
+  long  k;
+  
+  for (SharedConvolutionResources *candidate : sharedResourcesRegistry) {
+    if ((candidate->nColumns_padded != nColumns_padded) || (candidate->nRows_padded != nRows_padded)
+    		|| (candidate->nColumns_psf != nColumns_psf) || (candidate->nRows_psf != nRows_psf)
+    		|| (candidate->useFloatFFT != useFloatFFT) 
+    		|| (candidate->fftwPlanningMode != fftwPlanningMode) || (candidate->nThreads != nThreads))
+      continue;
+    bool  samePSF = true;
+    for (k = 0; k < nPixels_psf; k++) {
+      if (fabs(candidate->psfPixels[k] - normalizedPSF[k]) > PSF_MATCH_TOLERANCE*fabs(normalizedPSF[k])) {
+        samePSF = false;
+        break;
+      }
+    }
+    if (samePSF) {
+      candidate->nUsers += 1;
+      sharedResources = candidate;
+      if (debugStatus >= 1)
+        printf("Using PSF transform and FFTW plans from previous Convolver ...\n");
+      return 0;
+    }
+  }
+  
+  resources = new SharedConvolutionResources;
+  resources->nColumns_padded = nColumns_padded;
+  resources->nRows_padded = nRows_padded;
+  resources->nColumns_psf = nColumns_psf;
+  resources->nRows_psf = nRows_psf;
+  resources->useFloatFFT = useFloatFFT;
+  resources->fftwPlanningMode = fftwPlanningMode;
+  resources->nThreads = nThreads;
+  resources->psfPixels = normalizedPSF;
+  resources->nUsers = 1;
+  
+  // Plans for the image FFTs can be re-used from Convolvers with different PSFs
+  // (e.g., the terms of a PSF basis), if the padded size and settings match
+  SharedFFTWPlans  *plans = nullptr;
+  for (SharedFFTWPlans *candidate : sharedPlansRegistry) {
+    if ((candidate->nColumns_padded == nColumns_padded) && (candidate->nRows_padded == nRows_padded)
+    		&& (candidate->useFloatFFT == useFloatFFT) 
+    		&& (candidate->fftwPlanningMode == fftwPlanningMode) && (candidate->nThreads == nThreads)) {
+      plans = candidate;
+      plans->nUsers += 1;
+      if (debugStatus >= 1)
+        printf("Using FFTW plans from previous Convolver ...\n");
+      break;
+    }
+  }
+  bool  newPlans = (plans == nullptr);
+  if (newPlans) {
+    plans = new SharedFFTWPlans;
+    plans->nColumns_padded = nColumns_padded;
+    plans->nRows_padded = nRows_padded;
+    plans->useFloatFFT = useFloatFFT;
+    plans->fftwPlanningMode = fftwPlanningMode;
+    plans->nThreads = nThreads;
+    plans->nUsers = 1;
+  }
+  resources->plans = plans;
+
+  // Set up FFTW plans, using our own working arrays (plans can be executed
+  // with any arrays having the same alignment, which fftw_malloc guarantees).
+  // Note that there's not much purpose in multi-threading plan_psf, since we only do
+  // the FFT of the PSF once
+  fftw_plan  plan_psf;
+  fftwf_plan  plan_psf_f;
+  if (useFloatFFT) {
+    psf_in_padded_f = (float*) fftwf_malloc(sizeof(float) * nPixels_padded);
+    resources->psf_fft_cmplx_f = (fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex) * nPixels_padded_complex);
+    if ((psf_in_padded_f == nullptr) || (resources->psf_fft_cmplx_f == nullptr)) {
+      fprintf(stderr, "*** WARNING: Convolver::AcquireSharedResources: memory allocation failure!\n");
+      fftwf_free(psf_in_padded_f);
+      fftwf_free(resources->psf_fft_cmplx_f);
+      if (newPlans)
+        delete plans;
+      else
+        plans->nUsers -= 1;
+      delete resources;
+      return -2;
+    }
+    plan_psf_f = fftwf_plan_dft_r2c_2d(nRows_padded, nColumns_padded, psf_in_padded_f, 
+  										resources->psf_fft_cmplx_f, fftwFlags);
+    if (newPlans) {
+#ifdef FFTW_THREADING
+      fftwf_plan_with_nthreads(nThreads);
+#endif  // FFTW_THREADING
+      plans->plan_inputImage_f = fftwf_plan_dft_r2c_2d(nRows_padded, nColumns_padded, 
+    										image_in_padded_f, image_fft_cmplx_f, fftwFlags);
+      plans->plan_inverse_f = fftwf_plan_dft_c2r_2d(nRows_padded, nColumns_padded, 
+    										image_fft_cmplx_f, convolvedImage_out_f, fftwFlags);
+    }
+  }
+  else {
+    psf_in_padded = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
+    resources->psf_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex);
+    if ((psf_in_padded == nullptr) || (resources->psf_fft_cmplx == nullptr)) {
+      fprintf(stderr, "*** WARNING: Convolver::AcquireSharedResources: memory allocation failure!\n");
+      fftw_free(psf_in_padded);
+      fftw_free(resources->psf_fft_cmplx);
+      if (newPlans)
+        delete plans;
+      else
+        plans->nUsers -= 1;
+      delete resources;
+      return -2;
+    }
+    plan_psf = fftw_plan_dft_r2c_2d(nRows_padded, nColumns_padded, psf_in_padded, 
+  									resources->psf_fft_cmplx, fftwFlags);
+    if (newPlans) {
+#ifdef FFTW_THREADING
+      fftw_plan_with_nthreads(nThreads);
+#endif  // FFTW_THREADING
+      plans->plan_inputImage = fftw_plan_dft_r2c_2d(nRows_padded, nColumns_padded, 
+    										image_in_padded, image_fft_cmplx, fftwFlags);
+      plans->plan_inverse = fftw_plan_dft_c2r_2d(nRows_padded, nColumns_padded, 
+    										image_fft_cmplx, convolvedImage_out, fftwFlags);
+    }
+  }
+
+  // Prepare padded psf array for FFT, and then copy input PSF into
+  // it with appropriate shift/wrap:
+  if (useFloatFFT) {
+    for (k = 0; k < nPixels_padded; k++)
+      psf_in_padded_f[k] = 0.0f;
+  } else {
+    for (k = 0; k < nPixels_padded; k++)
+      psf_in_padded[k] = 0.0;
+  }
+  if (debugStatus >= 1)
+    printf("Shifting and wrapping the PSF ...\n");
+  ShiftAndWrapPSF();
+  if ((debugStatus >= 2) && (! useFloatFFT)) {
+    printf("The whole padded, normalized PSF image, row by row:\n");
+    PrintRealImage(psf_in_padded, nColumns_padded, nRows_padded);
+  }
+  
+  // Do forward FFT on PSF image, then discard padded PSF image. The transform
+  // is multiplied by 1/nPixels_padded, to account for FFTW's unnormalized
+  // inverse transform, so that convolved images don't need to be rescaled.
+  double  rescaleFactor = 1.0 / nPixels_padded;
+  if (debugStatus >= 1)
+    printf("Performing FFT of PSF image ...\n");
+  if (useFloatFFT) {
+    fftwf_execute(plan_psf_f);
+    fftwf_destroy_plan(plan_psf_f);
+    fftwf_free(psf_in_padded_f);
+    for (k = 0; k < nPixels_padded_complex; k++) {
+      resources->psf_fft_cmplx_f[k][0] *= (float)rescaleFactor;
+      resources->psf_fft_cmplx_f[k][1] *= (float)rescaleFactor;
+    }
+  } else {
+    fftw_execute(plan_psf);
+    fftw_destroy_plan(plan_psf);
     fftw_free(psf_in_padded);
-    fftw_free(psf_fft_cmplx);
-    fftw_free(multiplied_cmplx);
-    fftw_free(convolvedImage_out);
+    for (k = 0; k < nPixels_padded_complex; k++) {
+      resources->psf_fft_cmplx[k][0] *= rescaleFactor;
+      resources->psf_fft_cmplx[k][1] *= rescaleFactor;
+    }
+  }
+  
+  if (newPlans)
+    sharedPlansRegistry.push_back(plans);
+  sharedResourcesRegistry.push_back(resources);
+  sharedResources = resources;
+  return 0;
+}
+
+
+/* ---------------- ReleaseSharedResources ----------------------------- */
+/// Stops using the shared PSF transform and FFTW plans; these are freed if no
+/// other Convolver is using them.
+void Convolver::ReleaseSharedResources( )
+{
+  if (sharedResources == nullptr)
+    return;
+  sharedResources->nUsers -= 1;
+  if (sharedResources->nUsers == 0) {
+    SharedFFTWPlans  *plans = sharedResources->plans;
+    plans->nUsers -= 1;
+    if (plans->nUsers == 0) {
+      if (plans->useFloatFFT) {
+        fftwf_destroy_plan(plans->plan_inputImage_f);
+        fftwf_destroy_plan(plans->plan_inverse_f);
+      } else {
+        fftw_destroy_plan(plans->plan_inputImage);
+        fftw_destroy_plan(plans->plan_inverse);
+      }
+      sharedPlansRegistry.erase(std::find(sharedPlansRegistry.begin(), 
+      								sharedPlansRegistry.end(), plans));
+      delete plans;
+    }
+    if (sharedResources->useFloatFFT)
+      fftwf_free(sharedResources->psf_fft_cmplx_f);
+    else
+      fftw_free(sharedResources->psf_fft_cmplx);
+    sharedResourcesRegistry.erase(std::find(sharedResourcesRegistry.begin(), 
+    								sharedResourcesRegistry.end(), sharedResources));
+    delete sharedResources;
+  }
+  sharedResources = nullptr;
+}
+
+
+/* ---------------- GetNSharingConvolvers ------------------------------ */
+int Convolver::GetNSharingConvolvers( )
+{
+  if (sharedResources == nullptr)
+    return 0;
+  return sharedResources->nUsers;
+}
+
+
+/* ---------------- GetNBasisPSFs -------------------------------------- */
+int Convolver::GetNBasisPSFs( )
+{
+  return (int)basisConvolvers.size();
+}
+
+
+/* ---------------- AllocateSpatialVectors ----------------------------- */
+/// Allocates the image-sized scratch arrays used by direct and separable convolution
+int Convolver::AllocateSpatialVectors( )
+{
+  if (spatialVectorsAllocated)
+    return 0;
+  spatialTemp = (double *)calloc((size_t)nPixels_image, sizeof(double));
+  spatialOutput = (double *)calloc((size_t)nPixels_image, sizeof(double));
+  if ((spatialTemp == nullptr) || (spatialOutput == nullptr)) {
+    fprintf(stderr, "*** WARNING: Convolver::AllocateSpatialVectors: memory allocation failure!\n");
+    free(spatialTemp);
+    free(spatialOutput);
+    return -1;
+  }
+  spatialVectorsAllocated = true;
+  return 0;
+}
+
+
+/* ---------------- AllocateTileVectors -------------------------------- */
+/// Allocates the working arrays for tiled FFT convolution: one set of padded
+/// arrays per thread (thread 0 uses image_in_padded, etc., which must already be
+/// allocated) and the image-sized array in which the convolved image is assembled.
+int Convolver::AllocateTileVectors( )
+{
+  tileInputArrays.assign(1, image_in_padded);
+  tileFFTArrays.assign(1, image_fft_cmplx);
+  tileOutputArrays.assign(1, convolvedImage_out);
+  for (int n = 1; n < nTileThreads; n++) {
+    tileInputArrays.push_back((double*) fftw_malloc(sizeof(double) * nPixels_padded));
+    tileFFTArrays.push_back((fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex));
+    tileOutputArrays.push_back((double*) fftw_malloc(sizeof(double) * nPixels_padded));
+    if ((tileInputArrays[n] == nullptr) || (tileFFTArrays[n] == nullptr) 
+    		|| (tileOutputArrays[n] == nullptr)) {
+      fprintf(stderr, "*** WARNING: Convolver::AllocateTileVectors: memory allocation failure!\n");
+      return -1;
+    }
+    // padding outside the region filled for each tile stays zero
+    for (long k = 0; k < nPixels_padded; k++)
+      tileInputArrays[n][k] = 0.0;
+  }
+  tiledOutput = (double *)calloc((size_t)nPixels_image, sizeof(double));
+  if (tiledOutput == nullptr) {
+    fprintf(stderr, "*** WARNING: Convolver::AllocateTileVectors: memory allocation failure!\n");
+    return -1;
+  }
+  return 0;
+}
+
+
+/* ---------------- FreeSpatialVectors --------------------------------- */
+void Convolver::FreeSpatialVectors( )
+{
+  if (spatialVectorsAllocated) {
+    free(spatialTemp);
+    free(spatialOutput);
+    spatialVectorsAllocated = false;
   }
 }
 
@@ -169,9 +736,97 @@ void Convolver::SetMaxThreads( int maximumThreadNumber )
 }
 
 
+/* ---------------- SetFFTWPlanning ------------------------------------ */
+/// Specifies how much effort FFTW should spend on finding fast plans for the
+/// FFTs (FFTW_PLANNING_ESTIMATE [default], FFTW_PLANNING_MEASURE, 
+/// FFTW_PLANNING_PATIENT, or FFTW_PLANNING_EXHAUSTIVE); anything beyond 
+/// FFTW_PLANNING_ESTIMATE also means saved FFTW wisdom will be used and updated.
+/// Must be called before DoFullSetup().
+void Convolver::SetFFTWPlanning( int planningMode )
+{
+  fftwPlanningMode = planningMode;
+}
+
+
+/* ---------------- SetConvolutionEngine ------------------------------- */
+/// Specifies the convolution method: CONVOLUTION_ENGINE_FFT, CONVOLUTION_ENGINE_DIRECT,
+/// CONVOLUTION_ENGINE_SEPARABLE, or CONVOLUTION_ENGINE_AUTO (the default), which
+/// means that DoFullSetup() will choose FFT or direct convolution, whichever has
+/// the smaller estimated operation count. (Separable convolution approximates
+/// the PSF, and so is only used if explicitly requested.)
+/// Must be called before DoFullSetup().
+void Convolver::SetConvolutionEngine( int engineType )
+{
+  convolutionEngine = engineType;
+}
+
+
+/* ---------------- UseFloatConvolution -------------------------------- */
+/// Specifies whether FFT-based convolution should be done in single precision
+/// (fftwf plans and float arrays), which halves the memory used by the padded
+/// FFT arrays and roughly doubles the SIMD width of the FFTs. The input and
+/// output images remain double-precision; errors in the convolved image are
+/// then ~ 1e-6 -- 1e-7 of the image's peak value, rather than ~ 1e-15.
+/// Must be called before DoFullSetup().
+void Convolver::UseFloatConvolution( bool useFloat )
+{
+  useFloatFFT = useFloat;
+}
+
+
+/* ---------------- SetTileSize ---------------------------------------- */
+/// Specifies the size of the image tiles (tileSize x tileSize pixels) for tiled
+/// FFT convolution. Each tile is convolved separately (in parallel, if OpenMP is
+/// available), using FFTs of size ~ (tileSize + PSF size)^2 instead of the size of
+/// the whole (padded) image. Must be called before DoFullSetup().
+void Convolver::SetTileSize( int tileSize_input )
+{
+  tileSize = tileSize_input;
+}
+
+
+/* ---------------- GetConvolutionEngine ------------------------------- */
+int Convolver::GetConvolutionEngine( )
+{
+  return convolutionEngine;
+}
+
+
+/* ---------------- GetConvolutionEngineName --------------------------- */
+string Convolver::GetConvolutionEngineName( )
+{
+  if (basisConvolvers.size() > 0)
+    return basisConvolvers[0]->GetConvolutionEngineName() + " (" 
+    		+ to_string(basisConvolvers.size()) + "-term PSF basis)";
+  switch (convolutionEngine) {
+    case CONVOLUTION_ENGINE_FFT:
+      return string("FFT");
+    case CONVOLUTION_ENGINE_DIRECT:
+      return string("direct");
+    case CONVOLUTION_ENGINE_SEPARABLE:
+      return string("separable");
+    case CONVOLUTION_ENGINE_TILED:
+      return string("tiled FFT");
+    default:
+      return string("auto");
+  }
+}
+
+
+/* ---------------- GetTileSize ---------------------------------------- */
+int Convolver::GetTileSize( )
+{
+  if (convolutionEngine != CONVOLUTION_ENGINE_TILED)
+    return 0;
+  return tileSize;
+}
+
+
 /* ---------------- SetupPSF ------------------------------------------- */
 /// Pass in a pointer to the pixel vector for the input PSF image, as well as
-/// the image dimensions and whether PSF needs to be normalized.
+/// the image dimensions and whether PSF needs to be normalized. (If requested,
+/// the PSF is normalized in place by DoFullSetup, which also makes a copy of it;
+/// the array only needs to remain valid until DoFullSetup has been called.)
 void Convolver::SetupPSF( double *psfPixels_input, int nColumns, int nRows,
 							bool normalize )
 {
@@ -185,6 +840,37 @@ void Convolver::SetupPSF( double *psfPixels_input, int nColumns, int nRows,
 }
 
 
+/* ---------------- SetupPSFBasis -------------------------------------- */
+/// Sets up convolution with a spatially varying PSF, represented as a sum of
+/// basis PSFs weighted by coefficients which vary with position:
+///    PSF(x,y) = sum_k c_k(x,y) PSF_k
+/// where c_k(x,y) is evaluated at the position of the pixel being convolved (the
+/// "source" pixel). The convolved image is then sum_k PSF_k * (c_k . image), 
+/// computed with one (sub-)Convolver per basis PSF; these share their FFTW plans.
+/// The basis PSFs (which, e.g. for principal-component PSFs, may have negative pixel 
+/// values) are *not* normalized. Each coefficient map must have the same size as the 
+/// image to be convolved (see SetupImage); all arrays must remain valid for the 
+/// lifetime of this object.
+void Convolver::SetupPSFBasis( vector<double *> basisPixels, int nColumns, int nRows,
+    							vector<double *> coefficientMaps )
+{
+  psfPixels = nullptr;
+  nColumns_psf = nColumns;
+  nRows_psf = nRows;
+  nPixels_psf = (long)nColumns_psf * (long)nRows_psf;
+  normalizePSF = false;
+  for (Convolver *basisConvolver : basisConvolvers)
+    delete basisConvolver;
+  basisConvolvers.clear();
+  for (size_t k = 0; k < basisPixels.size(); k++) {
+    basisConvolvers.push_back(new Convolver());
+    basisConvolvers[k]->SetupPSF(basisPixels[k], nColumns, nRows, false);
+  }
+  basisCoefficientMaps = coefficientMaps;
+  psfInfoSet = true;
+}
+
+
 /* ---------------- SetupImage ----------------------------------------- */
 /// Pass in the dimensions of the image we'll be convolving with the PSF.
 void Convolver::SetupImage( int nColumns, int nRows )
@@ -199,8 +885,9 @@ void Convolver::SetupImage( int nColumns, int nRows )
 
 /* ---------------- DoFullSetup ---------------------------------------- */
 /// General setup prior to actually supplying the image data and doing the
-/// convolution: determine padding dimensions; allocate FFTW arrays and plans;
-/// normalize, shift, and Fourier transform the PSF image.
+/// convolution: determine padding dimensions; normalize the PSF image and choose
+/// the convolution method; for FFT-based methods, allocate FFTW arrays and plans
+/// and shift and Fourier transform the PSF image.
 int Convolver::DoFullSetup( int debugLevel, bool doFFTWMeasure )
 {
   long  k;
@@ -214,10 +901,33 @@ int Convolver::DoFullSetup( int debugLevel, bool doFFTWMeasure )
     fprintf(stderr, "*** WARNING: Convolver::DoFullSetup: PSF and/or image parameters not set!\n");
     return -1;
   }
-  nColumns_padded = nColumns_image + nColumns_psf - 1;
-  nRows_padded = nRows_image + nRows_psf - 1;
+  if (basisConvolvers.size() > 0) {
+    if (doFFTWMeasure && (fftwPlanningMode == FFTW_PLANNING_ESTIMATE))
+      fftwPlanningMode = FFTW_PLANNING_MEASURE;
+    return SetupBasisConvolvers();
+  }
+  // Tiled convolution is pointless if a single tile would cover the image
+  if ((convolutionEngine == CONVOLUTION_ENGINE_TILED) && ((tileSize < 1) 
+  		|| ((tileSize >= nColumns_image) && (tileSize >= nRows_image))))
+    convolutionEngine = CONVOLUTION_ENGINE_FFT;
+  if (convolutionEngine == CONVOLUTION_ENGINE_TILED) {
+    nColumns_tile = std::min(tileSize, nColumns_image);
+    nRows_tile = std::min(tileSize, nRows_image);
+    if (useFloatFFT) {
+      fprintf(stderr, "*** WARNING: Convolver::DoFullSetup: single-precision FFTs are not ");
+      fprintf(stderr, "available for tiled convolution; using double precision.\n");
+      useFloatFFT = false;
+    }
+    // (minimum padded size is nColumns_tile + nColumns_psf - 1, etc.)
+    GetFFTFriendlyPaddedSize(nColumns_tile + nColumns_psf - 1, nRows_tile + nRows_psf - 1,
+  							nColumns_padded, nRows_padded);
+  } else {
+    // (minimum padded size is nColumns_image + nColumns_psf - 1, etc.; we round up
+    // to sizes which FFTW can transform efficiently)
+    GetFFTFriendlyPaddedSize(nColumns_image + nColumns_psf - 1, nRows_image + nRows_psf - 1,
+  							nColumns_padded, nRows_padded);
+  }
   nPixels_padded = (long)nColumns_padded * (long)nRows_padded;
-  rescaleFactor = 1.0 / nPixels_padded;
   if (debugStatus >= 1)
     printf("Images will be padded to %d x %d pixels in size\n", nColumns_padded, nRows_padded);
   // compute size of complex arrays, which are smaller due to use of r2c/c2r FFTW functions
@@ -228,39 +938,100 @@ int Convolver::DoFullSetup( int debugLevel, bool doFFTWMeasure )
     		nRows_padded);
 
 
+  // Normalize the PSF
+  if ((debugStatus >= 1) && (normalizePSF)) {
+    printf("Normalizing the PSF ...\n");
+    if (debugStatus >= 2) {
+      printf("The whole input PSF image, row by row:\n");
+      PrintRealImage(psfPixels, nColumns_psf, nRows_psf);
+    }
+  }
+  // Use Kahan summation to avoid underflow
+  if (normalizePSF) {
+    psfSum = 0.0;
+    double  storedError = 0.0, adjustedVal = 0.0, tempSum = 0.0;
+    for (k = 0; k < nPixels_psf; k++) {
+      adjustedVal = psfPixels[k] - storedError;
+      tempSum = psfSum + adjustedVal;
+      storedError = (tempSum - psfSum) - adjustedVal;
+      psfSum = tempSum;
+    }
+    for (k = 0; k < nPixels_psf; k++)
+      psfPixels[k] = psfPixels[k] / psfSum;
+    if (debugStatus >= 2) {
+      printf("The whole *normalized* PSF image, row by row:\n");
+      PrintRealImage(psfPixels, nColumns_psf, nRows_psf);
+    }
+  }
+  // Keep our own copy of the (normalized) PSF, so the caller's PSF array need not
+  // outlive setup
+  normalizedPSF.assign(psfPixels, psfPixels + nPixels_psf);
+
+  // Decide which convolution method to use (this only depends on the image and
+  // PSF sizes); spatial-domain methods don't need any of the FFT setup
+  if (convolutionEngine == CONVOLUTION_ENGINE_AUTO)
+    convolutionEngine = ChooseConvolutionEngine();
+  if (convolutionEngine == CONVOLUTION_ENGINE_SEPARABLE) {
+    if (SetupSeparableKernels() < 0) {
+      fprintf(stderr, "*** WARNING: Convolver::DoFullSetup: unable to decompose PSF; ");
+      fprintf(stderr, "using FFT convolution instead.\n");
+      convolutionEngine = CONVOLUTION_ENGINE_FFT;
+    }
+  }
+  if ((convolutionEngine == CONVOLUTION_ENGINE_DIRECT) 
+  		|| (convolutionEngine == CONVOLUTION_ENGINE_SEPARABLE)) {
+    FreeFFTVectors();
+    if (AllocateSpatialVectors() < 0)
+      return -2;
+    if (debugStatus >= 1)
+      printf("Using %s convolution\n", GetConvolutionEngineName().c_str());
+    return 0;
+  }
+  FreeSpatialVectors();
+
+
 #ifdef FFTW_THREADING
   int  threadStatus;
-  threadStatus = fftw_init_threads();
+  if (useFloatFFT)
+    threadStatus = fftwf_init_threads();
+  else
+    threadStatus = fftw_init_threads();
 #endif  // FFTW_THREADING
 
-  // allocate memory for double and fftw_complex arrays
-  image_in_padded = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
-  image_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex);
-  psf_in_padded = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
-  psf_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex);
-  multiplied_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex);
-  convolvedImage_out = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
-  if ( (image_in_padded == nullptr) || (image_fft_cmplx == nullptr) || (psf_in_padded == nullptr)
-  		|| (psf_fft_cmplx == nullptr) || (multiplied_cmplx == nullptr) 
-  		|| (convolvedImage_out == nullptr) ) {
-    fprintf(stderr, "*** WARNING: Convolver::DoFullSetup: memory allocation failure!\n");
-	return -2;
+  // allocate memory for the arrays used in each convolution (the PSF transform
+  // is handled by AcquireSharedResources)
+  if (useFloatFFT) {
+    image_in_padded_f = (float*) fftwf_malloc(sizeof(float) * nPixels_padded);
+    image_fft_cmplx_f = (fftwf_complex*) fftwf_malloc(sizeof(fftwf_complex) * nPixels_padded_complex);
+    convolvedImage_out_f = (float*) fftwf_malloc(sizeof(float) * nPixels_padded);
+    if ( (image_in_padded_f == nullptr) || (image_fft_cmplx_f == nullptr) 
+    		|| (convolvedImage_out_f == nullptr) ) {
+      fprintf(stderr, "*** WARNING: Convolver::DoFullSetup: memory allocation failure!\n");
+      return -2;
+    }
+  }
+  else {
+    image_in_padded = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
+    image_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex);
+    convolvedImage_out = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
+    if ( (image_in_padded == nullptr) || (image_fft_cmplx == nullptr) 
+    		|| (convolvedImage_out == nullptr) ) {
+      fprintf(stderr, "*** WARNING: Convolver::DoFullSetup: memory allocation failure!\n");
+      return -2;
+    }
   }
   fftVectorsAllocated = true;
 
 
-  // set up FFTW plans
-  if (doFFTWMeasure)
-    fftwFlags = FFTW_MEASURE;
-  else
-    fftwFlags = FFTW_ESTIMATE;
-  // Note that there's not much purpose in multi-threading plan_psf, since we only do
-  // the FFT of the PSF once
-  plan_psf = fftw_plan_dft_r2c_2d(nRows_padded, nColumns_padded, psf_in_padded, 
-  									psf_fft_cmplx, fftwFlags);
-
+  // FFTW planning options (doFFTWMeasure is the older way of requesting FFTW_MEASURE)
+  if (doFFTWMeasure && (fftwPlanningMode == FFTW_PLANNING_ESTIMATE))
+    fftwPlanningMode = FFTW_PLANNING_MEASURE;
+  fftwFlags = GetFFTWPlannerFlags(fftwPlanningMode);
+  if (fftwPlanningMode != FFTW_PLANNING_ESTIMATE)
+    UseFFTWWisdomFile(useFloatFFT);
+  int  nThreads = 1;
 #ifdef FFTW_THREADING
-  int  nThreads, nCores;
+  int  nCores;
 //   nCores = sysconf(_SC_NPROCESSORS_ONLN);
   nCores = GetPhysicalCoreCount();
 //   printf("Convolver::DoFullSetup: nCores = %d\n", nCores);
@@ -271,89 +1042,268 @@ int Convolver::DoFullSetup( int debugLevel, bool doFFTWMeasure )
     nThreads = maxRequestedThreads;
   if (nThreads < 1)
     nThreads = 1;
-//   printf("Convolver::DoFullSetup: calling fftw_plan_with_nthreads with nThreads = %d\n", nThreads);
-  fftw_plan_with_nthreads(nThreads);
 #endif  // FFTW_THREADING
+  // For tiled convolution, the tiles are processed in parallel (via OpenMP),
+  // each with single-threaded FFTs
+  if (convolutionEngine == CONVOLUTION_ENGINE_TILED) {
+    nThreads = 1;
+    nTileThreads = 1;
+#ifdef USE_OPENMP
+    long  nTiles = (long)((nColumns_image + nColumns_tile - 1) / nColumns_tile)
+    				* ((nRows_image + nRows_tile - 1) / nRows_tile);
+    nTileThreads = omp_get_max_threads();
+    if ((maxRequestedThreads > 0) && (maxRequestedThreads < nTileThreads))
+      nTileThreads = maxRequestedThreads;
+    if (nTiles < nTileThreads)
+      nTileThreads = (int)nTiles;
+#endif
+  }
 
-  plan_inputImage = fftw_plan_dft_r2c_2d(nRows_padded, nColumns_padded, image_in_padded, 
-  										image_fft_cmplx, fftwFlags);
 
-  plan_inverse = fftw_plan_dft_c2r_2d(nRows_padded, nColumns_padded, multiplied_cmplx, 
-  									convolvedImage_out, fftwFlags);
-  fftPlansCreated = true;
+  // Set up FFTW plans, shift and wrap the PSF into a padded array, and do
+  // the forward FFT on it -- or re-use the plans and PSF transform of an
+  // existing Convolver with the same padded size, PSF, and FFT settings
+  if (AcquireSharedResources(fftwFlags, nThreads) < 0)
+    return -2;
+  // Zero the padded input array (FFTW_MEASURE, etc. planning may have written to
+  // it); since the forward FFT preserves its input and only the image region is
+  // ever written to, the padding stays zero from now on
+  if (useFloatFFT) {
+    for (k = 0; k < nPixels_padded; k++)
+      image_in_padded_f[k] = 0.0f;
+  } else {
+    for (k = 0; k < nPixels_padded; k++)
+      image_in_padded[k] = 0.0;
+  }
+  
+  if (convolutionEngine == CONVOLUTION_ENGINE_TILED) {
+    if (AllocateTileVectors() < 0)
+      return -2;
+    if (debugStatus >= 1)
+      printf("Using %d x %d-pixel tiles, with %d thread(s)\n", nColumns_tile, nRows_tile,
+      		nTileThreads);
+  }
+  if (debugStatus >= 1)
+    printf("Using %s convolution\n", GetConvolutionEngineName().c_str());
+  
+  return 0;
+}
 
 
-  // Generate the Fourier transform of the PSF:
-  // 1. Normalize the PSF
-  if ((debugStatus >= 1) && (normalizePSF)) {
-    printf("Normalizing the PSF ...\n");
-    if (debugStatus >= 2) {
-      printf("The whole input PSF image, row by row:\n");
-      PrintRealImage(psfPixels, nColumns_psf, nRows_psf);
-    }
+/* ---------------- SetupBasisConvolvers ------------------------------- */
+/// Does the setup for spatially varying PSF convolution (called by DoFullSetup): 
+/// sets up the Convolver for each basis PSF, using our settings, and allocates 
+/// the image-sized arrays for the weighted input image and the summed output.
+int Convolver::SetupBasisConvolvers( )
+{
+  if (basisCoefficientMaps.size() != basisConvolvers.size()) {
+    fprintf(stderr, "*** WARNING: Convolver::DoFullSetup: number of PSF-basis coefficient maps ");
+    fprintf(stderr, "(%d) != number of basis PSFs (%d)!\n", (int)basisCoefficientMaps.size(),
+    		(int)basisConvolvers.size());
+    return -1;
   }
-  // Use Kahan summation to avoid underflow
-  if (normalizePSF) {
-    psfSum = 0.0;
-    double  storedError = 0.0, adjustedVal = 0.0, tempSum = 0.0;
-    for (k = 0; k < nPixels_psf; k++) {
-      adjustedVal = psfPixels[k] - storedError;
-      tempSum = psfSum + adjustedVal;
-      storedError = (tempSum - psfSum) - adjustedVal;
-      psfSum = tempSum;
-    }
-    for (k = 0; k < nPixels_psf; k++)
-      psfPixels[k] = psfPixels[k] / psfSum;
-    if (debugStatus >= 2) {
-      printf("The whole *normalized* PSF image, row by row:\n");
-      PrintRealImage(psfPixels, nColumns_psf, nRows_psf);
+  for (Convolver *basisConvolver : basisConvolvers) {
+    basisConvolver->SetMaxThreads(maxRequestedThreads);
+    basisConvolver->SetFFTWPlanning(fftwPlanningMode);
+    basisConvolver->SetConvolutionEngine(convolutionEngine);
+    basisConvolver->SetTileSize(tileSize);
+    basisConvolver->UseFloatConvolution(useFloatFFT);
+    basisConvolver->SetupImage(nColumns_image, nRows_image);
+    if (basisConvolver->DoFullSetup(debugStatus) < 0)
+      return -2;
+  }
+  convolutionEngine = basisConvolvers[0]->GetConvolutionEngine();
+  
+  if (! basisVectorsAllocated) {
+    basisInput = (double *)calloc((size_t)nPixels_image, sizeof(double));
+    basisSum = (double *)calloc((size_t)nPixels_image, sizeof(double));
+    if ((basisInput == nullptr) || (basisSum == nullptr)) {
+      fprintf(stderr, "*** WARNING: Convolver::SetupBasisConvolvers: memory allocation failure!\n");
+      free(basisInput);
+      free(basisSum);
+      return -2;
     }
+    basisVectorsAllocated = true;
   }
-
-  // 2. Prepare padded psf array for FFT, and then copy input PSF into
-  // it with appropriate shift/wrap:
-  for (k = 0; k < nPixels_padded; k++)
-    psf_in_padded[k] = 0.0;
   if (debugStatus >= 1)
-    printf("Shifting and wrapping the PSF ...\n");
-  ShiftAndWrapPSF();
-  if (debugStatus >= 2) {
-    printf("The whole padded, normalized PSF image, row by row:\n");
-    PrintRealImage(psf_in_padded, nColumns_padded, nRows_padded);
+    printf("Using %s convolution\n", GetConvolutionEngineName().c_str());
+  return 0;
+}
+
+
+/* ---------------- SetupSeparableKernels ------------------------------ */
+/// Decomposes the (normalized) PSF via singular-value decomposition into a sum
+/// of separable terms, PSF = sum_r s_r u_r v_r^T, keeping only as many terms as
+/// needed to reproduce the PSF to within SEPARABLE_PSF_TOLERANCE; the column
+/// kernels (applied along columns, length nRows_psf) are s_r*u_r and the row
+/// kernels (applied along rows, length nColumns_psf) are v_r.
+/// Returns -1 if the decomposition fails.
+int Convolver::SetupSeparableKernels( )
+{
+  gsl_matrix  *A, *V;
+  gsl_vector  *S;
+  int  status, M, N, i, j, r;
+  bool  transposed;
+  double  totalPower, residualPower, s_r;
+  
+  if (separableKernelsAllocated)
+    return 0;
+  
+  // gsl_linalg_SV_decomp_jacobi requires M >= N, so we decompose the transposed
+  // PSF if it's wider than it is tall
+  transposed = (nRows_psf < nColumns_psf);
+  M = transposed ? nColumns_psf : nRows_psf;
+  N = transposed ? nRows_psf : nColumns_psf;
+  A = gsl_matrix_alloc(M, N);
+  V = gsl_matrix_alloc(N, N);
+  S = gsl_vector_alloc(N);
+  for (i = 0; i < nRows_psf; i++) {
+    for (j = 0; j < nColumns_psf; j++) {
+      if (transposed)
+        gsl_matrix_set(A, j, i, normalizedPSF[(long)i*nColumns_psf + j]);
+      else
+        gsl_matrix_set(A, i, j, normalizedPSF[(long)i*nColumns_psf + j]);
+    }
+  }
+  status = gsl_linalg_SV_decomp_jacobi(A, V, S);
+  if (status != GSL_SUCCESS) {
+    gsl_matrix_free(A);
+    gsl_matrix_free(V);
+    gsl_vector_free(S);
+    return -1;
   }
   
-  // 3. Do forward FFT on PSF image
+  // find number of terms needed (singular values are in decreasing order)
+  totalPower = 0.0;
+  for (r = 0; r < N; r++)
+    totalPower += gsl_vector_get(S, r)*gsl_vector_get(S, r);
+  separableRank = 0;
+  residualPower = totalPower;
+  while ((separableRank < N) && 
+  		(residualPower > SEPARABLE_PSF_TOLERANCE*SEPARABLE_PSF_TOLERANCE*totalPower)) {
+    residualPower = 0.0;
+    separableRank++;
+    for (r = separableRank; r < N; r++)
+      residualPower += gsl_vector_get(S, r)*gsl_vector_get(S, r);
+  }
+  if (separableRank < 1)
+    separableRank = 1;
+
+  separableColumnKernels = (double *)calloc((size_t)(separableRank*nRows_psf), sizeof(double));
+  separableRowKernels = (double *)calloc((size_t)(separableRank*nColumns_psf), sizeof(double));
+  for (r = 0; r < separableRank; r++) {
+    s_r = gsl_vector_get(S, r);
+    for (i = 0; i < nRows_psf; i++)
+      separableColumnKernels[r*nRows_psf + i] = s_r * (transposed ? gsl_matrix_get(V, i, r) 
+      															: gsl_matrix_get(A, i, r));
+    for (j = 0; j < nColumns_psf; j++)
+      separableRowKernels[r*nColumns_psf + j] = transposed ? gsl_matrix_get(A, j, r) 
+      														: gsl_matrix_get(V, j, r);
+  }
+  separableKernelsAllocated = true;
   if (debugStatus >= 1)
-    printf("Performing FFT of PSF image ...\n");
-  fftw_execute(plan_psf);
-  
+    printf("Separable approximation of PSF uses %d terms\n", separableRank);
+
+  gsl_matrix_free(A);
+  gsl_matrix_free(V);
+  gsl_vector_free(S);
   return 0;
 }
 
 
+/* ---------------- ChooseConvolutionEngine ---------------------------- */
+/// Chooses between the two exact convolution methods (FFT and direct) for this
+/// image and PSF, based on rough operation counts for a single convolution, so
+/// that the same method is always chosen for the same image and PSF sizes.
+int Convolver::ChooseConvolutionEngine( )
+{
+  double  fftCost, directCost;
+  
+  // forward + inverse real FFTs of the padded image, vs. one multiply-add per
+  // PSF pixel per image pixel
+  fftCost = 5.0 * nPixels_padded * log2((double)nPixels_padded);
+  directCost = 2.0 * nPixels_image * nPixels_psf;
+  if (debugStatus >= 1)
+    printf("Convolver: estimated operation counts: FFT = %g, direct = %g\n", fftCost,
+    		directCost);
+  if (directCost < fftCost)
+    return CONVOLUTION_ENGINE_DIRECT;
+  return CONVOLUTION_ENGINE_FFT;
+}
+
+
 /* ---------------- ConvolveImage -------------------------------------- */
-/// Given an input image (pointer to its pixel vector), convolve it with the PSF
-/// by: 1) Copying image to image_in_padded array (with zero-padding); 
-/// 2) Taking FFT of image; 3) Multiplying transform of image by transform of PSF; 
-/// 4) Taking inverse FFT of product; 5) Copying (and rescaling) result back into 
-///    input image.
+/// Given an input image (pointer to its pixel vector), convolve it with the PSF,
+/// using whichever method was selected in DoFullSetup(), and replace the input 
+/// image with the result. In all cases, pixels outside the image are treated as 
+/// having values = 0.
 void Convolver::ConvolveImage( double *pixelVector )
+{
+  if (basisConvolvers.size() > 0)
+    ConvolveImage_basis(pixelVector);
+  else if (convolutionEngine == CONVOLUTION_ENGINE_DIRECT)
+    ConvolveImage_direct(pixelVector);
+  else if (convolutionEngine == CONVOLUTION_ENGINE_SEPARABLE)
+    ConvolveImage_separable(pixelVector);
+  else if (convolutionEngine == CONVOLUTION_ENGINE_TILED)
+    ConvolveImage_tiled(pixelVector);
+  else
+    ConvolveImage_FFT(pixelVector);
+}
+
+
+/* ---------------- GetPaddedInputImage -------------------------------- */
+/// Returns a pointer to the (zero-padded) input array for FFT convolution, so that
+/// the caller can write the image to be convolved directly into it and then call
+/// ConvolvePaddedImage(), avoiding the copy done by ConvolveImage(). Row ii of the
+/// image starts at element ii*rowStride; only pixels within the image (the first 
+/// nColumns_image values of the first nRows_image rows) may be written to.
+/// Returns nullptr if we're not doing double-precision FFT convolution.
+double * Convolver::GetPaddedInputImage( long& rowStride )
+{
+  rowStride = nColumns_padded;
+  if ((convolutionEngine != CONVOLUTION_ENGINE_FFT) || (useFloatFFT) 
+  		|| (! fftVectorsAllocated))
+    return nullptr;
+  return image_in_padded;
+}
+
+
+/* ---------------- ConvolveImage_FFT ---------------------------------- */
+/// FFT-based convolution: copies image into the image_in_padded array (whose
+/// padding is already zero), then does the convolution via ConvolvePaddedImage().
+void Convolver::ConvolveImage_FFT( double *pixelVector )
 {
   int  ii, jj;
-  long  z;
-  double  a, b, c, d, rawValue;
   
-  // Populate padded input image array for FFT
-  //   First, zero the array to ensure zero-padding *is* zero
-  for (z = 0; z < nPixels_padded; z++)
-    image_in_padded[z] = 0.0;
-  //   Second, copy input image array into padded array (accounting for padding):
-  //   [note that inner loop will be auto-vectorized by GCC with -msse2]
+  if (useFloatFFT) {
+    ConvolveImage_FFT_float(pixelVector);
+    return;
+  }
+  
+  // Copy input image array into padded array (accounting for padding):
+  // [note that inner loop will be auto-vectorized by GCC with -msse2]
   for (ii = 0; ii < nRows_image; ii++) {   // step by row number = y
     for (jj = 0; jj < nColumns_image; jj++) {  // step by column number = x
       image_in_padded[(long)ii*nColumns_padded + jj] = pixelVector[(long)ii*nColumns_image + jj];
     }
   }
+  ConvolvePaddedImage(pixelVector);
+}
+
+
+/* ---------------- ConvolvePaddedImage -------------------------------- */
+/// Convolves the image currently in the image_in_padded array (see 
+/// GetPaddedInputImage) with the PSF: 1) Taking FFT of image; 2) Multiplying 
+/// transform of image (in place) by transform of PSF, which includes the 1/N
+/// rescaling; 3) Taking inverse FFT of product; 4) Copying result into outputVector
+/// (nColumns_image x nRows_image, no padding).
+void Convolver::ConvolvePaddedImage( double *outputVector )
+{
+  int  ii, jj;
+  long  z;
+  double  a, b, c, d;
+  
   if (debugStatus >= 3) {
     printf("The whole (padded) input mage [image_in_padded], row by row:\n");
     PrintRealImage(image_in_padded, nColumns_padded, nRows_padded);
@@ -362,55 +1312,286 @@ void Convolver::ConvolveImage( double *pixelVector )
   // Do FFT of input image:
   if (debugStatus >= 2)
     printf("Performing FFT of input image ...\n");
-  fftw_execute(plan_inputImage);
+  fftw_execute_dft_r2c(sharedResources->plans->plan_inputImage, image_in_padded, image_fft_cmplx);
   if (debugStatus >= 3) {
     printf("The (modulus of the) transform of the input image [image_fft_cmplx], row by row:\n");
     PrintComplexImage_Absolute(image_fft_cmplx, nColumns_padded, nRows_padded);
   }
   
-  // Multiply transformed arrays:
+  // Multiply transformed arrays (in place):
   for (z = 0; z < nPixels_padded_complex; z++) {
     a = image_fft_cmplx[z][0];   // real part
     b = image_fft_cmplx[z][1];   // imaginary part
-    c = psf_fft_cmplx[z][0];
-    d = psf_fft_cmplx[z][1];
-    multiplied_cmplx[z][0] = a*c - b*d;
-    multiplied_cmplx[z][1] = b*c + a*d;
-  }
-  // Alternate approach using OpenMP SIMD directives; no real speedup
-//   #pragma omp simd
-//   for (z = 0; z < nPixels_padded_complex; z++) {
-//     multiplied_cmplx[z][0] = image_fft_cmplx[z][0]*psf_fft_cmplx[z][0] - image_fft_cmplx[z][1]*psf_fft_cmplx[z][1];
-//     multiplied_cmplx[z][1] = image_fft_cmplx[z][1]*psf_fft_cmplx[z][0] + image_fft_cmplx[z][0]*psf_fft_cmplx[z][1];
-//   }
+    c = sharedResources->psf_fft_cmplx[z][0];
+    d = sharedResources->psf_fft_cmplx[z][1];
+    image_fft_cmplx[z][0] = a*c - b*d;
+    image_fft_cmplx[z][1] = b*c + a*d;
+  }
 
   if (debugStatus >= 3) {
-    printf("The (modulus of the) product [multiplied_cmplx], row by row:\n");
-    PrintComplexImage_Absolute(multiplied_cmplx, nColumns_padded, nRows_padded);
+    printf("The (modulus of the) product [image_fft_cmplx], row by row:\n");
+    PrintComplexImage_Absolute(image_fft_cmplx, nColumns_padded, nRows_padded);
   }
 
-  // Do the inverse FFT on the product array:
+  // Do the inverse FFT on the product array (this overwrites the product array):
   if (debugStatus >= 2)
     printf("Performing inverse FFT of multiplied image ...\n");
-  fftw_execute(plan_inverse);
+  fftw_execute_dft_c2r(sharedResources->plans->plan_inverse, image_fft_cmplx, convolvedImage_out);
 
   if (debugStatus >= 3) {
-    printf("The whole (padded) convolved image [convolvedImage_out, rescaled], row by row:\n");
-    for (int i = 0; i < nRows_padded; i++) {   // step by row number = y
-      for (int j = 0; j < nColumns_padded; j++)   // step by column number = x
-        printf(" %9f", fabs(convolvedImage_out[(long)i*nColumns_padded + j] / nPixels_padded));
-      printf("\n");
+    printf("The whole (padded) convolved image [convolvedImage_out], row by row:\n");
+    PrintRealImage(convolvedImage_out, nColumns_padded, nRows_padded);
+  }
+
+  // Extract the convolved image and copy into output pixel vector:
+  for (ii = 0; ii < nRows_image; ii++) {   // step by row number = y
+    for (jj = 0; jj < nColumns_image; jj++) {  // step by column number = x
+      outputVector[(long)ii*nColumns_image + jj] = convolvedImage_out[(long)ii*nColumns_padded + jj];
     }
-    printf("\n");
+  }
+}
+
+
+/* ---------------- ConvolveImage_FFT_float ---------------------------- */
+/// Single-precision version of ConvolveImage_FFT: the input image is converted to
+/// float on the way into the padded array, and the result is converted back to
+/// double on the way out.
+void Convolver::ConvolveImage_FFT_float( double *pixelVector )
+{
+  int  ii, jj;
+  long  z;
+  float  a, b, c, d;
+  
+  // Populate padded input image array for FFT (padding is already zero)
+  for (ii = 0; ii < nRows_image; ii++) {   // step by row number = y
+    for (jj = 0; jj < nColumns_image; jj++) {  // step by column number = x
+      image_in_padded_f[(long)ii*nColumns_padded + jj] = (float)pixelVector[(long)ii*nColumns_image + jj];
+    }
+  }
+
+  // Do FFT of input image:
+  if (debugStatus >= 2)
+    printf("Performing (single-precision) FFT of input image ...\n");
+  fftwf_execute_dft_r2c(sharedResources->plans->plan_inputImage_f, image_in_padded_f, image_fft_cmplx_f);
+  
+  // Multiply transformed arrays (in place):
+  for (z = 0; z < nPixels_padded_complex; z++) {
+    a = image_fft_cmplx_f[z][0];   // real part
+    b = image_fft_cmplx_f[z][1];   // imaginary part
+    c = sharedResources->psf_fft_cmplx_f[z][0];
+    d = sharedResources->psf_fft_cmplx_f[z][1];
+    image_fft_cmplx_f[z][0] = a*c - b*d;
+    image_fft_cmplx_f[z][1] = b*c + a*d;
   }
 
-  // Extract & rescale the convolved image and copy into input pixel vector:
+  // Do the inverse FFT on the product array:
+  if (debugStatus >= 2)
+    printf("Performing (single-precision) inverse FFT of multiplied image ...\n");
+  fftwf_execute_dft_c2r(sharedResources->plans->plan_inverse_f, image_fft_cmplx_f, convolvedImage_out_f);
+
+  // Extract the convolved image and copy into input pixel vector:
   for (ii = 0; ii < nRows_image; ii++) {   // step by row number = y
     for (jj = 0; jj < nColumns_image; jj++) {  // step by column number = x
-      rawValue = convolvedImage_out[(long)ii*nColumns_padded + jj];
-      pixelVector[(long)ii*nColumns_image + jj] = rescaleFactor * rawValue;
+      pixelVector[(long)ii*nColumns_image + jj] = 
+      								(double)convolvedImage_out_f[(long)ii*nColumns_padded + jj];
+    }
+  }
+}
+
+
+
+/* ---------------- ConvolveImage_direct ------------------------------- */
+/// Direct (spatial-domain) convolution: each PSF pixel contributes a shifted, scaled
+/// copy of the input image, accumulated row by row (rows are computed in parallel
+/// via OpenMP; the inner loop over columns is vectorized). The PSF center is
+/// at (nColumns_psf/2, nRows_psf/2), as in ShiftAndWrapPSF.
+void Convolver::ConvolveImage_direct( double *pixelVector )
+{
+  int  centerX_psf = nColumns_psf / 2;
+  int  centerY_psf = nRows_psf / 2;
+
+  #pragma omp parallel for schedule (static)
+  for (int i = 0; i < nRows_image; i++) {   // step by row number = y
+    double  *outputRow = spatialOutput + (long)i*nColumns_image;
+    for (int j = 0; j < nColumns_image; j++)
+      outputRow[j] = 0.0;
+    for (int k = 0; k < nRows_psf; k++) {
+      int  inputRowNumber = i + centerY_psf - k;
+      if ((inputRowNumber < 0) || (inputRowNumber >= nRows_image))
+        continue;
+      double  *inputRow = pixelVector + (long)inputRowNumber*nColumns_image;
+      for (int l = 0; l < nColumns_psf; l++) {
+        double  psfValue = normalizedPSF[(long)k*nColumns_psf + l];
+        int  offset = centerX_psf - l;
+        int  jStart = (offset < 0) ? -offset : 0;
+        int  jEnd = (offset > 0) ? nColumns_image - offset : nColumns_image;
+        #pragma omp simd
+        for (int j = jStart; j < jEnd; j++)
+          outputRow[j] += psfValue*inputRow[j + offset];
+      }
+    }
+  }
+  memcpy(pixelVector, spatialOutput, (size_t)nPixels_image*sizeof(double));
+}
+
+
+/* ---------------- ConvolveImage_separable ---------------------------- */
+/// Separable (spatial-domain) convolution: for each term in the separable
+/// decomposition of the PSF, convolve the rows of the image with the row kernel,
+/// then convolve the columns of the result with the column kernel (done row by
+/// row, so that the inner loops are over contiguous, vectorizable pixels), and
+/// add the result to the output image.
+void Convolver::ConvolveImage_separable( double *pixelVector )
+{
+  int  centerX_psf = nColumns_psf / 2;
+  int  centerY_psf = nRows_psf / 2;
+
+  for (long z = 0; z < nPixels_image; z++)
+    spatialOutput[z] = 0.0;
+  for (int r = 0; r < separableRank; r++) {
+    double  *rowKernel = separableRowKernels + (long)r*nColumns_psf;
+    double  *columnKernel = separableColumnKernels + (long)r*nRows_psf;
+    
+    // 1. Convolve rows
+    #pragma omp parallel for schedule (static)
+    for (int i = 0; i < nRows_image; i++) {
+      double  *inputRow = pixelVector + (long)i*nColumns_image;
+      double  *tempRow = spatialTemp + (long)i*nColumns_image;
+      for (int j = 0; j < nColumns_image; j++)
+        tempRow[j] = 0.0;
+      for (int l = 0; l < nColumns_psf; l++) {
+        double  kernelValue = rowKernel[l];
+        int  offset = centerX_psf - l;
+        int  jStart = (offset < 0) ? -offset : 0;
+        int  jEnd = (offset > 0) ? nColumns_image - offset : nColumns_image;
+        #pragma omp simd
+        for (int j = jStart; j < jEnd; j++)
+          tempRow[j] += kernelValue*inputRow[j + offset];
+      }
+    }
+    
+    // 2. Convolve columns of row-convolved image and add to output
+    #pragma omp parallel for schedule (static)
+    for (int i = 0; i < nRows_image; i++) {
+      double  *outputRow = spatialOutput + (long)i*nColumns_image;
+      for (int k = 0; k < nRows_psf; k++) {
+        int  tempRowNumber = i + centerY_psf - k;
+        if ((tempRowNumber < 0) || (tempRowNumber >= nRows_image))
+          continue;
+        double  kernelValue = columnKernel[k];
+        double  *tempRow = spatialTemp + (long)tempRowNumber*nColumns_image;
+        #pragma omp simd
+        for (int j = 0; j < nColumns_image; j++)
+          outputRow[j] += kernelValue*tempRow[j];
+      }
+    }
+  }
+  memcpy(pixelVector, spatialOutput, (size_t)nPixels_image*sizeof(double));
+}
+
+
+/* ---------------- ConvolveImage_tiled -------------------------------- */
+/// Tiled FFT convolution, using the overlap-save method: the image is divided
+/// into tiles of nColumns_tile x nRows_tile pixels; for each tile, the tile plus
+/// the surrounding margin of input pixels which contribute to it (pixels outside
+/// the image = 0) is copied into a padded array, convolved via FFT, and the
+/// (wraparound-free) pixels corresponding to the tile are copied to tiledOutput.
+/// Tiles are processed in parallel, with each thread using its own arrays and the
+/// shared single-threaded FFTW plans (fftw_execute_dft_r2c, etc. are thread-safe).
+void Convolver::ConvolveImage_tiled( double *pixelVector )
+{
+  int  nTilesX = (nColumns_image + nColumns_tile - 1) / nColumns_tile;
+  int  nTilesY = (nRows_image + nRows_tile - 1) / nRows_tile;
+  int  nTiles = nTilesX*nTilesY;
+  // offset of tile within padded array = size of margin on low-x, low-y sides
+  int  offsetX = nColumns_psf - 1 - nColumns_psf/2;
+  int  offsetY = nRows_psf - 1 - nRows_psf/2;
+  int  nColumns_block = nColumns_tile + nColumns_psf - 1;
+  int  nRows_block = nRows_tile + nRows_psf - 1;
+
+  #pragma omp parallel for schedule (dynamic) num_threads (nTileThreads)
+  for (int n = 0; n < nTiles; n++) {
+    int  threadNumber = 0;
+#ifdef USE_OPENMP
+    threadNumber = omp_get_thread_num();
+#endif
+    double  *inputArray = tileInputArrays[threadNumber];
+    fftw_complex  *fftArray = tileFFTArrays[threadNumber];
+    double  *outputArray = tileOutputArrays[threadNumber];
+    int  i0 = (n / nTilesX)*nRows_tile;
+    int  j0 = (n % nTilesX)*nColumns_tile;
+    int  i1 = std::min(i0 + nRows_tile, nRows_image);
+    int  j1 = std::min(j0 + nColumns_tile, nColumns_image);
+    
+    // copy tile + margins into padded array
+    for (int bi = 0; bi < nRows_block; bi++) {
+      int  ii = i0 - offsetY + bi;
+      double  *blockRow = inputArray + (long)bi*nColumns_padded;
+      if ((ii < 0) || (ii >= nRows_image)) {
+        for (int bj = 0; bj < nColumns_block; bj++)
+          blockRow[bj] = 0.0;
+        continue;
+      }
+      double  *imageRow = pixelVector + (long)ii*nColumns_image;
+      for (int bj = 0; bj < nColumns_block; bj++) {
+        int  jj = j0 - offsetX + bj;
+        blockRow[bj] = ((jj >= 0) && (jj < nColumns_image)) ? imageRow[jj] : 0.0;
+      }
+    }
+    
+    fftw_execute_dft_r2c(sharedResources->plans->plan_inputImage, inputArray, fftArray);
+    for (long z = 0; z < nPixels_padded_complex; z++) {
+      double  a = fftArray[z][0];
+      double  b = fftArray[z][1];
+      double  c = sharedResources->psf_fft_cmplx[z][0];
+      double  d = sharedResources->psf_fft_cmplx[z][1];
+      fftArray[z][0] = a*c - b*d;
+      fftArray[z][1] = b*c + a*d;
+    }
+    fftw_execute_dft_c2r(sharedResources->plans->plan_inverse, fftArray, outputArray);
+    
+    for (int ii = i0; ii < i1; ii++) {
+      double  *blockRow = outputArray + (long)(offsetY + ii - i0)*nColumns_padded + offsetX - j0;
+      double  *outputRow = tiledOutput + (long)ii*nColumns_image;
+      for (int jj = j0; jj < j1; jj++)
+        outputRow[jj] = blockRow[jj];
+    }
+  }
+  memcpy(pixelVector, tiledOutput, (size_t)nPixels_image*sizeof(double));
+}
+
+
+/* ---------------- ConvolveImage_basis -------------------------------- */
+/// Spatially varying PSF convolution: for each basis PSF, the input image is 
+/// multiplied by the corresponding coefficient map and convolved with that PSF 
+/// (writing the weighted image directly into the sub-Convolver's padded FFT input 
+/// array if possible), and the results are summed.
+void Convolver::ConvolveImage_basis( double *pixelVector )
+{
+  long  rowStride;
+  
+  for (long z = 0; z < nPixels_image; z++)
+    basisSum[z] = 0.0;
+  for (size_t k = 0; k < basisConvolvers.size(); k++) {
+    double  *coeffs = basisCoefficientMaps[k];
+    double  *paddedInput = basisConvolvers[k]->GetPaddedInputImage(rowStride);
+    if (paddedInput != nullptr) {
+      for (int ii = 0; ii < nRows_image; ii++) {
+        long  offset = (long)ii*nColumns_image;
+        double  *paddedRow = paddedInput + (long)ii*rowStride;
+        for (int jj = 0; jj < nColumns_image; jj++)
+          paddedRow[jj] = coeffs[offset + jj]*pixelVector[offset + jj];
+      }
+      basisConvolvers[k]->ConvolvePaddedImage(basisInput);
+    } else {
+      for (long z = 0; z < nPixels_image; z++)
+        basisInput[z] = coeffs[z]*pixelVector[z];
+      basisConvolvers[k]->ConvolveImage(basisInput);
     }
+    for (long z = 0; z < nPixels_image; z++)
+      basisSum[z] += basisInput[z];
   }
+  memcpy(pixelVector, basisSum, (size_t)nPixels_image*sizeof(double));
 }
 
 
@@ -435,7 +1616,10 @@ void Convolver::ShiftAndWrapPSF( )
       destCol = (nColumns_padded - centerX_psf + psfCol) % nColumns_padded;
       destRow = (nRows_padded - centerY_psf + psfRow) % nRows_padded;
       pos_in_dest = (long)destRow * (long)nColumns_padded + destCol;
-      psf_in_padded[pos_in_dest] = psfPixels[pos_in_psf];
+      if (useFloatFFT)
+        psf_in_padded_f[pos_in_dest] = (float)normalizedPSF[pos_in_psf];
+      else
+        psf_in_padded[pos_in_dest] = normalizedPSF[pos_in_psf];
     }
   }
 }
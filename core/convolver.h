@@ -14,6 +14,14 @@
 using namespace std;
 
 
+// Convolution methods ("engines")
+const int  CONVOLUTION_ENGINE_AUTO      = 0;   // choose FFT or direct at setup
+const int  CONVOLUTION_ENGINE_FFT       = 1;   // standard FFT-based convolution
+const int  CONVOLUTION_ENGINE_DIRECT    = 2;   // direct (spatial-domain) convolution
+const int  CONVOLUTION_ENGINE_SEPARABLE = 3;   // spatial, using low-rank (SVD) approximation of PSF
+const int  CONVOLUTION_ENGINE_TILED     = 4;   // FFT, applied to image tiles (overlap-save)
+
+
 /// For debugging use: print a real-valued image to stdout
 void PrintRealImage( double *image, int nColumns, int nRows );
 
@@ -23,6 +31,26 @@ void PrintComplexImage_RealPart( fftw_complex *image_cmplx, int nColumns, int nR
 /// For debugging use: print absolute value of complex-valued image to stdout
 void PrintComplexImage_Absolute( fftw_complex *image_cmplx, int nColumns, int nRows );
 
+/// Returns FFTW planner flags (FFTW_ESTIMATE, etc.) for planning mode
+/// (FFTW_PLANNING_ESTIMATE, etc.)
+unsigned GetFFTWPlannerFlags( int planningMode );
+
+/// Computes padded image dimensions for FFT convolution: the cheapest (according
+/// to a simple cost model) sizes >= the minimum sizes which have no prime factors
+/// other than 2, 3, 5, and 7
+void GetFFTFriendlyPaddedSize( int minColumns, int minRows, int& nColumns_padded,
+								int& nRows_padded );
+
+/// Imports saved FFTW wisdom (first call only), and arranges for accumulated
+/// wisdom to be saved when the program exits (singlePrecision = true for the
+/// separate single-precision [fftwf] wisdom)
+void UseFFTWWisdomFile( bool singlePrecision=false );
+
+
+
+/// PSF transform and FFTW plans, shared by all Convolver objects with the same
+/// padded image size, PSF, and FFT settings (defined in convolver.cpp)
+struct SharedConvolutionResources;
 
 
 // NOTE: The following class is used in PyImfit
@@ -39,10 +67,29 @@ class Convolver
     // Public member functions:
     /// Set maximum number of FFTW threads
     void SetMaxThreads( int maximumThreadNumber );
+
+    /// Set rigor of FFTW planning (FFTW_PLANNING_ESTIMATE, FFTW_PLANNING_MEASURE, etc.)
+    void SetFFTWPlanning( int planningMode );
+
+    /// Specify convolution method (CONVOLUTION_ENGINE_AUTO [default], 
+    /// CONVOLUTION_ENGINE_FFT, etc.)
+    void SetConvolutionEngine( int engineType );
+
+    /// Specify whether FFT convolution should use single-precision (fftwf) FFTs
+    void UseFloatConvolution( bool useFloat );
+
+    /// Specify size (tileSize x tileSize pixels) of image tiles for tiled FFT
+    /// convolution (CONVOLUTION_ENGINE_TILED)
+    void SetTileSize( int tileSize );
     
     /// Supply PSF image to Convolver object
     void SetupPSF( double *psfPixels_input, int nColumns, int nRows,
     				bool normalize=true );
+
+    /// Supply basis PSF images and corresponding coefficient maps (same size as
+    /// the image to be convolved) for spatially varying PSF convolution
+    void SetupPSFBasis( vector<double *> basisPixels, int nColumns, int nRows,
+    					vector<double *> coefficientMaps );
     
     void SetupImage( int nColumns, int nRows );
     
@@ -52,10 +99,50 @@ class Convolver
     /// Replace input model image (pixelVector) with convolution using stored PSF
     void ConvolveImage( double *pixelVector );
 
+    /// Returns pointer to the zero-padded FFT input array (rows separated by
+    /// rowStride), for writing the image directly; nullptr if not available
+    double * GetPaddedInputImage( long& rowStride );
+
+    /// Convolve the image already written to the padded FFT input array, storing
+    /// the result in outputVector
+    void ConvolvePaddedImage( double *outputVector );
+
+    /// Returns convolution method in use (after DoFullSetup, never CONVOLUTION_ENGINE_AUTO)
+    int GetConvolutionEngine( );
+
+    /// Returns name of convolution method in use ("FFT", "direct", "separable",
+    /// or "tiled FFT")
+    string GetConvolutionEngineName( );
+
+    /// Returns size of image tiles (0 if not using tiled FFT convolution)
+    int GetTileSize( );
+
+    /// Returns number of Convolver objects (including this one) sharing this
+    /// object's PSF transform and FFTW plans (0 if not using FFT convolution)
+    int GetNSharingConvolvers( );
+
+    /// Returns number of basis PSFs (0 if using a single PSF)
+    int GetNBasisPSFs( );
+
 
   private:
   // Private member functions:
   void ShiftAndWrapPSF( );
+  void ConvolveImage_FFT( double *pixelVector );
+  void ConvolveImage_FFT_float( double *pixelVector );
+  void ConvolveImage_direct( double *pixelVector );
+  void ConvolveImage_separable( double *pixelVector );
+  void ConvolveImage_tiled( double *pixelVector );
+  void ConvolveImage_basis( double *pixelVector );
+  int SetupBasisConvolvers( );
+  int AllocateTileVectors( );
+  int SetupSeparableKernels( );
+  int AllocateSpatialVectors( );
+  void FreeFFTVectors( );
+  int AcquireSharedResources( unsigned fftwFlags, int nThreads );
+  void ReleaseSharedResources( );
+  void FreeSpatialVectors( );
+  int ChooseConvolutionEngine( );
   
   // Data members:
   long  nPixels_image, nPixels_psf, nPixels_padded;
@@ -63,15 +150,37 @@ class Convolver
   int  nRows_image, nColumns_image;
   int  nRows_padded, nColumns_padded;
   int  maxRequestedThreads;
-  double  rescaleFactor;
-  double  *psfPixels;
-  double  *image_in_padded, *psf_in_padded, *convolvedImage_out;
+  int  fftwPlanningMode;
+  double  *psfPixels;   // caller's PSF array; only used until DoFullSetup is done
+  vector<double>  normalizedPSF;   // our own copy of the (normalized) PSF
+  double  *image_in_padded, *convolvedImage_out;
+  double  *psf_in_padded;   // only allocated while computing PSF transform
   long  nPixels_padded_complex;
-  fftw_complex  *image_fft_cmplx;
-  fftw_complex  *psf_fft_cmplx;
-  fftw_complex  *multiplied_cmplx;
-  fftw_plan  plan_inputImage, plan_psf, plan_inverse;
-  bool  psfInfoSet, imageInfoSet, fftVectorsAllocated, fftPlansCreated;
+  fftw_complex  *image_fft_cmplx;   // also holds product with PSF transform
+  // single-precision equivalents, used instead of the above if useFloatFFT = true
+  bool  useFloatFFT;
+  float  *image_in_padded_f, *convolvedImage_out_f;
+  float  *psf_in_padded_f;
+  fftwf_complex  *image_fft_cmplx_f;
+  // PSF transform and FFTW plans (possibly shared with other Convolver objects)
+  SharedConvolutionResources  *sharedResources;
+  bool  psfInfoSet, imageInfoSet, fftVectorsAllocated;
+  int  convolutionEngine;
+  int  separableRank;   // number of terms in separable approximation of PSF
+  double  *separableColumnKernels, *separableRowKernels;
+  double  *spatialTemp, *spatialOutput;
+  bool  separableKernelsAllocated, spatialVectorsAllocated;
+  // tiled FFT convolution: each thread has its own working arrays (those for
+  // thread 0 are image_in_padded, etc.); the convolved image is assembled in tiledOutput
+  int  tileSize, nColumns_tile, nRows_tile, nTileThreads;
+  vector<double *>  tileInputArrays, tileOutputArrays;
+  vector<fftw_complex *>  tileFFTArrays;
+  double  *tiledOutput;
+  // spatially varying PSF: one Convolver per basis PSF, plus coefficient maps
+  vector<Convolver *>  basisConvolvers;
+  vector<double *>  basisCoefficientMaps;
+  double  *basisInput, *basisSum;
+  bool  basisVectorsAllocated;
   bool  normalizePSF;
   int  debugStatus;
 };
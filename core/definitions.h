@@ -31,6 +31,7 @@ const double NO_MAGNITUDES = -10000.0;   /* indicates data are *not* in magnitud
 
 const double GIGABYTE = 1073741824.0;   /* 1 gigabyte */
 const double MEMORY_WARNING_LIMT = 1073741824.0;   /* 1 gigabyte */
+const double DEFAULT_COMPONENT_CACHE_LIMIT = 2147483648.0;   /* 2 gigabytes */
 
 // imfit-related
 #define DEFAULT_IMFIT_CONFIG_FILE   "imfit_config.dat"
@@ -79,6 +80,29 @@ const int  MASK_ZERO_IS_GOOD =       10;  /// "standard" input mask format (good
 const int  MASK_ZERO_IS_BAD  =       20;  /// alternate input mask format (good pixels = 1)
 
 
+/* OPENMP SCHEDULING OF MODEL-IMAGE TILES */
+const int  OMP_SCHEDULE_STATIC  =     0;
+const int  OMP_SCHEDULE_DYNAMIC =     1;
+const int  OMP_SCHEDULE_GUIDED  =     2;
+const int  DEFAULT_OMP_TILE_ROWS    =     8;
+const int  DEFAULT_OMP_TILE_COLUMNS =   128;
+
+
+/* FFTW PLANNING RIGOR FOR PSF CONVOLUTION */
+const int  FFTW_PLANNING_ESTIMATE   =     0;
+const int  FFTW_PLANNING_MEASURE    =     1;
+const int  FFTW_PLANNING_PATIENT    =     2;
+const int  FFTW_PLANNING_EXHAUSTIVE =     3;
+// FFTW wisdom (saved results of planning) is stored in this file, in the current
+// directory, when planning is more rigorous than FFTW_PLANNING_ESTIMATE
+#define FFTW_WISDOM_FILENAME  ".imfit_fftw_wisdom"
+// (single-precision FFTW wisdom, for --float-convolution, is kept separately)
+#define FFTW_WISDOM_FILENAME_FLOAT  ".imfit_fftwf_wisdom"
+// Default size (in pixels, along each axis) of image tiles for tiled FFT convolution
+// (used when the estimated memory use exceeds the limit set by --max-memory-gb)
+const int  DEFAULT_CONVOLUTION_TILE_SIZE = 1024;
+
+
 
 /* STRING DEFINITIONS FOR PARAMETER NAMES */
 const std::string  X0_string("X0");
@@ -36,6 +36,7 @@
 using namespace std;
 
 #include "psf_oversampling_info.h"
+#include "convolver.h"
 
 
 const int  FFTW_SIZE = 16;
@@ -60,15 +61,17 @@ long EstimateConvolverMemoryUse( const int nModel_cols, const int nModel_rows,
 
   nBytesNeeded += (long)nPSF_cols * (long)nPSF_rows;   // allocated outside
   // Convolver stuff
-  nCols_padded = nModel_cols + nPSF_cols - 1;
-  nRows_padded = nModel_rows + nPSF_rows - 1;
+  // (same FFT-friendly padded size as chosen by Convolver::DoFullSetup)
+  GetFFTFriendlyPaddedSize(nModel_cols + nPSF_cols - 1, nModel_rows + nPSF_rows - 1,
+  							nCols_padded, nRows_padded);
   nCols_padded_trimmed = (int)(floor(nCols_padded/2)) + 1;   // reduced size of r2c/c2r complex array
   nPaddedPixels = (long)nCols_padded * (long)nRows_padded;
   nPaddedPixels_cmplx = (long)nCols_padded_trimmed * (long)nRows_padded;
-  // 3 double-precision arrays allocated in Convolver::DoFullSetup:
-  nBytesNeeded += 3 * nPaddedPixels * DOUBLE_SIZE;
-  // 3 fftw_complex arrays allocated in Convolver::DoFullSetup:
-  nBytesNeeded += 3 * nPaddedPixels_cmplx * FFTW_SIZE;
+  // 2 double-precision arrays allocated in Convolver::DoFullSetup:
+  nBytesNeeded += 2 * nPaddedPixels * DOUBLE_SIZE;
+  // 1 fftw_complex array allocated in Convolver::DoFullSetup, plus PSF transform
+  // (the latter may be shared with other Convolver objects, so this is an upper limit):
+  nBytesNeeded += 2 * nPaddedPixels_cmplx * FFTW_SIZE;
   
   return nBytesNeeded;
 }
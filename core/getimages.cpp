@@ -16,14 +16,20 @@
 // with Imfit.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
 #include <string>
+#include <vector>
 #include <tuple>
 #include <memory>
+#include <fstream>
 
 #include "image_io.h"
 #include "options_base.h"
 #include "getimages.h"
 #include "psf_oversampling_info.h"
+#include "psf_basis_info.h"
+#include "utilities_pub.h"
 #include "fftw3.h"  // so we can call fftw_free()
 
 
@@ -197,3 +203,184 @@ int GetOversampledPsfInfo( const std::shared_ptr<OptionsBase> options, int xOffs
   
   return 0;
 }
+
+
+
+// Reads polynomial coefficients for the PSF-basis terms from a text file and
+// evaluates the polynomials to make coefficient maps (see getimages.h for the 
+// file format). Returns -1 if the file can't be read or is incorrectly formatted.
+static int MakePolynomialCoefficientMaps( const string &fileName, int nBasis, int nColumns,
+										int nRows, int xOffset, int yOffset, 
+										vector<double *> &coefficientMaps )
+{
+  ifstream  inputFileStream;
+  string  inputLine;
+  vector<string>  pieces;
+  vector< vector<double> >  polyCoeffs;
+  double  x0 = 0.0, y0 = 0.0, scale = 1.0;
+  int  order = -1;
+
+  inputFileStream.open(fileName.c_str());
+  if (! inputFileStream) {
+    fprintf(stderr, "\n*** ERROR: Unable to open PSF-basis polynomial file \"%s\"!\n\n",
+    		fileName.c_str());
+    return -1;
+  }
+  while (getline(inputFileStream, inputLine)) {
+    ChopComment(inputLine);
+    TrimWhitespace(inputLine);
+    if (inputLine.size() == 0)
+      continue;
+    SplitString(inputLine, pieces);
+    if ((pieces[0] == "X0") || (pieces[0] == "Y0") || (pieces[0] == "SCALE")
+    		|| (pieces[0] == "ORDER")) {
+      if ((pieces.size() != 2) || (! IsNumeric(pieces[1].c_str()))) {
+        fprintf(stderr, "\n*** ERROR: Bad line in PSF-basis polynomial file \"%s\":\n", 
+        		fileName.c_str());
+        fprintf(stderr, "   %s\n\n", inputLine.c_str());
+        return -1;
+      }
+      if (pieces[0] == "X0")
+        x0 = atof(pieces[1].c_str());
+      else if (pieces[0] == "Y0")
+        y0 = atof(pieces[1].c_str());
+      else if (pieces[0] == "SCALE")
+        scale = atof(pieces[1].c_str());
+      else
+        order = atoi(pieces[1].c_str());
+      continue;
+    }
+    vector<double>  coeffs;
+    for (string &piece : pieces) {
+      if (! IsNumeric(piece.c_str())) {
+        fprintf(stderr, "\n*** ERROR: Bad line in PSF-basis polynomial file \"%s\":\n", 
+        		fileName.c_str());
+        fprintf(stderr, "   %s\n\n", inputLine.c_str());
+        return -1;
+      }
+      coeffs.push_back(atof(piece.c_str()));
+    }
+    polyCoeffs.push_back(coeffs);
+  }
+  inputFileStream.close();
+
+  int  nTerms = (order + 1)*(order + 2)/2;
+  if ((order < 0) || (scale == 0.0)) {
+    fprintf(stderr, "\n*** ERROR: PSF-basis polynomial file \"%s\" must specify ORDER >= 0", 
+    		fileName.c_str());
+    fprintf(stderr, " (and SCALE, if present, must be nonzero)!\n\n");
+    return -1;
+  }
+  if ((int)polyCoeffs.size() != nBasis) {
+    fprintf(stderr, "\n*** ERROR: number of polynomials in \"%s\" (%d) is not the same\n", 
+    		fileName.c_str(), (int)polyCoeffs.size());
+    fprintf(stderr, "           as number of basis PSF images (%d)!\n\n", nBasis);
+    return -1;
+  }
+  for (int k = 0; k < nBasis; k++) {
+    if ((int)polyCoeffs[k].size() != nTerms) {
+      fprintf(stderr, "\n*** ERROR: polynomial %d in \"%s\" has %d coefficients ", k + 1,
+      		fileName.c_str(), (int)polyCoeffs[k].size());
+      fprintf(stderr, "(should be %d for ORDER = %d)!\n\n", nTerms, order);
+      return -1;
+    }
+  }
+
+  vector<double>  terms(nTerms);
+  for (int k = 0; k < nBasis; k++)
+    coefficientMaps.push_back((double *)fftw_malloc(sizeof(double) * (long)nColumns * nRows));
+  for (int i = 0; i < nRows; i++) {
+    double  v = (i + 1 + yOffset - y0) / scale;
+    for (int j = 0; j < nColumns; j++) {
+      double  u = (j + 1 + xOffset - x0) / scale;
+      // u^a v^b, in order of total degree, then decreasing power of u
+      int  t = 0;
+      for (int degree = 0; degree <= order; degree++)
+        for (int b = 0; b <= degree; b++)
+          terms[t++] = pow(u, degree - b) * pow(v, b);
+      for (int k = 0; k < nBasis; k++) {
+        double  sum = 0.0;
+        for (t = 0; t < nTerms; t++)
+          sum += polyCoeffs[k][t]*terms[t];
+        coefficientMaps[k][(long)i*nColumns + j] = sum;
+      }
+    }
+  }
+  return 0;
+}
+
+
+
+// Function which reads the basis PSF images (all of which must have the same
+// dimensions) and their coefficient maps, or else computes the latter from 
+// the polynomial coefficients in options->psfBasisPolyFileName
+int GetPsfBasisInfo( const std::shared_ptr<OptionsBase> options, int nColumns, int nRows,
+					int xOffset, int yOffset, PsfBasisInfo &psfBasisInfo )
+{
+  double  *pixels;
+  int  nColumns_psf, nRows_psf, status;
+  int  nBasis = (int)options->psfBasisFileNames.size();
+  
+  for (int k = 0; k < nBasis; k++) {
+    std::tie(pixels, nColumns_psf, nRows_psf, status) = GetPsfImage(options->psfBasisFileNames[k]);
+    if (status < 0)
+      return -1;
+    psfBasisInfo.psfImages.push_back(pixels);
+    if (k == 0) {
+      psfBasisInfo.nColumns_psf = nColumns_psf;
+      psfBasisInfo.nRows_psf = nRows_psf;
+    }
+    else if ((nColumns_psf != psfBasisInfo.nColumns_psf) || (nRows_psf != psfBasisInfo.nRows_psf)) {
+      fprintf(stderr, "\n*** ERROR: basis PSF images must all have the same dimensions!\n\n");
+      return -1;
+    }
+  }
+
+  psfBasisInfo.nColumns_map = nColumns;
+  psfBasisInfo.nRows_map = nRows;
+  if (options->psfBasisCoeffFileNames.size() > 0) {
+    if ((int)options->psfBasisCoeffFileNames.size() != nBasis) {
+      fprintf(stderr, "\n*** ERROR: number of PSF-basis coefficient maps (%d) is not the same\n", 
+     				(int)options->psfBasisCoeffFileNames.size());
+      fprintf(stderr, "           as number of basis PSF images (%d)!\n\n", nBasis);
+      return -1;
+    }
+    for (int k = 0; k < nBasis; k++) {
+      printf("Reading PSF-basis coefficient map (\"%s\") ...\n", 
+      		options->psfBasisCoeffFileNames[k].c_str());
+      std::tie(pixels, status) = GetAndCheckImage(options->psfBasisCoeffFileNames[k], 
+      										"PSF-basis coefficient map", nColumns, nRows);
+      if (status < 0)
+        return -1;
+      psfBasisInfo.coefficientMaps.push_back(pixels);
+    }
+  }
+  else if (options->psfBasisPolyFileName.size() > 0) {
+    printf("Reading PSF-basis polynomial coefficients (\"%s\") ...\n", 
+    		options->psfBasisPolyFileName.c_str());
+    status = MakePolynomialCoefficientMaps(options->psfBasisPolyFileName, nBasis, nColumns, 
+    									nRows, xOffset, yOffset, psfBasisInfo.coefficientMaps);
+    if (status < 0)
+      return -1;
+  }
+  else {
+    fprintf(stderr, "\n*** ERROR: when specifying basis PSF images, you must also supply ");
+    fprintf(stderr, "coefficient maps (\"--psf-basis-coeffs\")\n");
+    fprintf(stderr, "           or polynomial coefficients (\"--psf-basis-poly\")!\n\n");
+    return -1;
+  }
+  
+  return 0;
+}
+
+
+
+void FreePsfBasisInfo( PsfBasisInfo &psfBasisInfo )
+{
+  for (double *pixels : psfBasisInfo.psfImages)
+    fftw_free(pixels);
+  for (double *pixels : psfBasisInfo.coefficientMaps)
+    fftw_free(pixels);
+  psfBasisInfo.psfImages.clear();
+  psfBasisInfo.coefficientMaps.clear();
+}
@@ -13,6 +13,7 @@
 
 #include "options_base.h"
 #include "psf_oversampling_info.h"
+#include "psf_basis_info.h"
 
 
 /// Main utility function: reads in image from FITS file imageName and checks dimensions
@@ -35,5 +36,19 @@ std::tuple<double *, int, int, int> GetPsfImage( const string &psfFileName );
 int GetOversampledPsfInfo( const std::shared_ptr<OptionsBase> options, int xOffset, int yOffset, 
 							vector<PsfOversamplingInfo *> &psfOversamplingInfoVect );
 
+/// Reads in basis PSF images and their coefficient maps (or computes the latter
+/// from polynomial coefficients), for spatially varying PSF convolution. The
+/// polynomial-coefficient file has lines of the form "X0 <value>", "Y0 <value>", 
+/// "SCALE <value>" (optional), and "ORDER <n>", followed by one line of coefficients 
+/// per basis PSF, for the terms u^i v^j of c_k(u,v) ordered by total degree i + j 
+/// and then by decreasing power of u (1, u, v, u^2, u v, v^2, ...), where 
+/// u = (x - X0)/SCALE, v = (y - Y0)/SCALE, and x,y are pixel coordinates in the
+/// full image.
+int GetPsfBasisInfo( const std::shared_ptr<OptionsBase> options, int nColumns, int nRows,
+					int xOffset, int yOffset, PsfBasisInfo &psfBasisInfo );
+
+/// Frees the images and maps read or computed by GetPsfBasisInfo
+void FreePsfBasisInfo( PsfBasisInfo &psfBasisInfo );
+
 
 #endif  // _GETIMAGES_MASKERROR_H_
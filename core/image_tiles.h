@@ -0,0 +1,112 @@
+/*! \file
+   \brief  Class declaration for ImageTiles (division of an image into
+           rectangular tiles for OpenMP scheduling of image computations).
+
+   Pixel costs in model images are very uneven -- pixels near component centers,
+   where pixel subsampling is done, can be 10-100 times as expensive as other
+   pixels -- so dividing the image into equal bands of rows and assigning them
+   statically to threads can leave most threads idle while one thread processes
+   the central region. Dividing the image into small 2D tiles and assigning
+   them dynamically (or with guided scheduling) gives much better load balance.
+   Tiles are numbered in row-major order (along rows first).
+
+   All methods are defined inline here, so there is no separate .cpp file.
+ */
+
+#ifndef _IMAGE_TILES_H_
+#define _IMAGE_TILES_H_
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+#include <vector>
+
+#include "definitions.h"
+
+
+/// \brief Division of an image into rectangular tiles, for OpenMP scheduling
+class ImageTiles
+{
+  public:
+    /// Divides image with nRows x nColumns pixels into tiles of (up to)
+    /// tileRows x tileColumns pixels; tileColumns <= 0 means full rows
+    ImageTiles( long nRows, long nColumns, int tileRows, int tileColumns )
+    {
+      nImageRows = nRows;
+      nImageColumns = nColumns;
+      nRowsPerTile = (tileRows > 0) ? tileRows : 1;
+      nColumnsPerTile = (tileColumns > 0) ? tileColumns : nColumns;
+      if (nColumnsPerTile < 1)
+        nColumnsPerTile = 1;
+      nTilesY = (nImageRows + nRowsPerTile - 1) / nRowsPerTile;
+      nTilesX = (nImageColumns + nColumnsPerTile - 1) / nColumnsPerTile;
+    };
+
+    long GetNTiles( ) { return nTilesX*nTilesY; };
+
+    long GetMaxTileColumns( ) { return nColumnsPerTile; };
+
+    /// Returns the pixel limits of tile tileNumber: rows iStart to iEnd - 1 and
+    /// columns jStart to jEnd - 1
+    void GetTileLimits( long tileNumber, long& iStart, long& iEnd, long& jStart,
+    					long& jEnd )
+    {
+      long  tileRow = tileNumber / nTilesX;
+      long  tileColumn = tileNumber - tileRow*nTilesX;
+      iStart = tileRow*nRowsPerTile;
+      iEnd = iStart + nRowsPerTile;
+      if (iEnd > nImageRows)
+        iEnd = nImageRows;
+      jStart = tileColumn*nColumnsPerTile;
+      jEnd = jStart + nColumnsPerTile;
+      if (jEnd > nImageColumns)
+        jEnd = nImageColumns;
+    };
+
+    /// Appends to tileNumbers the numbers of all tiles overlapping the block of
+    /// pixels with rows iStart to iEnd - 1 and columns jStart to jEnd - 1
+    void GetOverlappingTiles( long iStart, long iEnd, long jStart, long jEnd, 
+    							vector<long>& tileNumbers )
+    {
+      if (iStart < 0)
+        iStart = 0;
+      if (jStart < 0)
+        jStart = 0;
+      if (iEnd > nImageRows)
+        iEnd = nImageRows;
+      if (jEnd > nImageColumns)
+        jEnd = nImageColumns;
+      if ((iEnd <= iStart) || (jEnd <= jStart))
+        return;
+      for (long tileRow = iStart/nRowsPerTile; tileRow <= (iEnd - 1)/nRowsPerTile; tileRow++)
+        for (long tileColumn = jStart/nColumnsPerTile; 
+        		tileColumn <= (jEnd - 1)/nColumnsPerTile; tileColumn++)
+          tileNumbers.push_back(tileRow*nTilesX + tileColumn);
+    };
+
+
+  private:
+    long  nImageRows, nImageColumns;
+    long  nRowsPerTile, nColumnsPerTile;
+    long  nTilesX, nTilesY;
+};
+
+
+/// Sets the OpenMP schedule (one tile per chunk) used by subsequent loops with
+/// "schedule (runtime)" over image tiles. Must be called *outside* the parallel
+/// region.
+inline void SetOMPTileSchedule( int scheduleType )
+{
+#ifdef USE_OPENMP
+  if (scheduleType == OMP_SCHEDULE_DYNAMIC)
+    omp_set_schedule(omp_sched_dynamic, 1);
+  else if (scheduleType == OMP_SCHEDULE_GUIDED)
+    omp_set_schedule(omp_sched_guided, 1);
+  else
+    omp_set_schedule(omp_sched_static, 1);
+#endif
+}
+
+
+#endif  // _IMAGE_TILES_H_
@@ -128,6 +128,7 @@ int main(int argc, char *argv[])
   double  *allMaskPixels;
   bool  maskAllocated = false;
   vector<PsfOversamplingInfo *>  psfOversamplingInfoVect;
+  PsfBasisInfo  psfBasisInfo;
   double  *paramsVect;
   int  X0_offset = 0;
   int  Y0_offset = 0;
@@ -223,6 +224,13 @@ int main(int argc, char *argv[])
     if (status < 0)
       exit(-1);
   }
+  else if (options->psfBasisPresent) {
+    status = GetPsfBasisInfo(options, nColumns, nRows, X0_offset, Y0_offset, psfBasisInfo);
+    if (status < 0)
+      exit(-1);
+    nColumns_psf = psfBasisInfo.nColumns_psf;
+    nRows_psf = psfBasisInfo.nRows_psf;
+  }
   else
     printf("* No PSF image supplied -- no image convolution will be done!\n");
 
@@ -246,7 +254,8 @@ int main(int argc, char *argv[])
   nColumnsRowsVect.push_back(nRows_psf);
 
   theModel = SetupModelObject(options, nColumnsRowsVect, allPixels, psfPixels, allMaskPixels,
-  								allErrorPixels, psfOversamplingInfoVect);
+  								allErrorPixels, psfOversamplingInfoVect,
+  								(options->psfBasisPresent) ? &psfBasisInfo : nullptr);
   
 
   // Add functions to the model object
@@ -331,6 +340,7 @@ int main(int argc, char *argv[])
   										options->saveModel);
   if (options->psfOversampledImagePresent)
     estimatedMemory += EstimatePsfOversamplingMemoryUse(psfOversamplingInfoVect);
+  estimatedMemory += theModel->EstimateComponentCacheMemoryUse();
 
   nGBytes = (1.0*estimatedMemory) / GIGABYTE;
   if (nGBytes >= 1.0)
@@ -484,6 +494,7 @@ int main(int argc, char *argv[])
     fftw_free(allErrorPixels);          // allocated externally, in ReadImageAsVector()
   if (options->psfImagePresent)
     fftw_free(psfPixels);               // allocated externally, in ReadImageAsVector()
+  FreePsfBasisInfo(psfBasisInfo);
   if (maskAllocated)
     fftw_free(allMaskPixels);           // allocated externally, in ReadImageAsVector()
   if (psfOversamplingInfoVect.size() > 0) {
@@ -547,6 +558,11 @@ void ProcessInput( int argc, char *argv[], shared_ptr<ImfitOptions> theOptions )
   optParser->AddUsageLine("     --psf <psf.fits>         PSF image to use");
   optParser->AddUsageLine("     --no-normalize           Do *not* normalize input PSF image");
   optParser->AddUsageLine("");
+  optParser->AddUsageLine("     (Note that the following 2 options can be specified multiple times)");
+  optParser->AddUsageLine("     --psf-basis <psf.fits>   Basis PSF image for spatially varying PSF");
+  optParser->AddUsageLine("     --psf-basis-coeffs <map.fits> Coefficient map for basis PSF (same size as image)");
+  optParser->AddUsageLine("     --psf-basis-poly <file>  Polynomial coefficients for basis PSFs (instead of maps)");
+  optParser->AddUsageLine("");
   optParser->AddUsageLine("     (Note that the following 3 options can be specified multiple times)");
   optParser->AddUsageLine("     --overpsf <psf.fits>      Oversampled PSF image to use");
   optParser->AddUsageLine("     --overpsf_scale <n>       Oversampling scale (integer)");
@@ -591,9 +607,32 @@ void ProcessInput( int argc, char *argv[], shared_ptr<ImfitOptions> theOptions )
   optParser->AddUsageLine("     --loud                   Print extra info during the fit");
   optParser->AddUsageLine("");
   optParser->AddUsageLine("     --max-threads <int>      Maximum number of threads to use");
+  optParser->AddUsageLine("     --omp-schedule <name>    OpenMP scheduling of image tiles (static, dynamic, or");
+  optParser->AddUsageLine("                              guided; default = dynamic)");
+  optParser->AddUsageLine("     --omp-tile-size <nr,nc>  Size of image tiles assigned to threads (rows,columns;");
+  optParser->AddUsageLine("                              nc = 0 for full rows; default = 8,128)");
+  optParser->AddUsageLine("     --fftw-planning <name>   Rigor of FFTW planning for PSF convolution (estimate, measure,");
+  optParser->AddUsageLine("                              patient, or exhaustive; default = estimate); results of");
+  optParser->AddUsageLine("                              slower planning are saved in .imfit_fftw_wisdom for re-use");
+  optParser->AddUsageLine("     --float-convolution      Do FFTs for PSF convolution in single precision (faster,");
+  optParser->AddUsageLine("                              uses less memory; relative accuracy ~ 1e-6)");
+  optParser->AddUsageLine("     --conv-tile-size <int>   Do PSF convolution with FFTs of image tiles of this size");
+  optParser->AddUsageLine("                              (in pixels), to limit memory use for very large images");
+  optParser->AddUsageLine("     --max-memory-gb <value>  Use tiled PSF convolution if estimated memory use for");
+  optParser->AddUsageLine("                              the model image and PSF convolution exceeds this (in GB);");
+  optParser->AddUsageLine("                              also limits memory for cached component images");
   optParser->AddUsageLine("");
   optParser->AddUsageLine("     --seed <int>             RNG seed (for testing purposes)");
   optParser->AddUsageLine("     --no-subsampling         Turn off pixel subsampling near centers of functions");
+  optParser->AddUsageLine("     --footprint-frac <value> Only compute functions where I > value * central intensity");
+  optParser->AddUsageLine("                              (0 < value < 1; default = compute functions everywhere)");
+  optParser->AddUsageLine("                              (cut is relative to peak intensity, which can omit much");
+  optParser->AddUsageLine("                              of the flux of extended profiles; Sersic footprints are");
+  optParser->AddUsageLine("                              enlarged so that < value of their total flux is omitted)");
+  optParser->AddUsageLine("     --profile-tables         Use lookup tables for radial profiles of elliptical functions");
+  optParser->AddUsageLine("     --no-component-cache     Do *not* cache & re-use images of unchanged components");
+  optParser->AddUsageLine("     --component-cache-gb <value> Max. memory (in GB) for cached component images");
+  optParser->AddUsageLine("                              [default = 2, or whatever is left of --max-memory-gb]");
   optParser->AddUsageLine("");
   optParser->AddUsageLine("EXAMPLES:");
   optParser->AddUsageLine("   imfit -c model_config_n100a.dat ngc100.fits");
@@ -614,7 +653,12 @@ void ProcessInput( int argc, char *argv[], shared_ptr<ImfitOptions> theOptions )
   optParser->AddFlag("errors-are-weights");
   optParser->AddFlag("mask-zero-is-bad");
   optParser->AddFlag("no-normalize");
+  optParser->AddQueueOption("psf-basis");
+  optParser->AddQueueOption("psf-basis-coeffs");
+  optParser->AddOption("psf-basis-poly");
   optParser->AddFlag("no-subsampling");
+  optParser->AddFlag("profile-tables");
+  optParser->AddFlag("no-component-cache");
   optParser->AddFlag("model-errors");
   optParser->AddFlag("cashstat");
   optParser->AddFlag("poisson-mlr");
@@ -648,6 +692,14 @@ void ProcessInput( int argc, char *argv[], shared_ptr<ImfitOptions> theOptions )
   optParser->AddOption("save-bootstrap");
   optParser->AddOption("config", "c");
   optParser->AddOption("max-threads");
+  optParser->AddOption("omp-schedule");
+  optParser->AddOption("omp-tile-size");
+  optParser->AddOption("fftw-planning");
+  optParser->AddFlag("float-convolution");
+  optParser->AddOption("conv-tile-size");
+  optParser->AddOption("max-memory-gb");
+  optParser->AddOption("footprint-frac");
+  optParser->AddOption("component-cache-gb");
   optParser->AddOption("seed");
 
   // Comment this out if you want unrecognized (e.g., mis-spelled) flags and options
@@ -756,6 +808,12 @@ void ProcessInput( int argc, char *argv[], shared_ptr<ImfitOptions> theOptions )
   if (optParser->FlagSet("no-subsampling")) {
     theOptions->subsamplingFlag = false;
   }
+  if (optParser->FlagSet("profile-tables")) {
+    theOptions->useProfileTables = true;
+  }
+  if (optParser->FlagSet("no-component-cache")) {
+    theOptions->useComponentCache = false;
+  }
   if (optParser->FlagSet("silent")) {
     theOptions->verbose = -1;
   }
@@ -788,6 +846,30 @@ void ProcessInput( int argc, char *argv[], shared_ptr<ImfitOptions> theOptions )
     theOptions->psfImagePresent = true;
     printf("\tPSF image = %s\n", theOptions->psfFileName.c_str());
   }
+  if (optParser->OptionSet("psf-basis")) {
+    if (theOptions->psfImagePresent) {
+      fprintf(stderr, "*** ERROR: --psf and --psf-basis cannot both be used!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->psfBasisPresent = true;
+    for (int i = 0; i < optParser->GetNTargets("psf-basis"); i++) {
+      string fileName = optParser->GetTargetString("psf-basis", i);
+      theOptions->psfBasisFileNames.push_back(fileName);
+      printf("\tBasis PSF image = %s\n", fileName.c_str());
+    }
+  }
+  if (optParser->OptionSet("psf-basis-coeffs")) {
+    for (int i = 0; i < optParser->GetNTargets("psf-basis-coeffs"); i++) {
+      string fileName = optParser->GetTargetString("psf-basis-coeffs", i);
+      theOptions->psfBasisCoeffFileNames.push_back(fileName);
+      printf("\tPSF-basis coefficient map = %s\n", fileName.c_str());
+    }
+  }
+  if (optParser->OptionSet("psf-basis-poly")) {
+    theOptions->psfBasisPolyFileName = optParser->GetTargetString("psf-basis-poly");
+    printf("\tPSF-basis polynomial file = %s\n", theOptions->psfBasisPolyFileName.c_str());
+  }
   
   // oversampled PSF(s) and region(s)
   if (optParser->OptionSet("overpsf")) {
@@ -931,6 +1013,96 @@ void ProcessInput( int argc, char *argv[], shared_ptr<ImfitOptions> theOptions )
     theOptions->maxThreads = atol(optParser->GetTargetString("max-threads").c_str());
     theOptions->maxThreadsSet = true;
   }
+  if (optParser->OptionSet("omp-schedule")) {
+    string  scheduleName = optParser->GetTargetString("omp-schedule");
+    if (scheduleName == "static")
+      theOptions->ompScheduleType = OMP_SCHEDULE_STATIC;
+    else if (scheduleName == "dynamic")
+      theOptions->ompScheduleType = OMP_SCHEDULE_DYNAMIC;
+    else if (scheduleName == "guided")
+      theOptions->ompScheduleType = OMP_SCHEDULE_GUIDED;
+    else {
+      fprintf(stderr, "*** ERROR: omp-schedule should be \"static\", \"dynamic\", or \"guided\"!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->ompScheduleSet = true;
+  }
+  if (optParser->OptionSet("omp-tile-size")) {
+    vector<string>  tileSizeStrings;
+    SplitString(optParser->GetTargetString("omp-tile-size"), tileSizeStrings, ",");
+    if ((tileSizeStrings.size() != 2) || (NotANumber(tileSizeStrings[0].c_str(), 0, kPosInt))
+    		|| (NotANumber(tileSizeStrings[1].c_str(), 0, kAnyInt))
+    		|| (atol(tileSizeStrings[1].c_str()) < 0)) {
+      fprintf(stderr, "*** ERROR: omp-tile-size should be of the form <n_rows>,<n_columns>!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->ompTileRows = atol(tileSizeStrings[0].c_str());
+    theOptions->ompTileColumns = atol(tileSizeStrings[1].c_str());
+    theOptions->ompTileSizeSet = true;
+  }
+  if (optParser->FlagSet("float-convolution")) {
+    theOptions->useFloatConvolution = true;
+  }
+  if (optParser->OptionSet("conv-tile-size")) {
+    if (NotANumber(optParser->GetTargetString("conv-tile-size").c_str(), 0, kPosInt)) {
+      fprintf(stderr, "*** ERROR: conv-tile-size should be a positive integer!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->convolutionTileSize = atol(optParser->GetTargetString("conv-tile-size").c_str());
+    theOptions->convolutionTileSizeSet = true;
+  }
+  if (optParser->OptionSet("max-memory-gb")) {
+    if (NotANumber(optParser->GetTargetString("max-memory-gb").c_str(), 0, kPosReal)) {
+      fprintf(stderr, "*** ERROR: max-memory-gb should be a positive real number!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->maxMemory = GIGABYTE * atof(optParser->GetTargetString("max-memory-gb").c_str());
+    theOptions->maxMemorySet = true;
+  }
+  if (optParser->OptionSet("fftw-planning")) {
+    string  planningName = optParser->GetTargetString("fftw-planning");
+    if (planningName == "estimate")
+      theOptions->fftwPlanningMode = FFTW_PLANNING_ESTIMATE;
+    else if (planningName == "measure")
+      theOptions->fftwPlanningMode = FFTW_PLANNING_MEASURE;
+    else if (planningName == "patient")
+      theOptions->fftwPlanningMode = FFTW_PLANNING_PATIENT;
+    else if (planningName == "exhaustive")
+      theOptions->fftwPlanningMode = FFTW_PLANNING_EXHAUSTIVE;
+    else {
+      fprintf(stderr, "*** ERROR: fftw-planning should be \"estimate\", \"measure\", \"patient\", or \"exhaustive\"!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->fftwPlanningSet = true;
+  }
+  if (optParser->OptionSet("footprint-frac")) {
+    if (NotANumber(optParser->GetTargetString("footprint-frac").c_str(), 0, kPosReal)) {
+      fprintf(stderr, "*** ERROR: footprint-frac should be a positive real number!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->footprintFraction = atof(optParser->GetTargetString("footprint-frac").c_str());
+    if (theOptions->footprintFraction >= 1.0) {
+      fprintf(stderr, "*** ERROR: footprint-frac should be < 1!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->footprintFractionSet = true;
+  }
+  if (optParser->OptionSet("component-cache-gb")) {
+    if (NotANumber(optParser->GetTargetString("component-cache-gb").c_str(), 0, kPosReal)) {
+      fprintf(stderr, "*** ERROR: component-cache-gb should be a positive real number!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->componentCacheLimit = GIGABYTE * atof(optParser->GetTargetString("component-cache-gb").c_str());
+    theOptions->componentCacheLimitSet = true;
+  }
   if (optParser->OptionSet("seed")) {
     if (NotANumber(optParser->GetTargetString("seed").c_str(), 0, kPosInt)) {
       printf("*** WARNING: RNG seed should be a positive integer!\n");
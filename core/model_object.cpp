@@ -54,6 +54,7 @@
 #include <assert.h>
 //#include <math.h>
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 #include <tuple>
 
@@ -69,6 +70,7 @@ using namespace std;
 #include "mp_enorm.h"
 #include "param_struct.h"
 #include "utilities_pub.h"
+#include "image_tiles.h"
 
 
 /* ---------------- Definitions ---------------------------------------- */
@@ -122,6 +124,16 @@ ModelObject::ModelObject( )
   localPsfPixels = nullptr;
   psfInterpolator = nullptr;
   psfInterpolator_allocated = false;
+  componentImages = nullptr;
+  convolvedComponentsImage = nullptr;
+  postConvolutionImage = nullptr;
+  postConvolutionCacheValid = false;
+  convolverInputImage = nullptr;
+  convolverInputStride = 0;
+  frozenImage = nullptr;
+  bypassBackgroundConvolution = false;
+  psfFluxScale = 1.0;
+  psfShiftX = psfShiftY = 0.0;
   
   modelVectorAllocated = false;
   maskVectorAllocated = false;
@@ -132,9 +144,21 @@ ModelObject::ModelObject( )
   deviatesVectorAllocated = false;
   extraCashTermsVectorAllocated = false;
   localPsfPixels_allocated = false;
+  nColumns_psfBasisMap = nRows_psfBasisMap = 0;
   
   fsetStartFlags_allocated = false;
   
+  useComponentCache = false;
+  componentCacheAllocated = false;
+  componentCacheValid = false;
+  maxComponentCacheBytes = DEFAULT_COMPONENT_CACHE_LIMIT;
+  cachedImageParams[0] = cachedImageParams[2] = 1.0;
+  cachedImageParams[1] = 0.0;
+  useFrozenCache = false;
+  frozenImageAllocated = false;
+  frozenImageValid = false;
+  nFrozenComponents = 0;
+  
   // default setup = use data-based Gaussian errors + chi^2 minimization
   dataErrors = true;
   externalErrorVectorSupplied = false;
@@ -172,6 +196,14 @@ ModelObject::ModelObject( )
   
   maxRequestedThreads = 0;   // default value --> use all available processors/cores
   ompChunkSize = DEFAULT_OPENMP_CHUNK_SIZE;
+  ompScheduleType = OMP_SCHEDULE_DYNAMIC;
+  ompTileRows = DEFAULT_OMP_TILE_ROWS;
+  ompTileColumns = DEFAULT_OMP_TILE_COLUMNS;
+  fftwPlanningMode = FFTW_PLANNING_ESTIMATE;
+  useFloatConvolution = false;
+  convolutionTileSize = 0;   // default = convolve whole image at once
+  footprintFraction = 0.0;   // default = no footprint limits (except for truncated functions)
+  useProfileTables = false;
   
   nDataVals = nDataColumns = nDataRows = 0;
   nModelVals = nModelColumns = nModelRows = 0;
@@ -201,6 +233,13 @@ ModelObject::~ModelObject()
     free(extraCashTermsVector);
   if (localPsfPixels_allocated)
     free(localPsfPixels);
+  for (double *pixels : psfBasisPixels)
+    free(pixels);
+  for (double *pixels : psfBasisCoeffMaps)
+    free(pixels);
+  FreeComponentCache();
+  if (frozenImageAllocated)
+    free(frozenImage);
 
   if (psfInterpolator_allocated)
     delete psfInterpolator;
@@ -274,6 +313,184 @@ void ModelObject::SetOMPChunkSize( int chunkSize )
 }
 
 
+/* ---------------- PUBLIC METHOD: SetOMPSchedule ---------------------- */
+/// Sets the OpenMP scheduling (OMP_SCHEDULE_STATIC, OMP_SCHEDULE_DYNAMIC, or
+/// OMP_SCHEDULE_GUIDED) used to assign tiles of the model image to threads
+/// when computing the model image (including oversampled regions).
+void ModelObject::SetOMPSchedule( int scheduleType )
+{
+  assert( (scheduleType >= OMP_SCHEDULE_STATIC) && (scheduleType <= OMP_SCHEDULE_GUIDED) );
+  ompScheduleType = scheduleType;
+  for (int n = 0; n < nOversampledRegions; n++)
+    oversampledRegionsVect[n]->SetOMPTiling(ompScheduleType, ompTileRows, ompTileColumns);
+}
+
+
+/* ---------------- PUBLIC METHOD: SetOMPTileSize ---------------------- */
+/// Sets the size (in rows and columns of the model image) of the tiles which
+/// are assigned to threads when computing the model image; tileColumns = 0
+/// means tiles extend over full rows.
+void ModelObject::SetOMPTileSize( int tileRows, int tileColumns )
+{
+  assert( (tileRows >= 1) && (tileColumns >= 0) );
+  ompTileRows = tileRows;
+  ompTileColumns = tileColumns;
+  for (int n = 0; n < nOversampledRegions; n++)
+    oversampledRegionsVect[n]->SetOMPTiling(ompScheduleType, ompTileRows, ompTileColumns);
+}
+
+
+/* ---------------- PUBLIC METHOD: SetFFTWPlanning --------------------- */
+/// Sets the rigor of FFTW planning for PSF convolutions (FFTW_PLANNING_ESTIMATE
+/// [default], FFTW_PLANNING_MEASURE, FFTW_PLANNING_PATIENT, or 
+/// FFTW_PLANNING_EXHAUSTIVE). More rigorous planning takes longer during setup,
+/// but can produce faster FFTs; the results are saved as FFTW wisdom and re-used
+/// in later runs with the same image and PSF sizes. Must be called before the
+/// model image is set up.
+void ModelObject::SetFFTWPlanning( int planningMode )
+{
+  assert( (planningMode >= FFTW_PLANNING_ESTIMATE) && (planningMode <= FFTW_PLANNING_EXHAUSTIVE) );
+  fftwPlanningMode = planningMode;
+  if (doConvolution)
+    psfConvolver->SetFFTWPlanning(fftwPlanningMode);
+  for (int n = 0; n < nOversampledRegions; n++)
+    oversampledRegionsVect[n]->SetFFTWPlanning(fftwPlanningMode);
+}
+
+
+/* ---------------- PUBLIC METHOD: UseFloatConvolution ----------------- */
+/// Specifies whether FFTs for PSF convolutions (main model image and any
+/// oversampled regions) should be done in single precision, which roughly halves
+/// the time and memory needed for large images, at the cost of relative errors
+/// ~ 1e-6 in the convolved images. Must be called before the model image is set up.
+void ModelObject::UseFloatConvolution( bool useFloat )
+{
+  useFloatConvolution = useFloat;
+  if (doConvolution)
+    psfConvolver->UseFloatConvolution(useFloatConvolution);
+  for (int n = 0; n < nOversampledRegions; n++)
+    oversampledRegionsVect[n]->UseFloatConvolution(useFloatConvolution);
+}
+
+
+/* ---------------- PUBLIC METHOD: UseTiledConvolution ----------------- */
+/// Specifies that PSF convolution of the main model image should be done with
+/// FFTs of tileSize x tileSize image tiles (overlap-save method), which limits
+/// the memory needed for convolving very large images; tileSize <= 0 means the 
+/// whole image is convolved at once (the default). Oversampled regions are not
+/// affected. Must be called before the model image is set up.
+void ModelObject::UseTiledConvolution( int tileSize )
+{
+  convolutionTileSize = tileSize;
+  if (doConvolution) {
+    if (convolutionTileSize > 0) {
+      psfConvolver->SetConvolutionEngine(CONVOLUTION_ENGINE_TILED);
+      psfConvolver->SetTileSize(convolutionTileSize);
+    } else
+      psfConvolver->SetConvolutionEngine(CONVOLUTION_ENGINE_AUTO);
+  }
+}
+
+
+/* ---------------- PUBLIC METHOD: SetFootprintFraction ---------------- */
+/// Sets the fraction of each function's central intensity below which the
+/// function is treated as zero, so that it is only evaluated within its
+/// "footprint" (bounding box) in the model image; 0 = evaluate all functions
+/// everywhere (except for intrinsically truncated functions). Applies to all
+/// current functions, and to any added later.
+void ModelObject::SetFootprintFraction( double fraction )
+{
+  footprintFraction = fraction;
+  for (FunctionObject *funcObj : functionObjects)
+    funcObj->SetFootprintFraction(footprintFraction);
+  // cached component images may have been computed with different footprints
+  componentCacheValid = false;
+  frozenImageValid = false;
+}
+
+
+/* ---------------- PUBLIC METHOD: UseComponentCache ------------------- */
+/// Turns on (or off) caching of the individual (non-PointSource) component
+/// images, so that CreateModelImage only recomputes those components whose
+/// parameters have changed since the previous call (e.g., when computing
+/// finite-difference Jacobians, where only one parameter changes at a time).
+/// The summed image of PointSource functions (and other components added after
+/// PSF convolution) is also cached, and only recomputed around changed components.
+/// If the cache would require more than maxCacheBytes of memory, then it is
+/// not used.
+void ModelObject::UseComponentCache( bool useCache, double maxCacheBytes )
+{
+  useComponentCache = useCache;
+  maxComponentCacheBytes = maxCacheBytes;
+  if (! useComponentCache)
+    FreeComponentCache();
+}
+
+
+/* ---------------- PUBLIC METHOD: EstimateComponentCacheMemoryUse ----- */
+/// Returns the number of bytes the component-image cache will use (one image
+/// for each component computed prior to PSF convolution, plus the convolved sum
+/// of those components and the sum of components added after PSF convolution,
+/// if applicable); returns 0 if the
+/// cache is not in use, or would exceed its memory limit (and so will not be
+/// allocated). Must be called after the functions have been added and the model
+/// image size is known.
+long ModelObject::EstimateComponentCacheMemoryUse( )
+{
+  int  nCachedComponents = 0;
+  int  nPostConvolution = 0;
+  double  cacheBytes;
+  
+  if ((! useComponentCache) || (nFunctions == 0) || (nModelVals == 0))
+    return 0;
+  for (int n = 0; n < nFunctions; n++) {
+    if (AddedAfterConvolution(n))
+      nPostConvolution += 1;
+    else
+      nCachedComponents += 1;
+  }
+  cacheBytes = (double)(nCachedComponents + (doConvolution ? 1 : 0) 
+  				+ (nPostConvolution > 0 ? 1 : 0)) * (double)nModelVals * sizeof(double);
+  if (cacheBytes > maxComponentCacheBytes)
+    return 0;
+  return (long)cacheBytes;
+}
+
+
+/* ---------------- PUBLIC METHOD: UseFrozenComponentCache ------------- */
+/// Turns on (or off) use of a pre-computed image for components whose parameters
+/// (including X0,Y0 of their function set) are all fixed. The components are
+/// identified using the parameter info supplied via AddParameterInfo(); the image
+/// of these components (PSF-convolved, if appropriate) is computed on the next call
+/// to CreateModelImage, and is then simply added to subsequent model images.
+/// (If the values of the fixed parameters do change, the image is recomputed.)
+void ModelObject::UseFrozenComponentCache( bool useCache )
+{
+  useFrozenCache = useCache;
+  IdentifyFrozenComponents();
+}
+
+
+/* ---------------- PUBLIC METHOD: UseProfileTables -------------------- */
+/// Turns on (or off) the use of radial-profile lookup tables by those functions
+/// which support them (e.g., Sersic, Exponential); each table extends to the
+/// diagonal size of the model image.
+void ModelObject::UseProfileTables( bool useTables )
+{
+  useProfileTables = useTables;
+  ApplyProfileTables();
+}
+
+
+/* ---------------- PUBLIC METHOD: GetNFrozenComponents ---------------- */
+/// Returns the number of "frozen" components (all parameters fixed) which are
+/// being handled with a pre-computed image (0 if frozen-component caching is off).
+int ModelObject::GetNFrozenComponents( )
+{
+  return nFrozenComponents;
+}
+
+
 /* ---------------- PUBLIC METHOD: AddFunction ------------------------- */
 /// Adds a FunctionObject subclass to the model
 int ModelObject::AddFunction( FunctionObject *newFunctionObj_ptr, bool isGlobalFunc )
@@ -282,9 +499,18 @@ int ModelObject::AddFunction( FunctionObject *newFunctionObj_ptr, bool isGlobalF
   
   functionObjects.push_back(newFunctionObj_ptr);
   nFunctions += 1;
+  if (useProfileTables)
+    ApplyProfileTables();
   nNewParams = newFunctionObj_ptr->GetNParams();
   paramSizes.push_back(nNewParams);
   nFunctionParams += nNewParams;
+  newFunctionObj_ptr->SetFootprintFraction(footprintFraction);
+  // any existing component caches are now out of date (frozen components will
+  // be re-identified when parameter info is added)
+  FreeComponentCache();
+  frozenFunctionFlags.clear();
+  nFrozenComponents = 0;
+  frozenImageValid = false;
   // multimfit-related
   // FIXME: this is just a stub right now (assuming all functions are global)
   globalFunctionFlags.push_back(isGlobalFunc);
@@ -356,13 +582,13 @@ int ModelObject::SetupPsfInterpolation( int interpolationType )
   // the limits for lanczos2 or lanczos3 should be
   if ((nPSFColumns < 4) || (nPSFRows < 4)) {
     fprintf(stderr, "** ERROR: PSF image is too small for interpolation with PointSource functions!\n");
-    fprintf(stderr, "   (must be at least 4 x 4 pixels in size for GSL bicubic interpolation)\n");
+    fprintf(stderr, "   (must be at least 4 x 4 pixels in size for bicubic interpolation)\n");
     return -2;
   }
 
   switch (interpolationType) {
     case kInterpolator_bicubic:
-      psfInterpolator = new PsfInterpolator_bicubic(localPsfPixels, nPSFColumns, nPSFRows);
+      psfInterpolator = new PsfInterpolator_bicubic_native(localPsfPixels, nPSFColumns, nPSFRows);
 	  psfInterpolator_allocated = true;
       break;
     case kInterpolator_lanczos2:
@@ -440,6 +666,7 @@ void ModelObject::AddParameterInfo( mp_par  *inputParameterInfo )
     paramStruct.limits[1] = inputParameterInfo[i].limits[1];
     parameterInfoVect.push_back(paramStruct);
   }
+  IdentifyFrozenComponents();
 }
 
 void ModelObject::AddParameterInfo( vector<mp_par> inputParameterInfo )
@@ -454,6 +681,7 @@ void ModelObject::AddParameterInfo( vector<mp_par> inputParameterInfo )
     paramStruct.limits[1] = inputParameterInfo[i].limits[1];
     parameterInfoVect.push_back(paramStruct);
   }
+  IdentifyFrozenComponents();
 }
 
 
@@ -493,16 +721,31 @@ int ModelObject::SetupModelImage( int nImageColumns, int nImageRows )
   nDataColumns = nImageColumns;
   nDataRows = nImageRows;
   nDataVals = (long)nImageColumns * (long)nImageRows;
+  FreeComponentCache();
+  if (frozenImageAllocated) {
+    free(frozenImage);
+    frozenImageAllocated = false;
+  }
+  frozenImageValid = false;
   
   if (doConvolution) {
     nModelColumns = nDataColumns + 2*nPSFColumns;
     nModelRows = nDataRows + 2*nPSFRows;
+    if ((psfBasisCoeffMaps.size() > 0) && ((nColumns_psfBasisMap != nDataColumns) 
+    		|| (nRows_psfBasisMap != nDataRows))) {
+      fprintf(stderr, "*** ERROR: Dimensions of PSF-basis coefficient maps (%d x %d) do not match\n",
+      		nColumns_psfBasisMap, nRows_psfBasisMap);
+      fprintf(stderr, "    dimensions of data/model image (%d x %d)!\n", nDataColumns, nDataRows);
+      return -1;
+    }
     psfConvolver->SetupImage(nModelColumns, nModelRows);
     result = psfConvolver->DoFullSetup(debugLevel);
     if (result < 0) {
       fprintf(stderr, "*** Error returned from Convolver::DoFullSetup!\n");
       return result;
     }
+    // (nullptr if the Convolver isn't doing double-precision FFT convolution)
+    convolverInputImage = psfConvolver->GetPaddedInputImage(convolverInputStride);
     nModelVals = (long)nModelColumns * (long)nModelRows;
   }
   else {
@@ -523,6 +766,8 @@ int ModelObject::SetupModelImage( int nImageColumns, int nImageRows )
   }
   modelVectorAllocated = true;
   modelImageSetupDone = true;
+  if (useProfileTables)
+    ApplyProfileTables();
   return 0;
 }
 
@@ -856,6 +1101,27 @@ int ModelObject::AddPSFVector( long nPixels_psf, int nColumns_psf, int nRows_psf
     }
     NormalizePSF(localPsfPixels, nPixels_psf);
   }
+  
+  // Sum and centroid of the PSF: convolving a planar (e.g., constant or tilted-plane
+  // background) function with the PSF is the same as multiplying it by the PSF sum
+  // and shifting it by the offset between the PSF centroid and the convolution
+  // center, so such functions can be added after convolution (see CreateModelImage)
+  double  psfSumX = 0.0;
+  double  psfSumY = 0.0;
+  psfFluxScale = 0.0;
+  for (int k = 0; k < nRows_psf; k++) {
+    for (int l = 0; l < nColumns_psf; l++) {
+      pixVal = localPsfPixels[k*nColumns_psf + l];
+      psfFluxScale += pixVal;
+      psfSumX += l*pixVal;
+      psfSumY += k*pixVal;
+    }
+  }
+  bypassBackgroundConvolution = (psfFluxScale > 0.0);
+  if (bypassBackgroundConvolution) {
+    psfShiftX = (nColumns_psf / 2) - psfSumX/psfFluxScale;
+    psfShiftY = (nRows_psf / 2) - psfSumY/psfFluxScale;
+  }
 
   // Finally, set up Convolver object
   nPSFColumns = nColumns_psf;
@@ -865,6 +1131,12 @@ int ModelObject::AddPSFVector( long nPixels_psf, int nColumns_psf, int nRows_psf
 //   printf("ModelObject::AddPSFVector -- calling psfConvolver->SetMaxThreads()");
 //   printf("with maxRequestedThreads = %d\n", maxRequestedThreads);
   psfConvolver->SetMaxThreads(maxRequestedThreads);
+  psfConvolver->SetFFTWPlanning(fftwPlanningMode);
+  psfConvolver->UseFloatConvolution(useFloatConvolution);
+  if (convolutionTileSize > 0) {
+    psfConvolver->SetConvolutionEngine(CONVOLUTION_ENGINE_TILED);
+    psfConvolver->SetTileSize(convolutionTileSize);
+  }
   doConvolution = true;
   
   if (modelImageSetupDone) {
@@ -877,6 +1149,87 @@ int ModelObject::AddPSFVector( long nPixels_psf, int nColumns_psf, int nRows_psf
 
 
 
+/* ---------------- PUBLIC METHOD: AddPSFBasis ------------------------- */
+// Sets up PSF convolution with a spatially varying PSF, given as a set of basis
+// PSF images (all nColumns_psf x nRows_psf) and corresponding coefficient maps 
+// (nColumns_map x nRows_map, the same size as the data image): the PSF for light
+// from pixel (x,y) is sum_k coefficientMaps[k](x,y) * basisPixels[k]. The basis
+// PSFs are not normalized. Outside the data image, the coefficient values from the
+// nearest edge pixel are used.
+// PointSource functions and the PSF sum/centroid use the (normalized) PSF at the 
+// center of the image. Like AddPSFVector(), this must be called *before* 
+// SetupModelImage() is called.
+int ModelObject::AddPSFBasis( vector<double *> basisPixels, int nColumns_psf, int nRows_psf,
+                         vector<double *> coefficientMaps, int nColumns_map, int nRows_map )
+{
+  int  nBasis = (int)basisPixels.size();
+  long  nPixels_psf = (long)nColumns_psf * (long)nRows_psf;
+  long  nPixels_map = (long)nColumns_map * (long)nRows_map;
+  int  status;
+
+  assert( (nBasis >= 1) && (nColumns_psf >= 1) && (nRows_psf >= 1) );
+  assert( (nColumns_map >= 1) && (nRows_map >= 1) );
+  if ((int)coefficientMaps.size() != nBasis) {
+    fprintf(stderr, "** ERROR: Number of PSF-basis coefficient maps (%d) is not the same as ",
+    		(int)coefficientMaps.size());
+    fprintf(stderr, "number of basis PSFs (%d)!\n", nBasis);
+    return -1;
+  }
+  for (int k = 0; k < nBasis; k++) {
+    for (long i = 0; i < nPixels_psf; i++) {
+      if (! isfinite(basisPixels[k][i])) {
+        fprintf(stderr, "** ERROR: Basis PSF image has one or more non-finite values!\n");
+        return -1;
+      }
+    }
+    for (long i = 0; i < nPixels_map; i++) {
+      if (! isfinite(coefficientMaps[k][i])) {
+        fprintf(stderr, "** ERROR: PSF-basis coefficient map has one or more non-finite values!\n");
+        return -1;
+      }
+    }
+  }
+
+  // Use PSF at center of image for setup of Convolver, PointSource functions, etc.
+  long  centerIndex = (long)(nRows_map/2)*nColumns_map + nColumns_map/2;
+  vector<double>  centralPsf(nPixels_psf, 0.0);
+  for (int k = 0; k < nBasis; k++)
+    for (long i = 0; i < nPixels_psf; i++)
+      centralPsf[i] += coefficientMaps[k][centerIndex]*basisPixels[k][i];
+  status = AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, centralPsf.data(), true);
+  if (status < 0)
+    return status;
+  // Convolution of background functions isn't simple if the PSF varies
+  bypassBackgroundConvolution = false;
+
+  // Copy basis PSFs; extend coefficient maps to the size of the model image
+  // (which has nColumns_psf columns and nRows_psf rows of padding on each side)
+  int  nColumns_model = nColumns_map + 2*nColumns_psf;
+  int  nRows_model = nRows_map + 2*nRows_psf;
+  for (int k = 0; k < nBasis; k++) {
+    double  *pixels = (double *) calloc((size_t)nPixels_psf, sizeof(double));
+    for (long i = 0; i < nPixels_psf; i++)
+      pixels[i] = basisPixels[k][i];
+    psfBasisPixels.push_back(pixels);
+    double  *coeffs = (double *) calloc((size_t)nColumns_model*nRows_model, sizeof(double));
+    for (int i = 0; i < nRows_model; i++) {
+      int  iMap = std::min(std::max(i - nRows_psf, 0), nRows_map - 1);
+      for (int j = 0; j < nColumns_model; j++) {
+        int  jMap = std::min(std::max(j - nColumns_psf, 0), nColumns_map - 1);
+        coeffs[(long)i*nColumns_model + j] = coefficientMaps[k][(long)iMap*nColumns_map + jMap];
+      }
+    }
+    psfBasisCoeffMaps.push_back(coeffs);
+  }
+  nColumns_psfBasisMap = nColumns_map;
+  nRows_psfBasisMap = nRows_map;
+  psfConvolver->SetupPSFBasis(psfBasisPixels, nColumns_psf, nRows_psf, psfBasisCoeffMaps);
+
+  return 0;
+}
+
+
+
 /* ---------------- PUBLIC METHOD: AddOversampledPsfInfo --------------- */
 int ModelObject::AddOversampledPsfInfo( PsfOversamplingInfo *oversampledPsfInfo )
 {
@@ -937,6 +1290,9 @@ int ModelObject::AddOversampledPsfInfo( PsfOversamplingInfo *oversampledPsfInfo
   // Allocate OversampledRegion object and give it necessary info
   OversampledRegion *oversampledRegion = new OversampledRegion();
   oversampledRegion->SetDebugLevel(debugLevel);
+  oversampledRegion->SetOMPTiling(ompScheduleType, ompTileRows, ompTileColumns);
+  oversampledRegion->SetFFTWPlanning(fftwPlanningMode);
+  oversampledRegion->UseFloatConvolution(useFloatConvolution);
   oversampledRegion->AddPSFVector(psfPixels_osamp, nPSFColumns_osamp, nPSFRows_osamp,
   									oversampledPsfInfo->GetNormalizationFlag());
   status = oversampledRegion->SetupModelImage(x1, y1, deltaX, deltaY, nModelColumns, nModelRows, 
@@ -1091,6 +1447,14 @@ void ModelObject::SetImageParameters( double imageDescriptionParams[] )
   double rotation = imageDescriptionParams[1];
   double intensityScale = imageDescriptionParams[2];
 
+  if ((pixScale != cachedImageParams[0]) || (rotation != cachedImageParams[1])
+  		|| (intensityScale != cachedImageParams[2])) {
+    componentCacheValid = false;
+    frozenImageValid = false;
+    cachedImageParams[0] = pixScale;
+    cachedImageParams[1] = rotation;
+    cachedImageParams[2] = intensityScale;
+  }
   for (int i = 0; i < nFunctions; i++) {
     if (globalFunctionFlags[i])
       functionObjects[i]->SetImageParameters(pixScale, rotation, intensityScale);
@@ -1102,10 +1466,12 @@ void ModelObject::SetImageParameters( double imageDescriptionParams[] )
 
 void ModelObject::CreateModelImage( double params[] )
 {
-  double  x0, y0, x, y, newValSum;
+  double  x0, y0, y;
   long  i, j;
-  int  n;
+  int  n, k;
   int  offset = 0;
+  int  x0Offset = 0;
+  bool  cacheInUse, frozenInUse;
   
   // Check parameter values for sanity
   if (! CheckParamVector(nParamsTot, params)) {
@@ -1123,105 +1489,353 @@ void ModelObject::CreateModelImage( double params[] )
   // function objects to do setup work.
   // The first component's parameters start at params[0]; the second's start at
   // params[paramSizes[0]], the third at params[paramSizes[0] + paramSizes[1]], and so forth...
+  // If we're caching component images, we also note which components have
+  // parameter values (including x0,y0) different from those used for the cached 
+  // images (including the image of frozen components, if any).
+  // We also note which components are added *after* PSF convolution (PointSource
+  // functions and, if convolving, planar background functions).
+  if ((useComponentCache) && (! componentCacheAllocated))
+    AllocateComponentCache();
+  cacheInUse = componentCacheAllocated;
+  frozenInUse = (nFrozenComponents > 0);
+  vector<bool>  componentChanged(nFunctions, true);
+  vector<bool>  postConvolution(nFunctions, false);
+  bool  postConvolutionPresent = false;
+  bool  cacheWasValid = ((cacheInUse) && (componentCacheValid));
   for (n = 0; n < nFunctions; n++) {
     if (fsetStartFlags[n] == true) {
       // start of new function set: extract x0,y0 and then skip over them
+      x0Offset = offset;
       x0 = params[offset];
       y0 = params[offset + 1];
       offset += 2;
     }
     functionObjects[n]->Setup(params, offset, x0, y0);
+    if ((cacheInUse) && (componentCacheValid))
+      componentChanged[n] = FunctionParamsChanged(n, x0Offset, offset, params, cachedParams);
+    if ((frozenInUse) && (frozenImageValid) && (frozenFunctionFlags[n]))
+      if (FunctionParamsChanged(n, x0Offset, offset, params, frozenParams))
+        frozenImageValid = false;
+    postConvolution[n] = AddedAfterConvolution(n);
+    if ((postConvolution[n]) && (! ((frozenInUse) && (frozenFunctionFlags[n]))))
+      postConvolutionPresent = true;
     offset += paramSizes[n];
   }
+  if (cacheInUse) {
+    for (k = 0; k < nParamsTot; k++)
+      cachedParams[k] = params[k];
+    componentCacheValid = true;
+  }
+  if ((frozenInUse) && (! frozenImageValid)) {
+    frozenParams.assign(params, params + nParamsTot);
+    frozenInUse = (ComputeFrozenImage() == 0);
+    // frozen components (never cached) now have to be computed directly
+    if (! frozenInUse)
+      for (n = 0; n < nFunctions; n++)
+        if (frozenFunctionFlags[n])
+          componentChanged[n] = true;
+  }
+  
+  // If none of the components which are PSF-convolved have changed (e.g., when
+  // only sky parameters vary, as in the sky columns of a Jacobian), then we can
+  // reuse the convolved image from the previous call and skip steps 1 and 2
+  // (if there are no such components, then we skip the convolution step)
+  bool  reuseConvolvedImage = ((cacheWasValid) && (convolvedComponentsImage != nullptr));
+  bool  convolvedComponentsPresent = false;
+  for (n = 0; n < nFunctions; n++) {
+    if ((postConvolution[n]) || ((frozenInUse) && (frozenFunctionFlags[n])))
+      continue;
+    convolvedComponentsPresent = true;
+    if (componentChanged[n])
+      reuseConvolvedImage = false;
+  }
   
   
   // 1. OK, populate modelVector with the model image -- standard pixel scaling
-  double  tempSum, adjVal, storedError;
-  
+  // The image is divided into tiles (blocks of rows and columns), which are
+  // assigned to threads dynamically (by default), since pixels near component
+  // centers (with subsampling) are much more expensive than other pixels.
+  // Within each tile, we work row by row, asking each function object for a row
+  // of values at a time (via GetValues) and accumulating them into the model
+  // image with per-pixel Kahan summation; each thread gets its own row buffers.
+  // Each function is only evaluated within its footprint (the whole image,
+  // unless the function is truncated or a footprint fraction has been set).
+  // If the component cache is in use, each function's values are stored in
+  // its cached image, and unchanged functions simply reuse their cached values.
+  // Components which are added after PSF convolution are skipped here.
+  // If we're doing (double-precision) FFT convolution, the image is written
+  // directly into the Convolver's zero-padded FFT input array, rather than into
+  // modelVector, which saves copying it there (the convolved image is then
+  // written into modelVector).
+  double  tempSum, adjVal;
+  double  *rowVals, *rowErrors, *modelRow, *valuesRow;
+  long  t, jStart, jEnd, nCols, iTileStart, iTileEnd, jTileStart, jTileEnd;
+  // Iraf counting: first column = 1 (note that nPSFColumns = 0 if not doing 
+  // PSF convolution)
+  double  xStart = (double)(1 - nPSFColumns);
+  vector<long>  iStartVect(nFunctions), iEndVect(nFunctions);
+  vector<long>  jStartVect(nFunctions), jEndVect(nFunctions);
+  for (n = 0; n < nFunctions; n++)
+    GetFootprintLimits(n, iStartVect[n], iEndVect[n], jStartVect[n], jEndVect[n]);
+  ImageTiles  modelTiles(nModelRows, nModelColumns, ompTileRows, ompTileColumns);
+  long  nTiles = modelTiles.GetNTiles();
+  long  nTileColumns = modelTiles.GetMaxTileColumns();
+  SetOMPTileSchedule(ompScheduleType);
+  double  *renderImage = modelVector;
+  long  renderStride = nModelColumns;
+  if ((doConvolution) && (convolvedComponentsPresent) && (convolverInputImage != nullptr)) {
+    renderImage = convolverInputImage;
+    renderStride = convolverInputStride;
+  }
+  
+  if (reuseConvolvedImage) {
+#pragma omp parallel for private(j) schedule (static, ompChunkSize)
+    for (j = 0; j < nModelVals; j++)
+      modelVector[j] = convolvedComponentsImage[j];
+  }
+  else {
 // Note that we cannot specify modelVector as shared [or private] bcs it is part
 // of a class (not an independent variable); happily, by default all references in
 // an omp-parallel section are shared unless specified otherwise
-#pragma omp parallel private(i,j,n,x,y,newValSum,tempSum,adjVal,storedError)
-  {
-  #pragma omp for schedule (static, ompChunkSize)
-//   for (i = 0; i < nModelRows; i++) {   // step by row number = y
-//     y = (double)(i - nPSFRows + 1);              // Iraf counting: first row = 1 
-//                                                  // (note that nPSFRows = 0 if not doing PSF convolution)
-//     for (j = 0; j < nModelColumns; j++) {   // step by column number = x
-//       x = (double)(j - nPSFColumns + 1);                 // Iraf counting: first column = 1
-//                                                          // (note that nPSFColumns = 0 if not doing PSF convolution)
-  // single-loop code which is ~ same in general case as double-loop, and
-  // faster for case of small image + many cores (André Luiz de Amorim suggestion)
-  for (long k = 0; k < nModelVals; k++) {
-    j = k % nModelColumns;
-    i = k / nModelColumns;
-    y = (double)(i - nPSFRows + 1);              // Iraf counting: first row = 1
-                                                 // (note that nPSFRows = 0 if not doing PSF convolution)
-    x = (double)(j - nPSFColumns + 1);           // Iraf counting: first column = 1
-                                                 // (note that nPSFColumns = 0 if not doing PSF convolution)
-    newValSum = 0.0;
-    storedError = 0.0;
-    for (n = 0; n < nFunctions; n++) {
-      if (! functionObjects[n]->IsPointSource()) {
-        // Kahan summation algorithm
-        adjVal = functionObjects[n]->GetValue(x, y) - storedError;
-        tempSum = newValSum + adjVal;
-        storedError = (tempSum - newValSum) - adjVal;
-        newValSum = tempSum;
+#pragma omp parallel private(t,i,j,n,y,tempSum,adjVal,rowVals,rowErrors,modelRow,valuesRow,jStart,jEnd,nCols,iTileStart,iTileEnd,jTileStart,jTileEnd)
+    {
+    rowVals = (double *)calloc((size_t)nTileColumns, sizeof(double));
+    rowErrors = (double *)calloc((size_t)nTileColumns, sizeof(double));
+    #pragma omp for schedule (runtime)
+    for (t = 0; t < nTiles; t++) {
+      modelTiles.GetTileLimits(t, iTileStart, iTileEnd, jTileStart, jTileEnd);
+      for (i = iTileStart; i < iTileEnd; i++) {   // step by row number = y
+        y = (double)(i - nPSFRows + 1);              // Iraf counting: first row = 1
+                                                     // (note that nPSFRows = 0 if not doing PSF convolution)
+        // modelRow and rowErrors both start at first column of the tile
+        modelRow = renderImage + i*renderStride + jTileStart;
+        for (j = 0; j < jTileEnd - jTileStart; j++) {
+          modelRow[j] = 0.0;
+          rowErrors[j] = 0.0;
+        }
+        for (n = 0; n < nFunctions; n++) {
+          if ((frozenInUse) && (frozenFunctionFlags[n]))
+            continue;
+          if ((postConvolution[n]) || (i < iStartVect[n]) || (i >= iEndVect[n]))
+            continue;
+          // restrict to overlap of function footprint and tile (relative to tile)
+          jStart = max(jStartVect[n], jTileStart) - jTileStart;
+          jEnd = min(jEndVect[n], jTileEnd) - jTileStart;
+          nCols = jEnd - jStart;
+          if (nCols <= 0)
+            continue;
+          if (cacheInUse) {
+            valuesRow = componentImages + componentCacheIndices[n]*nModelVals
+            				+ i*nModelColumns + jTileStart + jStart;
+            if (componentChanged[n])
+              functionObjects[n]->GetValues(y, xStart + jTileStart + jStart, 1.0, nCols, 
+              								valuesRow);
+          }
+          else {
+            valuesRow = rowVals;
+            functionObjects[n]->GetValues(y, xStart + jTileStart + jStart, 1.0, nCols, 
+            								rowVals);
+          }
+          // Kahan summation algorithm
+          for (j = 0; j < nCols; j++) {
+            adjVal = valuesRow[j] - rowErrors[jStart + j];
+            tempSum = modelRow[jStart + j] + adjVal;
+            rowErrors[jStart + j] = (tempSum - modelRow[jStart + j]) - adjVal;
+            modelRow[jStart + j] = tempSum;
+          }
+        }
       }
     }
-    modelVector[i*nModelColumns + j] = newValSum;
-  }
-  } // end omp parallel section
+    free(rowVals);
+    free(rowErrors);
+    } // end omp parallel section
   
   
-  // 2. Do PSF convolution (using standard pixel scale), if requested
-  if (doConvolution)
-    psfConvolver->ConvolveImage(modelVector);
+    // 2. Do PSF convolution (using standard pixel scale), if requested; store a
+    // copy of the convolved image, if we're caching component images
+    if (doConvolution) {
+      if (renderImage != modelVector)
+        psfConvolver->ConvolvePaddedImage(modelVector);
+      else if (convolvedComponentsPresent)
+        psfConvolver->ConvolveImage(modelVector);
+      if (convolvedComponentsImage != nullptr) {
+#pragma omp parallel for private(j) schedule (static, ompChunkSize)
+        for (j = 0; j < nModelVals; j++)
+          convolvedComponentsImage[j] = modelVector[j];
+      }
+    }
+  }
   
   
-  // 2.B Add flux from PointSource functions, if present 
-  // (must be done *after* PSF convolution!)
-  if (pointSourcesPresent) {
+  // 2.B Add flux from PointSource functions, if present, and from planar background
+  // functions, if we're doing PSF convolution (must be done *after* PSF convolution!).
+  // Convolving a planar function with the PSF multiplies it by the PSF sum and
+  // shifts it by the offset between the PSF centroid and center, so we evaluate
+  // such functions at shifted positions instead of convolving them.
+  if (postConvolutionPresent) {
     // Re-assign psfInterpolator object (bcs. calls made to
-    // OversampledRegion::ComputeRegionAndDownsample result in PointSource objects 
+    // OversampledRegion::AddPointSourcesAndDownsample result in PointSource objects 
     // getting assigned alternate psfInterpolators), so we have to reset PointSource 
     // objects to use the standard-resolution psfInterpolator object held by ModelObject
-    for (FunctionObject *funcObj : functionObjects)
-      if (funcObj->IsPointSource())
-        funcObj->AddPsfInterpolator(psfInterpolator);
+    // (and to use the standard pixel scale). Point sources are then only evaluated 
+    // within their footprints (the region covered by the PSF image), and the parts
+    // of rows which aren't covered by any point source or background are skipped.
+    if (pointSourcesPresent)
+      for (n = 0; n < nFunctions; n++)
+        if (functionObjects[n]->IsPointSource()) {
+          functionObjects[n]->AddPsfInterpolator(psfInterpolator);
+          functionObjects[n]->SetOversamplingScale(1);
+          GetFootprintLimits(n, iStartVect[n], iEndVect[n], jStartVect[n], jEndVect[n]);
+        }
     
-#pragma omp parallel private(i,j,n,x,y,newValSum,tempSum,adjVal,storedError)
+    // Each function is assigned to the tiles which its footprint overlaps, so that
+    // each tile only has to deal with the functions overlapping it (important for
+    // crowded fields with hundreds or thousands of point sources). Each tile is
+    // still computed by a single thread, so there are no write conflicts.
+    // If the component cache is in use, the sum of these functions is also stored
+    // (in postConvolutionImage), and only those tiles are recomputed which are 
+    // overlapped by functions whose parameters have changed, or whose set of 
+    // overlapping functions has changed (e.g., because a point source has moved).
+    // So for the finite-difference Jacobian of one star's parameters, only the
+    // tiles around that star are recomputed.
+    vector< vector<int> >  tileFunctions(nTiles);
+    vector<long>  overlappingTiles;
+    vector<bool>  pointSourceFlags(nFunctions, false);
+    for (n = 0; n < nFunctions; n++) {
+      if ((! postConvolution[n]) || ((frozenInUse) && (frozenFunctionFlags[n])))
+        continue;
+      pointSourceFlags[n] = functionObjects[n]->IsPointSource();
+      overlappingTiles.clear();
+      modelTiles.GetOverlappingTiles(iStartVect[n], iEndVect[n], jStartVect[n], jEndVect[n],
+      								overlappingTiles);
+      for (long tileNumber : overlappingTiles)
+        tileFunctions[tileNumber].push_back(n);
+    }
+    bool  postCacheInUse = ((cacheInUse) && (postConvolutionImage != nullptr));
+    vector<bool>  tileChanged(nTiles, true);
+    if ((postCacheInUse) && (cacheWasValid) && (postConvolutionCacheValid)
+    		&& ((long)cachedTileFunctions.size() == nTiles)) {
+      for (t = 0; t < nTiles; t++) {
+        tileChanged[t] = (tileFunctions[t] != cachedTileFunctions[t]);
+        for (int nn : tileFunctions[t])
+          if (componentChanged[nn])
+            tileChanged[t] = true;
+      }
+    }
+    
+#pragma omp parallel private(t,i,j,n,y,tempSum,adjVal,rowVals,rowErrors,modelRow,jStart,jEnd,nCols,iTileStart,iTileEnd,jTileStart,jTileEnd)
     {
-    #pragma omp for schedule (static, ompChunkSize)
-    for (long k = 0; k < nModelVals; k++) {
-      j = k % nModelColumns;
-      i = k / nModelColumns;
-      y = (double)(i - nPSFRows + 1);              // Iraf counting: first row = 1
-                                                   // (note that nPSFRows = 0 if not doing PSF convolution)
-      x = (double)(j - nPSFColumns + 1);           // Iraf counting: first column = 1
-                                                   // (note that nPSFColumns = 0 if not doing PSF convolution)
-      newValSum = 0.0;
-      storedError = 0.0;
-      for (n = 0; n < nFunctions; n++) {
-        // Use Kahan summation algorithm
-        if (functionObjects[n]->IsPointSource()) {
-          adjVal = functionObjects[n]->GetValue(x, y) - storedError;
-          tempSum = newValSum + adjVal;
-          storedError = (tempSum - newValSum) - adjVal;
-          newValSum = tempSum;
+    rowVals = (double *)calloc((size_t)nTileColumns, sizeof(double));
+    rowErrors = (double *)calloc((size_t)nTileColumns, sizeof(double));
+    double  *rowSums = (double *)calloc((size_t)nTileColumns, sizeof(double));
+    double  *cachedRow = nullptr;
+    long  rowStart, rowEnd;
+    #pragma omp for schedule (runtime)
+    for (t = 0; t < nTiles; t++) {
+      // (tiles without any functions only need their cached values zeroed, if
+      // they previously had some functions)
+      if ((tileFunctions[t].empty()) && (! ((postCacheInUse) && (tileChanged[t]))))
+        continue;
+      modelTiles.GetTileLimits(t, iTileStart, iTileEnd, jTileStart, jTileEnd);
+      for (i = iTileStart; i < iTileEnd; i++) {   // step by row number = y
+        y = (double)(i - nPSFRows + 1);              // Iraf counting: first row = 1
+                                                     // (note that nPSFRows = 0 if not doing PSF convolution)
+        modelRow = modelVector + i*nModelColumns + jTileStart;
+        if (postCacheInUse)
+          cachedRow = postConvolutionImage + i*nModelColumns + jTileStart;
+        if (tileChanged[t]) {
+          if (postCacheInUse)
+            for (j = 0; j < jTileEnd - jTileStart; j++)
+              cachedRow[j] = 0.0;
+          // find the part of this row (relative to the tile) covered by at least 
+          // one function's footprint
+          rowStart = jTileEnd - jTileStart;
+          rowEnd = 0;
+          for (int nn : tileFunctions[t]) {
+            if ((i < iStartVect[nn]) || (i >= iEndVect[nn]))
+              continue;
+            rowStart = min(rowStart, max(jStartVect[nn], jTileStart) - jTileStart);
+            rowEnd = max(rowEnd, min(jEndVect[nn], jTileEnd) - jTileStart);
+          }
+          for (j = rowStart; j < rowEnd; j++) {
+            rowSums[j] = 0.0;
+            rowErrors[j] = 0.0;
+          }
+          for (int nn : tileFunctions[t]) {
+            if ((i < iStartVect[nn]) || (i >= iEndVect[nn]))
+              continue;
+            // restrict to overlap of function footprint and tile (relative to tile)
+            jStart = max(jStartVect[nn], jTileStart) - jTileStart;
+            jEnd = min(jEndVect[nn], jTileEnd) - jTileStart;
+            nCols = jEnd - jStart;
+            if (nCols <= 0)
+              continue;
+            if (pointSourceFlags[nn])
+              functionObjects[nn]->GetValues(y, xStart + jTileStart + jStart, 1.0, nCols, 
+              								rowVals);
+            else {
+              functionObjects[nn]->GetValues(y + psfShiftY, xStart + jTileStart + jStart + psfShiftX, 
+              								1.0, nCols, rowVals);
+              for (j = 0; j < nCols; j++)
+                rowVals[j] *= psfFluxScale;
+            }
+            // Use Kahan summation algorithm
+            for (j = 0; j < nCols; j++) {
+              adjVal = rowVals[j] - rowErrors[jStart + j];
+              tempSum = rowSums[jStart + j] + adjVal;
+              rowErrors[jStart + j] = (tempSum - rowSums[jStart + j]) - adjVal;
+              rowSums[jStart + j] = tempSum;
+            }
+          }
+          if (postCacheInUse)
+            for (j = rowStart; j < rowEnd; j++)
+              cachedRow[j] = rowSums[j];
+          else
+            for (j = rowStart; j < rowEnd; j++)
+              modelRow[j] += rowSums[j];
         }
+        if ((postCacheInUse) && (! tileFunctions[t].empty()))
+          for (j = 0; j < jTileEnd - jTileStart; j++)
+            modelRow[j] += cachedRow[j];
       }
-      modelVector[i*nModelColumns + j] += newValSum;
     }
+    free(rowVals);
+    free(rowErrors);
+    free(rowSums);
     } // end omp parallel section
+    
+    if (postCacheInUse) {
+      cachedTileFunctions.swap(tileFunctions);
+      postConvolutionCacheValid = true;
+    }
   }
+  else
+    postConvolutionCacheValid = false;
   
   
-  // 3. Optional generation of oversampled sub-image and convolution with oversampled PSF
-  if (oversampledRegionsExist)
+  // 2.C Add pre-computed (and pre-convolved) image of frozen components, if any
+  if (frozenInUse) {
+#pragma omp parallel for private(j) schedule (static, ompChunkSize)
+    for (j = 0; j < nModelVals; j++)
+      modelVector[j] += frozenImage[j];
+  }
+  
+  
+  // 3. Optional generation of oversampled sub-image and convolution with oversampled PSF.
+  // Oversampled regions are usually small, so OpenMP parallelization *within* each
+  // region is inefficient; if there are several regions, they are instead computed
+  // (and convolved) concurrently, one region per thread. Since adding PointSource
+  // flux resets the PointSources' PSF interpolators, and since regions can overlap,
+  // PointSources and downsampling into the main image are then done serially, in 
+  // the order the regions were added.
+  if (oversampledRegionsExist) {
+#pragma omp parallel for private(n) schedule (dynamic, 1) if (nOversampledRegions > 1)
+    for (n = 0; n < nOversampledRegions; n++)
+      oversampledRegionsVect[n]->ComputeRegion(functionObjects, nFunctions);
     for (n = 0; n < nOversampledRegions; n++)
-      oversampledRegionsVect[n]->ComputeRegionAndDownsample(modelVector, functionObjects, nFunctions);
+      oversampledRegionsVect[n]->AddPointSourcesAndDownsample(modelVector, functionObjects, 
+      												nFunctions);
+  }
   
   // [4. Possible location for charge-diffusion and other post-pixelization processing]
   
@@ -1240,7 +1854,7 @@ void ModelObject::CreateModelImage( double params[] )
 // unless you are aware that it will NOT return the full (expanded) model image.)
 double * ModelObject::GetSingleFunctionImage( double params[], int functionIndex )
 {
-  double  x0, y0, x, y, newVal;
+  double  x0, y0, y;
   int  offset = 0;
   int  iDataRow, iDataCol;
   long  i, j, z, zModel;
@@ -1277,29 +1891,43 @@ double * ModelObject::GetSingleFunctionImage( double params[], int functionIndex
   
   // If requested function is PointSource, re-assign the PsfInterpolator object
   // (see comments in CreateModelImage for why we need to do this)
-  if (functionObjects[functionIndex]->IsPointSource())
+  if (functionObjects[functionIndex]->IsPointSource()) {
     functionObjects[functionIndex]->AddPsfInterpolator(psfInterpolator);
+    functionObjects[functionIndex]->SetOversamplingScale(1);
+  }
 
   // 1. OK, populate modelVector with the model image -- standard pixel scaling
   // OpenMP Parallel section; see CreateModelImage() for general notes on this
   // Note that since we expect this code to be called only occasionally, we have
   // not converted it to the fast-for-small-images, single-loop version used in
   // CreateModelImages()
-#pragma omp parallel private(i,j,x,y,newVal)
+  // Planar background functions are evaluated at PSF-centroid-shifted positions
+  // and scaled by the PSF sum in place of PSF convolution
+  double  xStart = (double)(1 - nPSFColumns);   // Iraf counting: first column = 1
+  double  yShift = 0.0;
+  double  scale = 1.0;
+  bool  postConvolution = AddedAfterConvolution(functionIndex);
+  if ((postConvolution) && (! functionObjects[functionIndex]->IsPointSource())) {
+    xStart += psfShiftX;
+    yShift = psfShiftY;
+    scale = psfFluxScale;
+  }
+#pragma omp parallel private(i,j,y)
   {
   #pragma omp for schedule (static, ompChunkSize)
   for (i = 0; i < nModelRows; i++) {   // step by row number = y
     y = (double)(i - nPSFRows + 1);              // Iraf counting: first row = 1
-    for (j = 0; j < nModelColumns; j++) {   // step by column number = x
-      x = (double)(j - nPSFColumns + 1);                 // Iraf counting: first column = 1
-      newVal = functionObjects[functionIndex]->GetValue(x, y);
-      modelVector[i*nModelColumns + j] = newVal;
-    }
+    functionObjects[functionIndex]->GetValues(y + yShift, xStart, 1.0, nModelColumns, 
+    											modelVector + i*nModelColumns);
+    if (scale != 1.0)
+      for (j = 0; j < nModelColumns; j++)
+        modelVector[i*nModelColumns + j] *= scale;
   }
   } // end omp parallel section
   
-  // 2. Do PSF convolution, if requested and if this is *not* a PointSource function
-  if ((doConvolution) && (! functionObjects[functionIndex]->IsPointSource()))
+  // 2. Do PSF convolution, if requested and if this is *not* a PointSource or
+  // planar background function
+  if ((doConvolution) && (! postConvolution))
     psfConvolver->ConvolveImage(modelVector);
 
   // 3. Optional generation of oversampled sub-image and convolution with oversampled PSF
@@ -2242,6 +2870,17 @@ bool ModelObject::HasOversampledPSF( )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetConvolutionEngineName ----------- */
+/// Returns the name of the method used for PSF convolution of the main model
+/// image ("FFT", "direct", or "separable"), or "none" if there is no PSF.
+string ModelObject::GetConvolutionEngineName( )
+{
+  if (! doConvolution)
+    return string("none");
+  return psfConvolver->GetConvolutionEngineName();
+}
+
+
 /* ---------------- PUBLIC METHOD: HasMask ----------------------------- */
 /// Returns true if a mask image exists.
 bool ModelObject::HasMask( )
@@ -2415,8 +3054,9 @@ string ModelObject::GetDataFilename( )
 double ModelObject::FindTotalFluxes( double params[], int xSize, int ySize,
                        double individualFluxes[] )
 {
-  double  x0_all, y0_all, x, y;
+  double  x0_all, y0_all, y;
   double  totalModelFlux, totalComponentFlux;
+  double  *rowVals;
   int  i, j, n;
   int  offset = 0;
 
@@ -2455,16 +3095,18 @@ double ModelObject::FindTotalFluxes( double params[], int xSize, int ySize,
           printf("\tUsing %s.TotalFlux() method...\n", functionObjects[n]->GetShortName().c_str());
       } else {
         totalComponentFlux = 0.0;
-        #pragma omp parallel private(i,j,x,y) reduction(+:totalComponentFlux)
+        #pragma omp parallel private(i,j,y,rowVals) reduction(+:totalComponentFlux)
         {
+        rowVals = (double *)calloc((size_t)xSize, sizeof(double));
         #pragma omp for schedule (static, ompChunkSize)
         for (i = 0; i < ySize; i++) {   // step by row number = y
           y = (double)(i + 1);              // Iraf counting: first row = 1
-          for (j = 0; j < xSize; j++) {   // step by column number = x
-            x = (double)(j + 1);                 // Iraf counting: first column = 1
-            totalComponentFlux += functionObjects[n]->GetValue(x, y);
-          }
+          // Iraf counting: first column = 1
+          functionObjects[n]->GetValues(y, 1.0, 1.0, xSize, rowVals);
+          for (j = 0; j < xSize; j++)
+            totalComponentFlux += rowVals[j];
         }
+        free(rowVals);
         } // end omp parallel section
       } // end else [integrate total flux for component]
       individualFluxes[n] = totalComponentFlux;
@@ -2490,6 +3132,299 @@ bool ModelObject::CheckParamVector( int nParams, double paramVector[] )
 }
 
 
+/* ---------------- PROTECTED METHOD: GetFootprintLimits --------------- */
+/// Converts the footprint of function n (if it has one) into a range of rows
+/// [iStart, iEnd) and columns [jStart, jEnd) within the model image; if the
+/// function has no footprint, the ranges cover the entire model image.
+/// The ranges are padded by one pixel on each side to allow for pixel
+/// subsampling near the edge of the footprint.
+void ModelObject::GetFootprintLimits( int n, long& iStart, long& iEnd, long& jStart,
+										long& jEnd )
+{
+  double  xMin, xMax, yMin, yMax;
+  double  jLow, jHigh, iLow, iHigh;
+  
+  iStart = jStart = 0;
+  iEnd = nModelRows;
+  jEnd = nModelColumns;
+  if (! functionObjects[n]->GetFootprint(xMin, xMax, yMin, yMax))
+    return;
+  
+  // column j <--> x = j - nPSFColumns + 1; row i <--> y = i - nPSFRows + 1
+  // (comparisons are done in floating point to avoid overflow for very large footprints)
+  jLow = floor(xMin) + nPSFColumns - 2;
+  jHigh = ceil(xMax) + nPSFColumns + 1;
+  iLow = floor(yMin) + nPSFRows - 2;
+  iHigh = ceil(yMax) + nPSFRows + 1;
+  if (jLow > 0)
+    jStart = (jLow < nModelColumns) ? (long)jLow : nModelColumns;
+  if (jHigh < nModelColumns)
+    jEnd = (jHigh > jStart) ? (long)jHigh : jStart;
+  if (iLow > 0)
+    iStart = (iLow < nModelRows) ? (long)iLow : nModelRows;
+  if (iHigh < nModelRows)
+    iEnd = (iHigh > iStart) ? (long)iHigh : iStart;
+}
+
+
+/* ---------------- PROTECTED METHOD: AddedAfterConvolution ------------ */
+/// Returns true if function n is added to the model image after PSF convolution
+/// instead of being convolved: PointSource functions (always), and planar
+/// background functions (e.g., FlatSky, TiltedSkyPlane) if we're doing PSF
+/// convolution, since their convolved images are just shifted copies.
+bool ModelObject::AddedAfterConvolution( int n )
+{
+  if (functionObjects[n]->IsPointSource())
+    return true;
+  return ((doConvolution) && (bypassBackgroundConvolution)
+  		&& (functionObjects[n]->IsBackground()) && (functionObjects[n]->IsPlanar()));
+}
+
+
+/* ---------------- PROTECTED METHOD: AllocateComponentCache ----------- */
+/// Allocates memory for the per-component image cache (one image for each
+/// function which is not added after PSF convolution, plus -- if we're doing
+/// PSF convolution -- one image for the convolved sum of those components, 
+/// plus one image for the sum of the functions which *are* added after PSF
+/// convolution, if there are any).
+/// Returns -1 (and turns off use of the cache) if the required memory would
+/// exceed the current limit, or if the allocation fails; otherwise returns 0.
+int ModelObject::AllocateComponentCache( )
+{
+  int  nCachedComponents = 0;
+  int  nPostConvolution = 0;
+  double  cacheBytes;
+  bool  allocationFailed;
+  
+  componentCacheIndices.assign(nFunctions, -1);
+  for (int n = 0; n < nFunctions; n++) {
+    if (! AddedAfterConvolution(n)) {
+      componentCacheIndices[n] = nCachedComponents;
+      nCachedComponents += 1;
+    }
+    else
+      nPostConvolution += 1;
+  }
+  cacheBytes = (double)(nCachedComponents + (doConvolution ? 1 : 0) 
+  				+ (nPostConvolution > 0 ? 1 : 0)) * (double)nModelVals * sizeof(double);
+  if ((nFunctions == 0) || (nModelVals == 0) || (cacheBytes > maxComponentCacheBytes)) {
+    if ((nFunctions > 0) && (verboseLevel > 0))
+      printf("ModelObject: component-image cache would require %.2f GB; not using it.\n",
+      			cacheBytes / GIGABYTE);
+    useComponentCache = false;
+    return -1;
+  }
+  
+  if (nCachedComponents > 0)
+    componentImages = (double *)calloc((size_t)nCachedComponents*nModelVals, sizeof(double));
+  if (doConvolution)
+    convolvedComponentsImage = (double *)calloc((size_t)nModelVals, sizeof(double));
+  if (nPostConvolution > 0)
+    postConvolutionImage = (double *)calloc((size_t)nModelVals, sizeof(double));
+  allocationFailed = (((nCachedComponents > 0) && (componentImages == nullptr))
+  					|| ((doConvolution) && (convolvedComponentsImage == nullptr))
+  					|| ((nPostConvolution > 0) && (postConvolutionImage == nullptr)));
+  if (allocationFailed) {
+    fprintf(stderr, "*** WARNING: Unable to allocate memory for component-image cache!\n");
+    free(componentImages);
+    free(convolvedComponentsImage);
+    free(postConvolutionImage);
+    componentImages = convolvedComponentsImage = postConvolutionImage = nullptr;
+    useComponentCache = false;
+    return -1;
+  }
+  cachedParams.assign(nParamsTot, 0.0);
+  componentCacheAllocated = true;
+  componentCacheValid = false;
+  return 0;
+}
+
+
+/* ---------------- PROTECTED METHOD: FreeComponentCache --------------- */
+/// Frees the memory used by the per-component image cache (if any); the cache
+/// will be re-allocated on the next call to CreateModelImage, if still in use.
+void ModelObject::FreeComponentCache( )
+{
+  if (componentCacheAllocated) {
+    free(componentImages);
+    free(convolvedComponentsImage);
+    free(postConvolutionImage);
+    componentImages = convolvedComponentsImage = postConvolutionImage = nullptr;
+    componentCacheAllocated = false;
+  }
+  componentCacheValid = false;
+  postConvolutionCacheValid = false;
+  cachedTileFunctions.clear();
+}
+
+
+/* ---------------- PROTECTED METHOD: FunctionParamsChanged ------------ */
+/// Returns true if any of the parameters for function n -- including the X0,Y0
+/// values for its function set, which start at params[x0Offset] -- differ from
+/// the corresponding values in oldParams.
+bool ModelObject::FunctionParamsChanged( int n, int x0Offset, int paramOffset, 
+										double params[], vector<double>& oldParams )
+{
+  if ((params[x0Offset] != oldParams[x0Offset]) 
+  		|| (params[x0Offset + 1] != oldParams[x0Offset + 1]))
+    return true;
+  for (int k = paramOffset; k < paramOffset + paramSizes[n]; k++)
+    if (params[k] != oldParams[k])
+      return true;
+  return false;
+}
+
+
+/* ---------------- PROTECTED METHOD: IdentifyFrozenComponents --------- */
+/// Uses the parameter info (if any) to identify "frozen" components: those for
+/// which all parameters, *and* the X0,Y0 of the corresponding function set, 
+/// are fixed.
+void ModelObject::IdentifyFrozenComponents( )
+{
+  int  offset = 0;
+  int  x0Offset = 0;
+  bool  frozen;
+  
+  frozenFunctionFlags.assign(nFunctions, false);
+  nFrozenComponents = 0;
+  frozenImageValid = false;
+  // cached images of previously frozen components were never computed
+  componentCacheValid = false;
+  if ((! useFrozenCache) || (! fsetStartFlags_allocated) || (nParamsTot == 0)
+  		|| ((int)parameterInfoVect.size() < nParamsTot))
+    return;
+  
+  for (int n = 0; n < nFunctions; n++) {
+    if (fsetStartFlags[n] == true) {
+      x0Offset = offset;
+      offset += 2;
+    }
+    frozen = ((parameterInfoVect[x0Offset].fixed == 1) 
+    			&& (parameterInfoVect[x0Offset + 1].fixed == 1));
+    for (int k = offset; k < offset + paramSizes[n]; k++)
+      if (parameterInfoVect[k].fixed != 1)
+        frozen = false;
+    if (frozen) {
+      frozenFunctionFlags[n] = true;
+      nFrozenComponents += 1;
+    }
+    offset += paramSizes[n];
+  }
+}
+
+
+/* ---------------- PROTECTED METHOD: ComputeFrozenImage --------------- */
+/// Computes the image of the frozen components (using their current setup),
+/// including PSF convolution (if being done) and any PointSource functions, 
+/// and stores it in frozenImage. Returns 0 on success, or -1 if memory for the 
+/// image could not be allocated (in which case use of the frozen-component 
+/// cache is turned off).
+int ModelObject::ComputeFrozenImage( )
+{
+  long  i, j;
+  int  n;
+  double  y, tempSum, adjVal;
+  double  *rowVals, *rowErrors, *imageRow;
+  double  xStart = (double)(1 - nPSFColumns);
+  
+  if (! frozenImageAllocated) {
+    frozenImage = (double *)calloc((size_t)nModelVals, sizeof(double));
+    if (frozenImage == nullptr) {
+      fprintf(stderr, "*** WARNING: Unable to allocate memory for frozen-component image!\n");
+      useFrozenCache = false;
+      IdentifyFrozenComponents();
+      return -1;
+    }
+    frozenImageAllocated = true;
+  }
+  
+  // 1. Extended (non-PointSource) components, followed by PSF convolution
+#pragma omp parallel private(i,j,n,y,tempSum,adjVal,rowVals,rowErrors,imageRow)
+  {
+  rowVals = (double *)calloc((size_t)nModelColumns, sizeof(double));
+  rowErrors = (double *)calloc((size_t)nModelColumns, sizeof(double));
+  #pragma omp for schedule (static, ompChunkSize)
+  for (i = 0; i < nModelRows; i++) {
+    y = (double)(i - nPSFRows + 1);
+    imageRow = frozenImage + i*nModelColumns;
+    for (j = 0; j < nModelColumns; j++) {
+      imageRow[j] = 0.0;
+      rowErrors[j] = 0.0;
+    }
+    for (n = 0; n < nFunctions; n++) {
+      if ((frozenFunctionFlags[n]) && (! functionObjects[n]->IsPointSource())) {
+        functionObjects[n]->GetValues(y, xStart, 1.0, nModelColumns, rowVals);
+        // Kahan summation algorithm
+        for (j = 0; j < nModelColumns; j++) {
+          adjVal = rowVals[j] - rowErrors[j];
+          tempSum = imageRow[j] + adjVal;
+          rowErrors[j] = (tempSum - imageRow[j]) - adjVal;
+          imageRow[j] = tempSum;
+        }
+      }
+    }
+  }
+  free(rowVals);
+  free(rowErrors);
+  } // end omp parallel section
+  
+  if (doConvolution)
+    psfConvolver->ConvolveImage(frozenImage);
+  
+  // 2. PointSource components (added after PSF convolution), evaluated only
+  // within their footprints
+  if (pointSourcesPresent) {
+    vector<long>  iStartVect(nFunctions), iEndVect(nFunctions);
+    vector<long>  jStartVect(nFunctions), jEndVect(nFunctions);
+    for (n = 0; n < nFunctions; n++)
+      if (functionObjects[n]->IsPointSource()) {
+        functionObjects[n]->AddPsfInterpolator(psfInterpolator);
+        functionObjects[n]->SetOversamplingScale(1);
+        GetFootprintLimits(n, iStartVect[n], iEndVect[n], jStartVect[n], jEndVect[n]);
+      }
+#pragma omp parallel private(i,j,n,y,rowVals,imageRow)
+    {
+    rowVals = (double *)calloc((size_t)nModelColumns, sizeof(double));
+    #pragma omp for schedule (static, ompChunkSize)
+    for (i = 0; i < nModelRows; i++) {
+      y = (double)(i - nPSFRows + 1);
+      imageRow = frozenImage + i*nModelColumns;
+      for (n = 0; n < nFunctions; n++) {
+        if ((frozenFunctionFlags[n]) && (functionObjects[n]->IsPointSource())) {
+          long  nCols = jEndVect[n] - jStartVect[n];
+          if ((i < iStartVect[n]) || (i >= iEndVect[n]) || (nCols <= 0))
+            continue;
+          functionObjects[n]->GetValues(y, xStart + jStartVect[n], 1.0, nCols, rowVals);
+          for (j = 0; j < nCols; j++)
+            imageRow[jStartVect[n] + j] += rowVals[j];
+        }
+      }
+    }
+    free(rowVals);
+    } // end omp parallel section
+  }
+  
+  frozenImageValid = true;
+  return 0;
+}
+
+
+/* ---------------- PROTECTED METHOD: ApplyProfileTables --------------- */
+/// Tells all functions to use (or not use) radial-profile lookup tables, sized
+/// to the diagonal of the model image.
+void ModelObject::ApplyProfileTables( )
+{
+  double  rMax = 0.0;
+  
+  if (useProfileTables)
+    rMax = sqrt((double)nModelColumns*nModelColumns + (double)nModelRows*nModelRows);
+  for (FunctionObject *funcObj : functionObjects)
+    funcObj->UseProfileTable(rMax);
+  componentCacheValid = false;
+  frozenImageValid = false;
+}
+
+
 /* ---------------- PROTECTED METHOD: VetDataVector -------------------- */
 /// Returns true if all non-masked pixels in the image data vector are finite;
 /// returns false if one or more are not, and prints an error message to stderr.
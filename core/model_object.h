@@ -50,6 +50,39 @@ class ModelObject
     void SetMaxThreads( int maxThreadNumber );
 
     void SetOMPChunkSize( int chunkSize );
+
+    // 2D only
+    void SetOMPSchedule( int scheduleType );
+
+    // 2D only
+    void SetOMPTileSize( int tileRows, int tileColumns );
+
+    // 2D only
+    void SetFFTWPlanning( int planningMode );
+
+    // 2D only
+    void UseFloatConvolution( bool useFloat );
+
+    // 2D only
+    void UseTiledConvolution( int tileSize );
+
+    // 2D only
+    void SetFootprintFraction( double fraction );
+
+    // 2D only
+    void UseComponentCache( bool useCache, double maxCacheBytes=DEFAULT_COMPONENT_CACHE_LIMIT );
+
+    // 2D only
+    long EstimateComponentCacheMemoryUse( );
+
+    // 2D only
+    void UseFrozenComponentCache( bool useCache );
+
+    // 2D only
+    void UseProfileTables( bool useTables );
+
+    // 2D only
+    int GetNFrozenComponents( );
     
     
     // Adds a new FunctionObject pointer to the internal vector
@@ -73,7 +106,7 @@ class ModelObject
 
     // 2D only
     void AddParameterInfo( mp_par  *inputParameterInfo );
-    void AddParameterInfo( vector<mp_par> inputParameterInfo );
+    virtual void AddParameterInfo( vector<mp_par> inputParameterInfo );
  
 	// 2D only
     int AddImageDataVector( double *pixelVector, int nImageColumns, int nImageRows );
@@ -115,6 +148,10 @@ class ModelObject
     int AddPSFVector( long nPixels_psf, int nColumns_psf, int nRows_psf,
                          double *psfPixels, bool normalizePSF=true );
 
+	// 2D only
+    int AddPSFBasis( vector<double *> basisPixels, int nColumns_psf, int nRows_psf,
+                         vector<double *> coefficientMaps, int nColumns_map, int nRows_map );
+
  	// 2D only
     int AddOversampledPsfInfo( PsfOversamplingInfo *oversampledPsfInfo );
 
@@ -219,6 +256,9 @@ class ModelObject
     bool HasOversampledPSF( );
     bool HasMask( );
 
+	// 2D only
+    string GetConvolutionEngineName( );
+
 	// 2D only (overridden in ModelObjectMultImage)
     virtual double * GetModelImageVector( );
 
@@ -271,6 +311,31 @@ class ModelObject
     
     bool VetDataVector( );
 
+    // 2D only
+    void GetFootprintLimits( int n, long& iStart, long& iEnd, long& jStart, long& jEnd );
+
+    // 2D only
+    bool AddedAfterConvolution( int n );
+
+    // 2D only
+    int AllocateComponentCache( );
+
+    // 2D only
+    void FreeComponentCache( );
+
+    // 2D only
+    bool FunctionParamsChanged( int n, int x0Offset, int paramOffset, double params[],
+    							vector<double>& oldParams );
+
+    // 2D only
+    void IdentifyFrozenComponents( );
+
+    // 2D only
+    int ComputeFrozenImage( );
+
+    // 2D only
+    void ApplyProfileTables( );
+
 
 
   private:
@@ -285,6 +350,12 @@ class ModelObject
 	double  readNoise_adu_squared;
     int  debugLevel, verboseLevel;
     int  maxRequestedThreads, ompChunkSize;
+    int  ompScheduleType, ompTileRows, ompTileColumns;
+    int  fftwPlanningMode;
+    bool  useFloatConvolution;
+    int  convolutionTileSize;
+    double  footprintFraction;
+    bool  useProfileTables;
     bool  dataValsSet;
     bool  modelVectorAllocated, weightVectorAllocated, maskVectorAllocated;
     bool  standardWeightVectorAllocated;
@@ -316,6 +387,18 @@ class ModelObject
     double  *outputModelVector;
     double  *extraCashTermsVector;
     double  *localPsfPixels;
+    // Convolver's zero-padded FFT input array (if available), which model images
+    // are written directly into
+    double  *convolverInputImage;
+    long  convolverInputStride;
+    // sum and centroid offset (relative to the convolution center) of the PSF,
+    // used to add planar background components after PSF convolution
+    bool  bypassBackgroundConvolution;
+    double  psfFluxScale, psfShiftX, psfShiftY;
+    // spatially varying PSF: copies of basis PSFs, and coefficient maps extended
+    // to the size of the model image
+    vector<double *>  psfBasisPixels, psfBasisCoeffMaps;
+    int  nColumns_psfBasisMap, nRows_psfBasisMap;
     long  *bootstrapIndices;
     bool  *fsetStartFlags;
     vector<FunctionObject *> functionObjects;
@@ -327,6 +410,30 @@ class ModelObject
     
     PsfInterpolator *psfInterpolator;
     bool  psfInterpolator_allocated;
+
+    // per-component cache of (unconvolved) model images, so that components
+    // whose parameters have not changed need not be recomputed
+    bool  useComponentCache, componentCacheAllocated, componentCacheValid;
+    double  maxComponentCacheBytes;
+    double  *componentImages;
+    vector<int>  componentCacheIndices;   // -1 for functions without cached images
+    vector<double>  cachedParams;         // parameter vector used for cached images
+    double  *convolvedComponentsImage;    // PSF-convolved sum of cached components
+    // sum of components added after PSF convolution, and the functions overlapping
+    // each image tile when it was computed
+    double  *postConvolutionImage;
+    vector< vector<int> >  cachedTileFunctions;
+    bool  postConvolutionCacheValid;
+    double  cachedImageParams[3];         // image-description params (multimfit)
+
+    // cache for components whose parameters are all fixed ("frozen" components);
+    // these are computed -- and PSF-convolved, if appropriate -- once, and the
+    // result is added to each new model image
+    bool  useFrozenCache, frozenImageAllocated, frozenImageValid;
+    int  nFrozenComponents;
+    double  *frozenImage;
+    vector<bool>  frozenFunctionFlags;
+    vector<double>  frozenParams;         // parameter vector used for frozenImage
     
     // stuff for ovsersampled PSF convolution
     Convolver  *psfConvolver_osamp;
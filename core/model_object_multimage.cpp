@@ -41,6 +41,7 @@
 #include <cmath>
 #include <iostream>
 #include <tuple>
+#include <algorithm>
 
 // logging
 #ifdef USE_LOGGING
@@ -312,6 +313,71 @@ int ModelObjectMultImage::FinalSetupForFitting( )
   return 0;
 }
 
+
+
+/* ---------------- PUBLIC METHOD: AddParameterInfo -------------------- */
+/// Stores parameter info for the full (multi-image) parameter vector, and passes
+/// the corresponding fixed/free flags on to the individual ModelObject instances,
+/// so that each can identify its "frozen" (all-parameters-fixed) components.
+/// A parameter of an individual ModelObject counts as free if it changes when
+/// any free parameter of the full vector is changed; for the 2nd and subsequent
+/// images, the global-function parameters also count as free if any of that
+/// image's pixel-scale, rotation, or intensity-scale parameters is free.
+void ModelObjectMultImage::AddParameterInfo( vector<mp_par> inputParameterInfo )
+{
+  ModelObject::AddParameterInfo(inputParameterInfo);
+  
+  if (! parameterHolderSet)
+    SetupParamHolder();
+
+  // Generic (distinct, nonzero) test values, so that e.g. a free rotation always
+  // changes the transformed X0,Y0 of the 2nd and subsequent function sets
+  vector<double> testParams(nParamsTot);
+  for (int j = 0; j < nParamsTot; j++)
+    testParams[j] = 1.0 + 0.1*(j + 1);
+  
+  vector< vector<double> > baseParams(nModelObjects), baseImageParams(nModelObjects);
+  vector< vector<bool> > paramIsFree(nModelObjects);
+  parameterHolder.AddNewParameterVector(testParams.data());
+  for (int i = 0; i < nModelObjects; i++) {
+    baseParams[i].resize(nParamsForModelObjects[i]);
+    parameterHolder.GetParamsForModelObject(i, baseParams[i].data());
+    baseImageParams[i].resize(N_IMAGE_DESCRIPTION_PARAMS);
+    parameterHolder.GetImageParams(i, baseImageParams[i].data());
+    paramIsFree[i].assign(nParamsForModelObjects[i], false);
+  }
+
+  vector<double> newParams, newImageParams(N_IMAGE_DESCRIPTION_PARAMS);
+  for (int j = 0; j < nParamsTot; j++) {
+    if (inputParameterInfo[j].fixed == 1)
+      continue;
+    double  savedValue = testParams[j];
+    testParams[j] += 1.0;
+    parameterHolder.AddNewParameterVector(testParams.data());
+    for (int i = 0; i < nModelObjects; i++) {
+      newParams.resize(nParamsForModelObjects[i]);
+      parameterHolder.GetParamsForModelObject(i, newParams.data());
+      for (int k = 0; k < nParamsForModelObjects[i]; k++)
+        if (newParams[k] != baseParams[i][k])
+          paramIsFree[i][k] = true;
+      parameterHolder.GetImageParams(i, newImageParams.data());
+      if (newImageParams != baseImageParams[i]) {
+        for (int k = 0; k < std::min(nGlobalFuncParams, nParamsForModelObjects[i]); k++)
+          paramIsFree[i][k] = true;
+      }
+    }
+    testParams[j] = savedValue;
+  }
+
+  // only the fixed/free flags matter to the individual ModelObject instances
+  for (int i = 0; i < nModelObjects; i++) {
+    vector<mp_par> imageParameterInfo(nParamsForModelObjects[i]);
+    for (int k = 0; k < nParamsForModelObjects[i]; k++)
+      imageParameterInfo[k].fixed = (paramIsFree[i][k]) ? 0 : 1;
+    modelObjectsVect[i]->AddParameterInfo(imageParameterInfo);
+  }
+}
+
 // parameter vector should be of the form:
 //    [ pixScale_1,rotation_1,intensityScale_1,X0_1,Y0_1, ..., 
 //       <params for first ModelObject> ]
@@ -72,6 +72,10 @@ class ModelObjectMultImage : public ModelObject
     
     int AddFunction( FunctionObject *newFunctionObj_ptr, bool isGlobalFunc=true ) override;
     
+    // (the mp_par-array version is inherited unchanged)
+    using ModelObject::AddParameterInfo;
+    void AddParameterInfo( vector<mp_par> inputParameterInfo ) override;
+    
     int FinalSetupForFitting( ) override;
     
     void CreateModelImage( double params[] ) override;
@@ -296,6 +296,7 @@ int main(int argc, char *argv[])
   // After loop finishes, call AddFunctions using ModelObjectMultImage
   
   ModelObject * newModel;
+  long  componentCacheMemory = 0;
   if (options->loggingOn)
     LOG_F(INFO, "Starting loop setting up and adding individual ModelObject instances...");
   for (int i = 0; i < nDataImages; i++) {
@@ -447,6 +448,7 @@ int main(int argc, char *argv[])
   	  exit(-1);
     }
     newModel->FinalModelSetup();
+    componentCacheMemory += newModel->EstimateComponentCacheMemoryUse();
     // Note that ModelObjectMultImage will handle de-allocation of ModelObject instance
     theMultImageModel->AddModelObject(newModel);
   }
@@ -637,6 +639,7 @@ int main(int argc, char *argv[])
   	if (psfOversamplingInfoVect.size() > 0)
       estimatedMemory += EstimatePsfOversamplingMemoryUse(psfOversamplingInfoVect);
   }
+  estimatedMemory += componentCacheMemory;
 
   nGBytes = (1.0*estimatedMemory) / GIGABYTE;
   if (nGBytes >= 1.0)
@@ -928,6 +931,16 @@ void ProcessInput( int argc, char *argv[], shared_ptr<MultimfitOptions> theOptio
   optParser->AddUsageLine("     --logging                Save logging outputs to file");
   optParser->AddUsageLine("");
   optParser->AddUsageLine("     --max-threads <int>      Maximum number of threads to use");
+  optParser->AddUsageLine("     --fftw-planning <name>   Rigor of FFTW planning for PSF convolution (estimate, measure,");
+  optParser->AddUsageLine("                              patient, or exhaustive; default = estimate); results of");
+  optParser->AddUsageLine("                              slower planning are saved in .imfit_fftw_wisdom for re-use");
+  optParser->AddUsageLine("     --float-convolution      Do FFTs for PSF convolution in single precision (faster,");
+  optParser->AddUsageLine("                              uses less memory; relative accuracy ~ 1e-6)");
+  optParser->AddUsageLine("     --conv-tile-size <int>   Do PSF convolution with FFTs of image tiles of this size");
+  optParser->AddUsageLine("                              (in pixels), to limit memory use for very large images");
+  optParser->AddUsageLine("     --max-memory-gb <value>  Use tiled PSF convolution if estimated memory use for");
+  optParser->AddUsageLine("                              the model image and PSF convolution exceeds this (in GB);");
+  optParser->AddUsageLine("                              also limits memory for cached component images");
   optParser->AddUsageLine("");
   optParser->AddUsageLine("     --seed <int>             RNG seed (for testing purposes)");
   optParser->AddUsageLine("     --nosubsampling          Turn off pixel subsampling near centers of functions");
@@ -973,6 +986,10 @@ void ProcessInput( int argc, char *argv[], shared_ptr<MultimfitOptions> theOptio
   optParser->AddOption("config", "c");
   optParser->AddOption("image-info", "i");
   optParser->AddOption("max-threads");
+  optParser->AddOption("fftw-planning");
+  optParser->AddFlag("float-convolution");
+  optParser->AddOption("conv-tile-size");
+  optParser->AddOption("max-memory-gb");
   optParser->AddOption("seed");
 
   // Comment this out if you want unrecognized (e.g., mis-spelled) flags and options
@@ -1154,6 +1171,44 @@ void ProcessInput( int argc, char *argv[], shared_ptr<MultimfitOptions> theOptio
     theOptions->maxThreads = atol(optParser->GetTargetString("max-threads").c_str());
     theOptions->maxThreadsSet = true;
   }
+  if (optParser->FlagSet("float-convolution")) {
+    theOptions->useFloatConvolution = true;
+  }
+  if (optParser->OptionSet("conv-tile-size")) {
+    if (NotANumber(optParser->GetTargetString("conv-tile-size").c_str(), 0, kPosInt)) {
+      fprintf(stderr, "*** ERROR: conv-tile-size should be a positive integer!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->convolutionTileSize = atol(optParser->GetTargetString("conv-tile-size").c_str());
+    theOptions->convolutionTileSizeSet = true;
+  }
+  if (optParser->OptionSet("max-memory-gb")) {
+    if (NotANumber(optParser->GetTargetString("max-memory-gb").c_str(), 0, kPosReal)) {
+      fprintf(stderr, "*** ERROR: max-memory-gb should be a positive real number!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->maxMemory = GIGABYTE * atof(optParser->GetTargetString("max-memory-gb").c_str());
+    theOptions->maxMemorySet = true;
+  }
+  if (optParser->OptionSet("fftw-planning")) {
+    string  planningName = optParser->GetTargetString("fftw-planning");
+    if (planningName == "estimate")
+      theOptions->fftwPlanningMode = FFTW_PLANNING_ESTIMATE;
+    else if (planningName == "measure")
+      theOptions->fftwPlanningMode = FFTW_PLANNING_MEASURE;
+    else if (planningName == "patient")
+      theOptions->fftwPlanningMode = FFTW_PLANNING_PATIENT;
+    else if (planningName == "exhaustive")
+      theOptions->fftwPlanningMode = FFTW_PLANNING_EXHAUSTIVE;
+    else {
+      fprintf(stderr, "*** ERROR: fftw-planning should be \"estimate\", \"measure\", \"patient\", or \"exhaustive\"!\n\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->fftwPlanningSet = true;
+  }
   if (optParser->OptionSet("seed")) {
     if (NotANumber(optParser->GetTargetString("seed").c_str(), 0, kPosInt)) {
       printf("*** WARNING: RNG seed should be a positive integer!\n");
@@ -39,6 +39,9 @@ class OptionsBase
       psfFileName = "";
       normalizePSF = true;
       
+      psfBasisPresent = false;
+      psfBasisPolyFileName = "";
+
       psfOversampling = false;
       psfOversampledImagePresent = false;
       psfOversampledFileName = "";
@@ -70,11 +73,29 @@ class OptionsBase
       solver = MPFIT_SOLVER;
 
       subsamplingFlag = true;
+      footprintFraction = 0.0;
+      footprintFractionSet = false;
+      useComponentCache = true;
+      useProfileTables = false;
+      componentCacheLimit = DEFAULT_COMPONENT_CACHE_LIMIT;
+      componentCacheLimitSet = false;
 
       rngSeed = 0;           // 0 = get seed value from system clock
   
       maxThreads = 0;
       maxThreadsSet = false;
+      ompScheduleType = OMP_SCHEDULE_DYNAMIC;
+      ompScheduleSet = false;
+      ompTileRows = DEFAULT_OMP_TILE_ROWS;
+      ompTileColumns = DEFAULT_OMP_TILE_COLUMNS;
+      ompTileSizeSet = false;
+      fftwPlanningMode = FFTW_PLANNING_ESTIMATE;
+      fftwPlanningSet = false;
+      useFloatConvolution = false;
+      convolutionTileSize = 0;
+      convolutionTileSizeSet = false;
+      maxMemory = 0.0;
+      maxMemorySet = false;
 
       verbose = 1;
       debugLevel = 0;
@@ -92,6 +113,11 @@ class OptionsBase
     bool  psfImagePresent;
     string  psfFileName;
     bool  normalizePSF;
+
+    bool  psfBasisPresent;
+    vector<string>  psfBasisFileNames;
+    vector<string>  psfBasisCoeffFileNames;
+    string  psfBasisPolyFileName;
   
     bool  psfOversampling;
     bool  psfOversampledImagePresent;
@@ -113,6 +139,12 @@ class OptionsBase
     int  maskFormat;
   
     bool  subsamplingFlag;
+    double  footprintFraction;
+    bool  footprintFractionSet;
+    bool  useComponentCache;
+    bool  useProfileTables;
+    double  componentCacheLimit;   // in bytes
+    bool  componentCacheLimitSet;
 
     bool  gainSet;
     double  gain;
@@ -133,6 +165,17 @@ class OptionsBase
 
     int  maxThreads;
     bool  maxThreadsSet;
+    int  ompScheduleType;
+    bool  ompScheduleSet;
+    int  ompTileRows, ompTileColumns;
+    bool  ompTileSizeSet;
+    int  fftwPlanningMode;
+    bool  fftwPlanningSet;
+    bool  useFloatConvolution;
+    int  convolutionTileSize;
+    bool  convolutionTileSizeSet;
+    double  maxMemory;   // in bytes
+    bool  maxMemorySet;
   
     unsigned long  rngSeed;
 
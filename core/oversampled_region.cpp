@@ -4,6 +4,10 @@
  * with oversampled PSF.
  *
  *   MODIFICATION HISTORY:
+ *     17 Oct 2026: Split ComputeRegionAndDownsample into ComputeRegion (safe to call
+ *        concurrently for different regions) and AddPointSourcesAndDownsample.
+ *     17 Oct 2026: Uses (thread-safe) PsfInterpolator_bicubic_native for PointSources.
+ *     17 Oct 2026: PointSource functions are only evaluated within their footprints.
  *     [v0.01]: 29 July 2014: Created.
  */
 
@@ -67,6 +71,7 @@
 #include <assert.h>
 #include <string>
 #include <vector>
+#include <algorithm>
 
 #ifdef USE_LOGGING
 #include "loguru/loguru.hpp"
@@ -77,6 +82,7 @@
 #include "oversampled_region.h"
 #include "downsample.h"
 #include "utilities_pub.h"
+#include "image_tiles.h"
 #ifdef DEBUG
 #include "image_io.h"
 #endif
@@ -105,6 +111,11 @@ OversampledRegion::OversampledRegion( )
   psfInterpolator = nullptr;
   psfInterpolator_allocated = false;
   ompChunkSize = DEFAULT_OPENMP_CHUNK_SIZE;
+  ompScheduleType = OMP_SCHEDULE_DYNAMIC;
+  ompTileRows = DEFAULT_OMP_TILE_ROWS;
+  ompTileColumns = DEFAULT_OMP_TILE_COLUMNS;
+  fftwPlanningMode = FFTW_PLANNING_ESTIMATE;
+  useFloatConvolution = false;
   
   debugImageName = "oversampled_region_testoutput";
 #ifdef USE_LOGGING
@@ -155,6 +166,40 @@ void OversampledRegion::SetMaxThreads( int maximumThreadNumber )
 }
 
 
+/* ---------------- SetOMPTiling --------------------------------------- */
+/// Specifies OpenMP scheduling (OMP_SCHEDULE_STATIC, etc.) and size of image
+/// tiles (tileColumns = 0 --> tiles extend over full rows) for computing the
+/// oversampled image
+void OversampledRegion::SetOMPTiling( int scheduleType, int tileRows, int tileColumns )
+{
+  ompScheduleType = scheduleType;
+  ompTileRows = tileRows;
+  ompTileColumns = tileColumns;
+}
+
+
+/* ---------------- SetFFTWPlanning ------------------------------------ */
+/// Specifies rigor of FFTW planning (FFTW_PLANNING_ESTIMATE, etc.) for PSF
+/// convolution of the oversampled image; must be called before SetupModelImage()
+void OversampledRegion::SetFFTWPlanning( int planningMode )
+{
+  fftwPlanningMode = planningMode;
+  if (doConvolution)
+    psfConvolver->SetFFTWPlanning(fftwPlanningMode);
+}
+
+
+/* ---------------- UseFloatConvolution -------------------------------- */
+/// Specifies whether FFTs for PSF convolution of the oversampled image are done
+/// in single precision; must be called before SetupModelImage()
+void OversampledRegion::UseFloatConvolution( bool useFloat )
+{
+  useFloatConvolution = useFloat;
+  if (doConvolution)
+    psfConvolver->UseFloatConvolution(useFloatConvolution);
+}
+
+
 /* ---------------- SetupPSF ------------------------------------------- */
 /// Pass in a pointer to the pixel vector for the input PSF image, as well as
 /// the image dimensions.
@@ -175,13 +220,15 @@ void OversampledRegion::AddPSFVector( double *psfPixels, int nColumns_psf, int n
     psfConvolver = new Convolver();
     psfConvolver->SetupPSF(psfPixels, nColumns_psf, nRows_psf, normalizePSF);
     psfConvolver->SetMaxThreads(maxRequestedThreads);
+    psfConvolver->SetFFTWPlanning(fftwPlanningMode);
+    psfConvolver->UseFloatConvolution(useFloatConvolution);
     doConvolution = true;
   }
   
   // We assume PSF has been normalized by psfConvolver, if user requested that
-  // Default case of GSL bicubic interpolation
+  // Default case of bicubic interpolation
   if ((nColumns_psf >= 4) && (nRows_psf >= 4)) {
-    psfInterpolator = new PsfInterpolator_bicubic(psfPixels, nColumns_psf, nRows_psf);
+    psfInterpolator = new PsfInterpolator_bicubic_native(psfPixels, nColumns_psf, nRows_psf);
     psfInterpolator_allocated = true;
     if (debugLevel > 0) {
       printf("  OversampledRegion::AddPSFVector -- generating new PsfInterpolator\n");
@@ -194,7 +241,7 @@ void OversampledRegion::AddPSFVector( double *psfPixels, int nColumns_psf, int n
   }
   else {
     fprintf(stderr, "** ERROR: Oversampled PSF image is too small for interpolation with PointSource functions!\n");
-    fprintf(stderr, "   (must be at least 4 x 4 pixels in size for GSL bicubic interpolation)\n");
+    fprintf(stderr, "   (must be at least 4 x 4 pixels in size for bicubic interpolation)\n");
   }
 }
 
@@ -276,18 +323,40 @@ int OversampledRegion::SetupModelImage( int x1, int y1, int nBaseColumns, int nB
 /* ---------------- ComputeRegionAndDownsample ------------------------- */
 /// This is the main method, which computes the oversampled (sub-region) model image,
 /// then downsamples it to the main image pixel scale and copies it into the main
-/// image (mainImageVector).
+/// image (mainImageVector); it is equivalent to calling ComputeRegion followed by
+/// AddPointSourcesAndDownsample.
 /// We assume that the FunctionObjects pointed to by functionObjectVect have
 /// already been set up with the current parameter values by calling their
 /// individual Setup() methods -- e.g., by the method or function that is calling
 /// *this* method.
 void OversampledRegion::ComputeRegionAndDownsample( double *mainImageVector, 
-					vector<FunctionObject *> functionObjectVect, int nFunctions  )
+					const vector<FunctionObject *>& functionObjectVect, int nFunctions  )
 {
-  int   i, j, n, status;
-  double  x, y, newValSum, tempSum, adjVal, storedError;
-  bool pointSourcesPresent = false;
+  ComputeRegion(functionObjectVect, nFunctions);
+  AddPointSourcesAndDownsample(mainImageVector, functionObjectVect, nFunctions);
+}
+
+
+
+/* ---------------- ComputeRegion -------------------------------------- */
+/// Computes the oversampled model image for all non-PointSource functions, and
+/// convolves it with the oversampled PSF (if requested). This only writes to
+/// memory owned by this object (the model image and the Convolver's workspace)
+/// and only calls GetValues() for the (non-PointSource) FunctionObjects, so 
+/// different OversampledRegion objects can safely call this method concurrently 
+/// with the same set of FunctionObjects. (The OpenMP parallel sections within
+/// this method are then nested, and normally run on a single thread.)
+void OversampledRegion::ComputeRegion( const vector<FunctionObject *>& functionObjectVect, 
+					int nFunctions  )
+{
+  int   n;
+  long  t, i, j, nCols, iTileStart, iTileEnd, jTileStart, jTileEnd;
+  double  y, tempSum, adjVal;
+  double  *rowVals, *rowErrors, *modelRow;
   string  outputName;
+  // x value for first column of the oversampled model image; successive columns
+  // are spaced by subpixFrac
+  double  xStart = x1_region + startX_offset - nPSFColumns*subpixFrac;
 
 // Compute oversampled-region image, using OpenMP for speed
 // (possibly slower if sub-region is really small, but in that case this whole
@@ -298,41 +367,54 @@ void OversampledRegion::ComputeRegionAndDownsample( double *mainImageVector,
   LOG_F(2, "OversampledRegion (%s): Generating non-PS image", 
   		regionLabel.c_str());
 #endif
-#pragma omp parallel private(i,j,n,x,y,newValSum,tempSum,adjVal,storedError)
+  // The image is divided into tiles, which are assigned to threads dynamically
+  // (by default), since pixels near component centers are more expensive
+  ImageTiles  modelTiles(nModelRows, nModelColumns, ompTileRows, ompTileColumns);
+  long  nTiles = modelTiles.GetNTiles();
+  long  nTileColumns = modelTiles.GetMaxTileColumns();
+  SetOMPTileSchedule(ompScheduleType);
+#pragma omp parallel private(t,i,j,n,y,tempSum,adjVal,rowVals,rowErrors,modelRow,nCols,iTileStart,iTileEnd,jTileStart,jTileEnd)
   {
-  #pragma omp for schedule (static, ompChunkSize)
-  // single-loop code which is ~ same in general case as double-loop, and
-  // faster for case of small image + many cores (André Luiz de Amorim suggestion)
-  for (long k = 0; k < nModelVals; k++) {
-    j = k % nModelColumns;
-    i = k / nModelColumns;
-    y = y1_region + startY_offset + (i - nPSFRows)*subpixFrac;              // Iraf counting: first row = 1
-                                                 // (note that nPSFRows = 0 if not doing PSF convolution)
-    x = x1_region + startX_offset + (j - nPSFColumns)*subpixFrac;           // Iraf counting: first column = 1
-                                                 // (note that nPSFColumns = 0 if not doing PSF convolution)
-    newValSum = 0.0;
-    storedError = 0.0;
-    for (n = 0; n < nFunctions; n++) {
-      if (! functionObjectVect[n]->IsPointSource()) {
-        // Kahan summation algorithm
-        adjVal = functionObjectVect[n]->GetValue(x, y) - storedError;
-        tempSum = newValSum + adjVal;
-        storedError = (tempSum - newValSum) - adjVal;
-        newValSum = tempSum;
+  rowVals = (double *)calloc((size_t)nTileColumns, sizeof(double));
+  rowErrors = (double *)calloc((size_t)nTileColumns, sizeof(double));
+  #pragma omp for schedule (runtime)
+  for (t = 0; t < nTiles; t++) {
+    modelTiles.GetTileLimits(t, iTileStart, iTileEnd, jTileStart, jTileEnd);
+    nCols = jTileEnd - jTileStart;
+    for (i = iTileStart; i < iTileEnd; i++) {   // step by row number = y
+      y = y1_region + startY_offset + (i - nPSFRows)*subpixFrac;              // Iraf counting: first row = 1
+                                                   // (note that nPSFRows = 0 if not doing PSF convolution)
+      modelRow = modelVector + i*nModelColumns + jTileStart;
+      for (j = 0; j < nCols; j++) {
+        modelRow[j] = 0.0;
+        rowErrors[j] = 0.0;
+      }
+      for (n = 0; n < nFunctions; n++) {
+        if (! functionObjectVect[n]->IsPointSource()) {
+          functionObjectVect[n]->GetValues(y, xStart + jTileStart*subpixFrac, subpixFrac, 
+          									nCols, rowVals);
+          // Kahan summation algorithm
+          for (j = 0; j < nCols; j++) {
+            adjVal = rowVals[j] - rowErrors[j];
+            tempSum = modelRow[j] + adjVal;
+            rowErrors[j] = (tempSum - modelRow[j]) - adjVal;
+            modelRow[j] = tempSum;
+          }
+        }
       }
     }
-    modelVector[i*nModelColumns + j] = newValSum;
   }
-  
+  free(rowVals);
+  free(rowErrors);
   } // end omp parallel section
 
 #ifdef DEBUG
   if (debugLevel > 0) {
     vector<string>  imageCommentsList;
     outputName = debugImageName + ".fits";
-    printf("\nOversampledRegion::ComputeRegionAndDownsample -- Saving output model image (\"%s\") ...\n", 
+    printf("\nOversampledRegion::ComputeRegion -- Saving output model image (\"%s\") ...\n", 
     		outputName.c_str());
-    status = SaveVectorAsImage(modelVector, outputName, nModelColumns, nModelRows, 
+    SaveVectorAsImage(modelVector, outputName, nModelColumns, nModelRows, 
     							imageCommentsList);
   }
 #endif
@@ -351,15 +433,39 @@ void OversampledRegion::ComputeRegionAndDownsample( double *mainImageVector,
   if (debugLevel > 0) {
     vector<string>  imageCommentsList;
     outputName = debugImageName + "_conv.fits";
-    printf("\nOversampledRegion::ComputeRegionAndDownsample -- Saving PSF-convolved output model image (\"%s\") ...\n", 
+    printf("\nOversampledRegion::ComputeRegion -- Saving PSF-convolved output model image (\"%s\") ...\n", 
     		outputName.c_str());
-    status = SaveVectorAsImage(modelVector, outputName, nModelColumns, nModelRows, 
+    SaveVectorAsImage(modelVector, outputName, nModelColumns, nModelRows, 
     							imageCommentsList);
   }
 #endif
+}
+
+
 
+/* ---------------- AddPointSourcesAndDownsample ----------------------- */
+/// Adds flux from PointSource functions (if any) to the oversampled model image
+/// computed by ComputeRegion, then downsamples the result to the main image pixel 
+/// scale and copies it into the main image (mainImageVector).
+/// This resets the PSF interpolator and oversampling scale of each PointSource
+/// object, and oversampled regions can overlap in the main image, so calls for
+/// different OversampledRegion objects sharing the same FunctionObjects must
+/// *not* be made concurrently.
+void OversampledRegion::AddPointSourcesAndDownsample( double *mainImageVector, 
+					const vector<FunctionObject *>& functionObjectVect, int nFunctions  )
+{
+  int   n;
+  long  t, i, j, nCols, iTileStart, iTileEnd, jTileStart, jTileEnd;
+  double  y, tempSum, adjVal;
+  double  *rowVals, *rowErrors, *modelRow;
+  bool pointSourcesPresent = false;
+  string  outputName;
+  double  xStart = x1_region + startX_offset - nPSFColumns*subpixFrac;
+  ImageTiles  modelTiles(nModelRows, nModelColumns, ompTileRows, ompTileColumns);
+  long  nTiles = modelTiles.GetNTiles();
+  long  nTileColumns = modelTiles.GetMaxTileColumns();
 
-  // 3. Add flux from PointSource functions, if present (must be done *after* PSF convolution!)
+  // 1. Add flux from PointSource functions, if present (must be done *after* PSF convolution!)
   // Re-assign psfInterpolator object and set PointSource's oversampling scale
 //   for (n = 0; n < nFunctions; n++)
 //     if (functionObjectVect[n]->IsPointSource()) {
@@ -367,59 +473,101 @@ void OversampledRegion::ComputeRegionAndDownsample( double *mainImageVector,
 //       functionObjectVect[n]->AddPsfInterpolator(psfInterpolator);
 //       functionObjectVect[n]->SetOversamplingScale(oversamplingScale);
 //     }
-  for (FunctionObject *funcObj : functionObjectVect)
-    if (funcObj->IsPointSource()) {
+  // Each point source is only evaluated within its footprint (the region covered
+  // by the oversampled PSF image)
+  vector<long>  iStartVect(nFunctions, 0), iEndVect(nFunctions, 0);
+  vector<long>  jStartVect(nFunctions, 0), jEndVect(nFunctions, 0);
+  for (n = 0; n < nFunctions; n++)
+    if (functionObjectVect[n]->IsPointSource()) {
       pointSourcesPresent = true;
-      funcObj->AddPsfInterpolator(psfInterpolator);
-      funcObj->SetOversamplingScale(oversamplingScale);
+      functionObjectVect[n]->AddPsfInterpolator(psfInterpolator);
+      functionObjectVect[n]->SetOversamplingScale(oversamplingScale);
+      GetFootprintLimits(functionObjectVect[n], xStart, iStartVect[n], iEndVect[n], 
+      					jStartVect[n], jEndVect[n]);
     }
 
 #ifdef USE_LOGGING
   LOG_F(2, "OversampledRegion (%s): Generating PointSource image", 
   		regionLabel.c_str());
 #endif
-#pragma omp parallel private(i,j,n,x,y,newValSum,tempSum,adjVal,storedError)
-  {
-  #pragma omp for schedule (static, ompChunkSize)
-  for (long k = 0; k < nModelVals; k++) {
-    j = k % nModelColumns;
-    i = k / nModelColumns;
-    y = y1_region + startY_offset + (i - nPSFRows)*subpixFrac;
-    x = x1_region + startX_offset + (j - nPSFColumns)*subpixFrac;
-    newValSum = 0.0;
-    storedError = 0.0;
-    for (n = 0; n < nFunctions; n++) {
-      if (functionObjectVect[n]->IsPointSource()) {
+  if (pointSourcesPresent) {
+    SetOMPTileSchedule(ompScheduleType);
+#pragma omp parallel private(t,i,j,n,y,tempSum,adjVal,rowVals,rowErrors,modelRow,nCols,iTileStart,iTileEnd,jTileStart,jTileEnd)
+    {
+    rowVals = (double *)calloc((size_t)nTileColumns, sizeof(double));
+    rowErrors = (double *)calloc((size_t)nTileColumns, sizeof(double));
+    double  *rowSums = (double *)calloc((size_t)nTileColumns, sizeof(double));
+    long  jStart, jEnd, rowStart, rowEnd;
+    #pragma omp for schedule (runtime)
+    for (t = 0; t < nTiles; t++) {
+      modelTiles.GetTileLimits(t, iTileStart, iTileEnd, jTileStart, jTileEnd);
+      for (i = iTileStart; i < iTileEnd; i++) {   // step by row number = y
+        y = y1_region + startY_offset + (i - nPSFRows)*subpixFrac;
 #ifdef USE_LOGGING
-        if ((k == 0) || (k == (nModelVals - 1))) {
-          LOG_F(3, "   k = %d; i,j = %d,%d; x,y = %.2f,%.2f", k,i,j,x,y);
+        if ((i == 0) || (i == (nModelRows - 1))) {
+          LOG_F(3, "   i = %ld; xStart,y = %.2f,%.2f", i,xStart,y);
           LOG_F(3, "      x1_region = %d, startX_offset = %.2f", x1_region,startX_offset);
         }
 #endif
-        // Use Kahan summation algorithm
-        adjVal = functionObjectVect[n]->GetValue(x, y) - storedError;
-        tempSum = newValSum + adjVal;
-        storedError = (tempSum - newValSum) - adjVal;
-        newValSum = tempSum;
+        // find the part of this row (relative to the tile) covered by at least 
+        // one point source's footprint
+        rowStart = jTileEnd - jTileStart;
+        rowEnd = 0;
+        for (n = 0; n < nFunctions; n++) {
+          if ((i < iStartVect[n]) || (i >= iEndVect[n]))
+            continue;
+          rowStart = min(rowStart, max(jStartVect[n], jTileStart) - jTileStart);
+          rowEnd = max(rowEnd, min(jEndVect[n], jTileEnd) - jTileStart);
+        }
+        if (rowEnd <= rowStart)
+          continue;
+        modelRow = modelVector + i*nModelColumns + jTileStart;
+        for (j = rowStart; j < rowEnd; j++) {
+          rowSums[j] = 0.0;
+          rowErrors[j] = 0.0;
+        }
+        for (n = 0; n < nFunctions; n++) {
+          // (non-PointSource functions have empty row ranges)
+          if ((i < iStartVect[n]) || (i >= iEndVect[n]))
+            continue;
+          jStart = max(jStartVect[n], jTileStart) - jTileStart;
+          jEnd = min(jEndVect[n], jTileEnd) - jTileStart;
+          nCols = jEnd - jStart;
+          if (nCols <= 0)
+            continue;
+          functionObjectVect[n]->GetValues(y, xStart + (jTileStart + jStart)*subpixFrac, 
+          									subpixFrac, nCols, rowVals);
+          // Use Kahan summation algorithm
+          for (j = 0; j < nCols; j++) {
+            adjVal = rowVals[j] - rowErrors[jStart + j];
+            tempSum = rowSums[jStart + j] + adjVal;
+            rowErrors[jStart + j] = (tempSum - rowSums[jStart + j]) - adjVal;
+            rowSums[jStart + j] = tempSum;
+          }
+        }
+        for (j = rowStart; j < rowEnd; j++)
+          modelRow[j] += rowSums[j];
       }
     }
-    modelVector[i*nModelColumns + j] += newValSum;
+    free(rowVals);
+    free(rowErrors);
+    free(rowSums);
+    } // end omp parallel section
   }
-  } // end omp parallel section
 
 #ifdef DEBUG
   if ((debugLevel > 0) && (pointSourcesPresent)) {
     vector<string>  imageCommentsList;
     outputName = debugImageName + "_conv_with-point-sources.fits";
-    printf("\nOversampledRegion::ComputeRegionAndDownsample -- Saving PointSource-added output model image (\"%s\") ...\n", 
+    printf("\nOversampledRegion::AddPointSourcesAndDownsample -- Saving PointSource-added output model image (\"%s\") ...\n", 
     		outputName.c_str());
-    status = SaveVectorAsImage(modelVector, outputName, nModelColumns, nModelRows, 
+    SaveVectorAsImage(modelVector, outputName, nModelColumns, nModelRows, 
     							imageCommentsList);
   }
 #endif
 
 
-  // downsample & copy into main image
+  // 2. Downsample & copy into main image
 #ifdef USE_LOGGING
   LOG_F(2, "OversampledRegion (%s): Calling DownsampleAndReplace", 
   		regionLabel.c_str());
@@ -431,4 +579,40 @@ void OversampledRegion::ComputeRegionAndDownsample( double *mainImageVector,
 
 
 
+/* ---------------- GetFootprintLimits --------------------------------- */
+/// Converts the footprint of funcObj (if it has one) into a range of rows 
+/// [iStart, iEnd) and columns [jStart, jEnd) within the oversampled model image
+/// (whose first column has x = xStart); if the function has no footprint, the 
+/// ranges cover the entire model image. The ranges are padded by one (oversampled)
+/// pixel on each side.
+void OversampledRegion::GetFootprintLimits( FunctionObject *funcObj, double xStart,
+								long& iStart, long& iEnd, long& jStart, long& jEnd )
+{
+  double  xMin, xMax, yMin, yMax;
+  double  yStart = y1_region + startY_offset - nPSFRows*subpixFrac;
+  double  jLow, jHigh, iLow, iHigh;
+  
+  iStart = jStart = 0;
+  iEnd = nModelRows;
+  jEnd = nModelColumns;
+  if (! funcObj->GetFootprint(xMin, xMax, yMin, yMax))
+    return;
+  
+  // column j <--> x = xStart + j*subpixFrac; row i <--> y = yStart + i*subpixFrac
+  jLow = floor((xMin - xStart)/subpixFrac) - 1;
+  jHigh = ceil((xMax - xStart)/subpixFrac) + 2;
+  iLow = floor((yMin - yStart)/subpixFrac) - 1;
+  iHigh = ceil((yMax - yStart)/subpixFrac) + 2;
+  if (jLow > 0)
+    jStart = (jLow < nModelColumns) ? (long)jLow : nModelColumns;
+  if (jHigh < nModelColumns)
+    jEnd = (jHigh > jStart) ? (long)jHigh : jStart;
+  if (iLow > 0)
+    iStart = (iLow < nModelRows) ? (long)iLow : nModelRows;
+  if (iHigh < nModelRows)
+    iEnd = (iHigh > iStart) ? (long)iHigh : iStart;
+}
+
+
+
 /* END OF FILE: oversampled_region.cpp --------------------------------- */
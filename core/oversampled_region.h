@@ -40,6 +40,12 @@ class OversampledRegion
     
     void SetMaxThreads( int maximumThreadNumber );
 
+    void SetOMPTiling( int scheduleType, int tileRows, int tileColumns );
+
+    void SetFFTWPlanning( int planningMode );
+
+    void UseFloatConvolution( bool useFloat );
+
     void SetDebugLevel( int debuggingLevel );
 
     int SetupModelImage( int x1, int y1, int nBaseColumns, int nBaseRows, 
@@ -47,13 +53,26 @@ class OversampledRegion
     					int nRowsPSF_main, int oversampScale );
     					
     void ComputeRegionAndDownsample( double *mainImageVector, 
-    				vector<FunctionObject *> functionObjectVect, int nFunctionObjects );
+    				const vector<FunctionObject *>& functionObjectVect, int nFunctionObjects );
+
+    void ComputeRegion( const vector<FunctionObject *>& functionObjectVect, 
+    				int nFunctionObjects );
+
+    void AddPointSourcesAndDownsample( double *mainImageVector, 
+    				const vector<FunctionObject *>& functionObjectVect, int nFunctionObjects );
 
 
   private:
+  // Private member functions:
+    void GetFootprintLimits( FunctionObject *funcObj, double xStart, long& iStart, 
+    						long& iEnd, long& jStart, long& jEnd );
+
   // Data members:
     Convolver  *psfConvolver;
     int  ompChunkSize, maxRequestedThreads, debugLevel;
+    int  ompScheduleType, ompTileRows, ompTileColumns;
+    int  fftwPlanningMode;
+    bool  useFloatConvolution;
     int  oversamplingScale;
     double  subpixFrac, startX_offset, startY_offset;
     int  nPSFColumns, nPSFRows;
@@ -0,0 +1,23 @@
+// Header file for PsfBasisInfo structure
+
+#ifndef _PSF_BASIS_INFO_H_
+#define _PSF_BASIS_INFO_H_
+
+#include <vector>
+
+using namespace std;
+
+
+/// Basis PSF images and coefficient maps describing a spatially varying PSF:
+/// the PSF for light from pixel (x,y) of the data image is
+///    sum_k coefficientMaps[k](x,y) * psfImages[k]
+struct PsfBasisInfo
+{
+  int  nColumns_psf = 0, nRows_psf = 0;
+  vector<double *>  psfImages;
+  int  nColumns_map = 0, nRows_map = 0;   // same as data image
+  vector<double *>  coefficientMaps;
+};
+
+
+#endif   // _PSF_BASIS_INFO_H_
@@ -19,11 +19,13 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
 #include <stdlib.h>
 
 #include "setup_model_object.h"
 #include "options_base.h"
 #include "model_object.h"
+#include "estimate_memory.h"
 
 using namespace std;
 
@@ -35,12 +37,15 @@ using namespace std;
 
 ModelObject* SetupModelObject( std::shared_ptr<OptionsBase> options, vector<int> nColumnsRowsVector, 
 					double *dataPixels, double *psfPixels, double *maskPixels, 
-					double *errorPixels, vector<PsfOversamplingInfo *> psfOversampleInfoVect )
+					double *errorPixels, vector<PsfOversamplingInfo *> psfOversampleInfoVect,
+					PsfBasisInfo *psfBasisInfo )
 {
   ModelObject *newModelObj;
   int  status;
   bool  doingFit_or_MCMC = false;
-  int  nColumns, nRows, nColumns_psf, nRows_psf;
+  int  nColumns, nRows;
+  int  nColumns_psf = 0;
+  int  nRows_psf = 0;
   long  nPixels_data, nPixels_psf;
   
   newModelObj = new ModelObject();
@@ -49,12 +54,27 @@ ModelObject* SetupModelObject( std::shared_ptr<OptionsBase> options, vector<int>
 
   if (options->maxThreadsSet)
     newModelObj->SetMaxThreads(options->maxThreads);
+  if (options->ompScheduleSet)
+    newModelObj->SetOMPSchedule(options->ompScheduleType);
+  if (options->ompTileSizeSet)
+    newModelObj->SetOMPTileSize(options->ompTileRows, options->ompTileColumns);
+  if (options->fftwPlanningSet)
+    newModelObj->SetFFTWPlanning(options->fftwPlanningMode);
+  if (options->useFloatConvolution)
+    newModelObj->UseFloatConvolution(true);
   newModelObj->SetDebugLevel(options->debugLevel);
+  if (options->footprintFractionSet)
+    newModelObj->SetFootprintFraction(options->footprintFraction);
+  if (options->useProfileTables)
+    newModelObj->UseProfileTables(true);
 
 
-  // Add PSF image vector, if present (needs to be added prior to image data or
-  // model-image setup, so that ModelObject can figure out proper internal model-image 
-  // size when we call SetupModelImage or AddImageDataVector)
+  // Add PSF image vector or PSF basis, if present (needs to be added prior to image 
+  // data or model-image setup, so that ModelObject can figure out proper internal 
+  // model-image size when we call SetupModelImage or AddImageDataVector)
+  nColumns = nColumnsRowsVector[0];
+  nRows = nColumnsRowsVector[1];
+  int  nConvolvers = 0;
   if (options->psfImagePresent) {
     nColumns_psf = nColumnsRowsVector[2];
     nRows_psf = nColumnsRowsVector[3];
@@ -65,10 +85,38 @@ ModelObject* SetupModelObject( std::shared_ptr<OptionsBase> options, vector<int>
       fprintf(stderr, "*** ERROR: Failure in ModelObject::AddPSFVector!\n\n");
   	  exit(-1);
     }
+    nConvolvers = 1;
+  }
+  else if (psfBasisInfo != nullptr) {
+    nColumns_psf = psfBasisInfo->nColumns_psf;
+    nRows_psf = psfBasisInfo->nRows_psf;
+    status = newModelObj->AddPSFBasis(psfBasisInfo->psfImages, nColumns_psf, nRows_psf,
+    								psfBasisInfo->coefficientMaps, psfBasisInfo->nColumns_map,
+    								psfBasisInfo->nRows_map);
+    if (status < 0) {
+      fprintf(stderr, "*** ERROR: Failure in ModelObject::AddPSFBasis!\n\n");
+  	  exit(-1);
+    }
+    // (each basis PSF has its own Convolver)
+    nConvolvers = (int)psfBasisInfo->psfImages.size();
+  }
+  if (nConvolvers > 0) {
+    // Use tiled convolution if requested, or if convolving the whole image at once
+    // would need more than the user-specified memory limit
+    if (options->convolutionTileSizeSet)
+      newModelObj->UseTiledConvolution(options->convolutionTileSize);
+    else if (options->maxMemorySet) {
+      long  imageMemory = nConvolvers * EstimateMemoryUse(nColumns, nRows, nColumns_psf, 
+      										nRows_psf, 0, false, false, false, false);
+      if (imageMemory > options->maxMemory) {
+        if (options->verbose > 0)
+          printf("* Estimated memory use (%ld bytes) exceeds limit: using tiled PSF convolution\n",
+          		imageMemory);
+        newModelObj->UseTiledConvolution(DEFAULT_CONVOLUTION_TILE_SIZE);
+      }
+    }
   }
 
-  nColumns = nColumnsRowsVector[0];
-  nRows = nColumnsRowsVector[1];
   nPixels_data = (long)nColumns * (long)nRows;
   if (dataPixels == nullptr) {
     // No data image, so we're in makeimage mode
@@ -90,6 +138,9 @@ ModelObject* SetupModelObject( std::shared_ptr<OptionsBase> options, vector<int>
     						options->nCombined, options->originalSky);
   }
 
+  if (((options->psfImagePresent) || (psfBasisInfo != nullptr)) && (options->verbose > 0))
+    printf("* PSF convolution method: %s\n", newModelObj->GetConvolutionEngineName().c_str());
+
   // Add oversampled PSF image vector(s) and corresponding info, if present
   if (options->psfOversampling) {
     for (int i = 0; i < (int)psfOversampleInfoVect.size(); i++) {
@@ -113,6 +164,26 @@ ModelObject* SetupModelObject( std::shared_ptr<OptionsBase> options, vector<int>
   
   
   if (doingFit_or_MCMC) {
+    // Model images are computed many times during fitting/MCMC, so re-use
+    // images of components whose parameters don't change between calls, and
+    // pre-compute the image of components whose parameters are all fixed.
+    // If the user set an overall memory limit, the cache gets only what is left
+    // of it after the model image and PSF convolution
+    if (options->useComponentCache) {
+      double  cacheLimit = options->componentCacheLimit;
+      if (options->maxMemorySet) {
+        long  imageMemory = std::max(nConvolvers, 1) * EstimateMemoryUse(nColumns, nRows, 
+        						nColumns_psf, nRows_psf, 0, false, false, false, false);
+        double  remainingMemory = std::max(options->maxMemory - (double)imageMemory, 0.0);
+        if (options->componentCacheLimitSet)
+          cacheLimit = std::min(cacheLimit, remainingMemory);
+        else
+          cacheLimit = remainingMemory;
+      }
+      newModelObj->UseComponentCache(true, cacheLimit);
+      newModelObj->UseFrozenComponentCache(true);
+    }
+
     // Specify which fit statistic we'll use, and add user-supplied error image if
     // it exists and we're using chi^2; also catch special case of standard Cash
     // statistic + L-M minimizer
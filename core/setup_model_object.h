@@ -9,6 +9,7 @@
 #include "options_base.h"
 #include "model_object.h"
 #include "psf_oversampling_info.h"
+#include "psf_basis_info.h"
 
 using namespace std;
 
@@ -18,7 +19,8 @@ static vector<PsfOversamplingInfo *> EMPTY_PSF_OVERSAMPLING_PTR_VECTOR;
 ModelObject* SetupModelObject( std::shared_ptr<OptionsBase> options, vector<int> nColumnsRowsVector, 
 					double *dataPixels, double *psfPixels=nullptr, double *maskPixels=nullptr, 
 					double *errorPixels=nullptr, 
-					vector<PsfOversamplingInfo *> psfOversampleInfoVect=EMPTY_PSF_OVERSAMPLING_PTR_VECTOR ); 
+					vector<PsfOversamplingInfo *> psfOversampleInfoVect=EMPTY_PSF_OVERSAMPLING_PTR_VECTOR,
+					PsfBasisInfo *psfBasisInfo=nullptr ); 
 
 
 #endif  // _SETUP_MODEL_OBJECT_H_
@@ -155,6 +155,7 @@ helper_funcs
 helper_funcs_3d
 integrator
 psf_interpolators
+simd_kernels
 """
 
 functionobject_obj_string = """function_object func_gaussian func_exp func_gen-exp  
@@ -163,7 +164,7 @@ functionobject_obj_string = """function_object func_gaussian func_exp func_gen-e
         func_flatbar func_gaussian-ring func_gaussian-ring2side func_gaussian-ring-az  
         func_edge-on-ring func_edge-on-ring2side 
         func_king func_king2 func_ferrersbar2d  func_peanut_dattathri
-        helper_funcs helper_funcs_3d psf_interpolators"""
+        helper_funcs helper_funcs_3d psf_interpolators simd_kernels"""
 #if useGSL:
 # NOTE: the following modules require GSL be present
 functionobject_obj_string += " func_edge-on-disk"
@@ -105,6 +105,9 @@ int main(int argc, char *argv[])
 
   // NEW: tell Convolver object about size of image
   psfConvolver.SetupImage(nColumns, nRows);
+  // always use FFT convolution, since that's what we're testing (automatic choice
+  // would pick direct convolution for very small images)
+  psfConvolver.SetConvolutionEngine(CONVOLUTION_ENGINE_FFT);
   
 
   // NEW: tell Convolver object to finish setup work
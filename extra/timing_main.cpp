@@ -6,6 +6,15 @@
 // It is meant to test possible speedups in image generation (e.g., making use
 // of multiple cores) and convolution (e.g., varying the FFTW "wisdom"
 // parameters).
+//
+// With the --compare-schedules flag, it times image generation for several
+// different OpenMP scheduling schemes (static assignment of bands of full rows,
+// which was the original scheme, and static, dynamic, and guided assignment of
+// 2D tiles) using 1 thread and then the maximum number of threads, and prints
+// the speedup and parallel efficiency (speedup / number of threads) for each.
+// Low efficiency indicates poor load balance -- e.g., for models where most of
+// the time is spent subsampling pixels near the centers of compact components
+// (see tests/config_makeimage_timing_compact-centers.dat).
 
 
 
@@ -17,8 +26,14 @@
 #include <string.h>
 #include <string>
 #include <vector>
+#include <map>
+#include <tuple>
 #include <sys/time.h>   // for timing-related functions and structs
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
 #include "definitions.h"
 #include "image_io.h"
 #include "model_object.h"
@@ -58,6 +73,11 @@ typedef struct {
   double  magZeroPoint;
   bool  printImages;
   int  nIterations;
+  int  maxThreads;
+  int  ompScheduleType;
+  int  ompTileRows;
+  int  ompTileColumns;
+  bool  compareSchedules;
   int  debugLevel;
 } commandOptions;
 
@@ -69,6 +89,9 @@ typedef struct {
 /* Local Functions: */
 void ProcessInput( int argc, char *argv[], commandOptions *theOptions );
 void ProcessInput2( int argc, char *argv[], commandOptions *theOptions );
+double TimeImageGeneration( ModelObject *theModel, double *paramsVect, int nIterations );
+void CompareSchedules( ModelObject *theModel, double *paramsVect, int nIterations,
+						int maxThreads );
 
 
 /* ------------------------ Global Variables --------------------------- */
@@ -89,13 +112,14 @@ int main(int argc, char *argv[])
   double  *paramsVect;
   ModelObject  *theModel;
   vector<string>  functionList;
+  vector<string>  functionLabelList;
   vector<double>  parameterList;
   vector<int>  functionBlockIndices;
+  vector< map<string, string> >  optionalParams;
   commandOptions  options;
   configOptions  userConfigOptions;
   // timing-related stuff
-  struct timeval  timer_start, timer_end;
-  double  microsecs, time_elapsed;
+  double  time_elapsed;
   
   
   /* Process command line and parse config file: */
@@ -116,6 +140,11 @@ int main(int argc, char *argv[])
   options.magZeroPoint = NO_MAGNITUDES;
   options.printImages = false;
   options.nIterations = 1;
+  options.maxThreads = 0;
+  options.ompScheduleType = OMP_SCHEDULE_DYNAMIC;
+  options.ompTileRows = DEFAULT_OMP_TILE_ROWS;
+  options.ompTileColumns = DEFAULT_OMP_TILE_COLUMNS;
+  options.compareSchedules = false;
   options.debugLevel = 0;
 
   ProcessInput(argc, argv, &options);
@@ -126,8 +155,8 @@ int main(int argc, char *argv[])
            options.configFileName.c_str());
     return -1;
   }
-  status = ReadConfigFile(options.configFileName, true, functionList, parameterList,
-  							functionBlockIndices, userConfigOptions);
+  status = ReadConfigFile(options.configFileName, true, functionList, functionLabelList,
+  							parameterList, functionBlockIndices, userConfigOptions, optionalParams);
   if (status != 0) {
     fprintf(stderr, "\n*** ERROR: Failure reading configuration file \"%s\"!\n\n", 
     			options.configFileName.c_str());
@@ -141,7 +170,7 @@ int main(int argc, char *argv[])
 
   /* Get image size from reference image, if necessary */
   if (options.noImageDimensions) {
-    status = GetImageSize(options.referenceImageName, &nColumns, &nRows);
+    std::tie(nColumns, nRows, status) = GetImageSize(options.referenceImageName);
     if (status != 0) {
       fprintf(stderr,  "\n*** ERROR: Failure determining size of image file \"%s\"!\n\n", 
       			options.referenceImageName.c_str());
@@ -181,10 +210,15 @@ int main(int argc, char *argv[])
   /* Set up the model object */
   theModel = new ModelObject();
   theModel->SetDebugLevel(options.debugLevel);
+  if (options.maxThreads > 0)
+    theModel->SetMaxThreads(options.maxThreads);
+  theModel->SetOMPSchedule(options.ompScheduleType);
+  theModel->SetOMPTileSize(options.ompTileRows, options.ompTileColumns);
   
   /* Add functions to the model object; also tells model object where function
      sets start */
-  status = AddFunctions(theModel, functionList, functionBlockIndices, options.subsamplingFlag);
+  status = AddFunctions(theModel, functionList, functionLabelList, functionBlockIndices, 
+  						options.subsamplingFlag, 0, optionalParams);
   if (status < 0) {
   	fprintf(stderr, "*** ERROR: Failure in AddFunctions!\n\n");
   	exit(-1);
@@ -225,14 +259,14 @@ int main(int argc, char *argv[])
   
   
   // Generate the image (including convolution, if requested), repeatedly
-  gettimeofday(&timer_start, NULL);
-  for (int ii = 0; ii < options.nIterations; ii++)
-    theModel->CreateModelImage(paramsVect);
-  gettimeofday(&timer_end, NULL);
-  microsecs = timer_end.tv_usec - timer_start.tv_usec;
-  time_elapsed = timer_end.tv_sec - timer_start.tv_sec + microsecs/1e6;
-  printf("\nELAPSED TIME FOR %d ITERATIONS: %.6f sec\n", options.nIterations, time_elapsed);
-  printf("Mean time per iteration = %.7f\n", time_elapsed/options.nIterations);
+  if (options.compareSchedules)
+    CompareSchedules(theModel, paramsVect, options.nIterations, options.maxThreads);
+  else {
+    time_elapsed = options.nIterations * TimeImageGeneration(theModel, paramsVect, 
+    															options.nIterations);
+    printf("\nELAPSED TIME FOR %d ITERATIONS: %.6f sec\n", options.nIterations, time_elapsed);
+    printf("Mean time per iteration = %.7f\n", time_elapsed/options.nIterations);
+  }
 
   
 
@@ -273,6 +307,10 @@ void ProcessInput( int argc, char *argv[], commandOptions *theOptions )
   optParser->AddUsageLine("     --nrows <number-of-rows>   y-size of output image");
   optParser->AddUsageLine("     --nosubsampling          Do *not* do pixel subsampling near centers");
   optParser->AddUsageLine("     --niterations <n>             number of iterations to do");
+  optParser->AddUsageLine("     --max-threads <int>      Maximum number of threads to use");
+  optParser->AddUsageLine("     --omp-schedule <name>    OpenMP scheduling of image tiles (static, dynamic, or guided)");
+  optParser->AddUsageLine("     --omp-tile-size <nr,nc>  Size of image tiles assigned to threads (rows,columns)");
+  optParser->AddUsageLine("     --compare-schedules      Compare timing & load balance for different OpenMP schedules");
   optParser->AddUsageLine("     --debug <n>             debugging level");
   optParser->AddUsageLine("");
 
@@ -281,6 +319,7 @@ void ProcessInput( int argc, char *argv[], commandOptions *theOptions )
   optParser->AddFlag("help", "h");
   optParser->AddFlag("list-functions");
   optParser->AddFlag("nosubsampling");
+  optParser->AddFlag("compare-schedules");
   optParser->AddOption("output", "o");      /* an option (takes an argument) */
   optParser->AddOption("niterations");      /* an option (takes an argument), supporting only long form */
   optParser->AddOption("ncols");      /* an option (takes an argument), supporting only long form */
@@ -288,6 +327,9 @@ void ProcessInput( int argc, char *argv[], commandOptions *theOptions )
   optParser->AddOption("refimage");      /* an option (takes an argument), supporting only long form */
   optParser->AddOption("psf");      /* an option (takes an argument), supporting only long form */
   optParser->AddOption("debug");      /* an option (takes an argument), supporting only long form */
+  optParser->AddOption("max-threads");
+  optParser->AddOption("omp-schedule");
+  optParser->AddOption("omp-tile-size");
 
   /* parse the command line:  */
   optParser->ParseCommandLine( argc, argv );
@@ -315,6 +357,44 @@ void ProcessInput( int argc, char *argv[], commandOptions *theOptions )
   if (optParser->FlagSet("nosubsampling")) {
     theOptions->subsamplingFlag = false;
   }
+  if (optParser->FlagSet("compare-schedules")) {
+    theOptions->compareSchedules = true;
+  }
+  if (optParser->OptionSet("max-threads")) {
+    if (NotANumber(optParser->GetTargetString("max-threads").c_str(), 0, kPosInt)) {
+      fprintf(stderr, "*** ERROR: max-threads should be a positive integer!\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->maxThreads = atol(optParser->GetTargetString("max-threads").c_str());
+  }
+  if (optParser->OptionSet("omp-schedule")) {
+    string  scheduleName = optParser->GetTargetString("omp-schedule");
+    if (scheduleName == "static")
+      theOptions->ompScheduleType = OMP_SCHEDULE_STATIC;
+    else if (scheduleName == "dynamic")
+      theOptions->ompScheduleType = OMP_SCHEDULE_DYNAMIC;
+    else if (scheduleName == "guided")
+      theOptions->ompScheduleType = OMP_SCHEDULE_GUIDED;
+    else {
+      fprintf(stderr, "*** ERROR: omp-schedule should be \"static\", \"dynamic\", or \"guided\"!\n");
+      delete optParser;
+      exit(1);
+    }
+  }
+  if (optParser->OptionSet("omp-tile-size")) {
+    vector<string>  tileSizeStrings;
+    SplitString(optParser->GetTargetString("omp-tile-size"), tileSizeStrings, ",");
+    if ((tileSizeStrings.size() != 2) || (NotANumber(tileSizeStrings[0].c_str(), 0, kPosInt))
+    		|| (NotANumber(tileSizeStrings[1].c_str(), 0, kAnyInt))
+    		|| (atol(tileSizeStrings[1].c_str()) < 0)) {
+      fprintf(stderr, "*** ERROR: omp-tile-size should be of the form <n_rows>,<n_columns>!\n");
+      delete optParser;
+      exit(1);
+    }
+    theOptions->ompTileRows = atol(tileSizeStrings[0].c_str());
+    theOptions->ompTileColumns = atol(tileSizeStrings[1].c_str());
+  }
   if (optParser->OptionSet("output")) {
     theOptions->outputImageName = optParser->GetTargetString("output");
     theOptions->noImageName = false;
@@ -367,3 +447,63 @@ void ProcessInput( int argc, char *argv[], commandOptions *theOptions )
   delete optParser;
 
 }
+
+
+
+/// Returns mean time (in seconds) per call to theModel->CreateModelImage()
+double TimeImageGeneration( ModelObject *theModel, double *paramsVect, int nIterations )
+{
+  struct timeval  timer_start, timer_end;
+  double  microsecs, time_elapsed;
+
+  gettimeofday(&timer_start, NULL);
+  for (int ii = 0; ii < nIterations; ii++)
+    theModel->CreateModelImage(paramsVect);
+  gettimeofday(&timer_end, NULL);
+  microsecs = timer_end.tv_usec - timer_start.tv_usec;
+  time_elapsed = timer_end.tv_sec - timer_start.tv_sec + microsecs/1e6;
+  return time_elapsed/nIterations;
+}
+
+
+
+/// Times image generation for different OpenMP scheduling schemes, using first
+/// a single thread and then maxThreads threads (0 = all available)
+void CompareSchedules( ModelObject *theModel, double *paramsVect, int nIterations,
+						int maxThreads )
+{
+  const char  *scheduleNames[3] = {"static", "dynamic", "guided"};
+  // original scheme (bands of 10 full rows, static) first, then 2D tiles
+  int  scheduleTypes[4] = {OMP_SCHEDULE_STATIC, OMP_SCHEDULE_STATIC, OMP_SCHEDULE_DYNAMIC,
+  							OMP_SCHEDULE_GUIDED};
+  int  tileRows[4] = {10, DEFAULT_OMP_TILE_ROWS, DEFAULT_OMP_TILE_ROWS, DEFAULT_OMP_TILE_ROWS};
+  int  tileColumns[4] = {0, DEFAULT_OMP_TILE_COLUMNS, DEFAULT_OMP_TILE_COLUMNS, 
+  							DEFAULT_OMP_TILE_COLUMNS};
+  int  nThreads = 1;
+  double  time1, timeN, speedup;
+
+#ifdef USE_OPENMP
+  nThreads = (maxThreads > 0) ? maxThreads : omp_get_num_procs();
+#endif
+  printf("\nComparing OpenMP schedules (%d iterations each; %d threads):\n", 
+  		nIterations, nThreads);
+  printf("  schedule   tile (rows x cols)   t(1 thread)   t(%d threads)   speedup   efficiency\n",
+  		nThreads);
+  for (int k = 0; k < 4; k++) {
+    theModel->SetOMPSchedule(scheduleTypes[k]);
+    theModel->SetOMPTileSize(tileRows[k], tileColumns[k]);
+    theModel->SetMaxThreads(1);
+    theModel->CreateModelImage(paramsVect);   // warm-up
+    time1 = TimeImageGeneration(theModel, paramsVect, nIterations);
+    theModel->SetMaxThreads(nThreads);
+    theModel->CreateModelImage(paramsVect);
+    timeN = TimeImageGeneration(theModel, paramsVect, nIterations);
+    speedup = time1/timeN;
+    if (tileColumns[k] > 0)
+      printf("  %-8s   %4d x %-4d          ", scheduleNames[scheduleTypes[k]], tileRows[k],
+      		tileColumns[k]);
+    else
+      printf("  %-8s   %4d x full          ", scheduleNames[scheduleTypes[k]], tileRows[k]);
+    printf("%10.5f s   %10.5f s   %7.2f   %10.2f\n", time1, timeN, speedup, speedup/nThreads);
+  }
+}
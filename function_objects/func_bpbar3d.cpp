@@ -123,7 +123,6 @@ BPBar3D::BPBar3D( )
   
   // Stuff related to GSL integration  
   gsl_set_error_handler_off();
-  F.function = LuminosityDensity_BPBar3D;
   
   doSubsampling = false;
 }
@@ -207,6 +206,7 @@ double BPBar3D::GetValue( double x, double y )
   double  y_diff = y - y0;
   double  xp, yp, x_d0, y_d0, z_d0, totalIntensity, error;
   double  xyParameters[20];
+  gsl_function  F;   // local, for thread safety
   int  nSubsamples;
   int  nEvals;
   
@@ -244,6 +244,7 @@ double BPBar3D::GetValue( double x, double y )
   xyParameters[17] = z_bp_max;
   xyParameters[18] = h_bp;
   xyParameters[19] = twosigma_squared;
+  F.function = LuminosityDensity_BPBar3D;
   F.params = xyParameters;
 
   // printf("Calling Integrate...\n");
@@ -59,7 +59,6 @@ class BPBar3D : public FunctionObject
     double  PA_rad, cosPA, sinPA, barPA_rad, cosBarPA, sinBarPA;   // other useful quantities
     double  inc_rad, cosInc, sinInc, twosigma_squared;
     double  integrationLimit;
-    gsl_function  F;
 };
 
 #endif /* _FUNC_BPBAR3D_ */
@@ -124,6 +124,9 @@ void BrokenExponential::Setup( double params[], int offsetIndex, double xc, doub
   double  S = pow( (1.0 + exp(-alpha*r_b)), (-exponent) );
   I_0_times_S = I_0 * S;
   delta_Rb_scaled = r_b/h2 - r_b/h1;
+
+  if (useProfileTable)
+    profileTable.Build(this, &BrokenExponential::CalculateIntensity);
 }
 
 
@@ -137,6 +140,9 @@ double BrokenExponential::CalculateIntensity( double r )
 {
   double  I;
   
+  if (profileTable.Covers(r))
+    return profileTable.Interpolate(r);
+  
   // check for possible overflow in exponentiation if r >> r_b, and re-route around it:
   if ( alpha*(r - r_b) > 100.0 ) {
     // Outer-exponential approximation:
@@ -192,6 +198,26 @@ double BrokenExponential::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+// Row-oriented version of GetValue (see FunctionObject::GetEllipticalRowValues).
+
+void BrokenExponential::GetValues( double y, double xStart, double xStep, int nPixels, 
+						double outputVals[] )
+{
+  GetEllipticalRowValues(y, xStart, xStep, nPixels, x0, y0, cosPA, sinPA, q, outputVals);
+}
+
+
+/* ---------------- PROTECTED METHOD: CalculateIntensities ------------- */
+// Converts nValues radii to intensities (in place).
+
+void BrokenExponential::CalculateIntensities( int nValues, double values[] )
+{
+  for (int k = 0; k < nValues; k++)
+    values[k] = CalculateIntensity(values[k]);
+}
+
+
 /* ---------------- PROTECTED METHOD: CalculateSubsamples ------------------------- */
 // Function which determines the number of pixel subdivisions for sub-pixel integration,
 // given that the current pixel is a distance of r away from the center of the
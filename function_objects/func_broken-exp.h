@@ -42,6 +42,9 @@ class BrokenExponential : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  CanUseProfileTable( ) { return true; };
+    void  GetValues( double y, double xStart, double xStep, int nPixels, 
+    					double outputVals[] );
     // No destructor for now
 
     // class method for returning official short name of class
@@ -51,6 +54,7 @@ class BrokenExponential : public FunctionObject
   protected:
     double CalculateIntensity( double r );
     int  CalculateSubsamples( double r );
+    void  CalculateIntensities( int nValues, double values[] );
 
 
   private:
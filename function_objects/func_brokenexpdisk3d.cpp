@@ -99,7 +99,6 @@ BrokenExponentialDisk3D::BrokenExponentialDisk3D( )
 
   // Stuff related to GSL integration  
   gsl_set_error_handler_off();
-  F.function = LuminosityDensityBED;
   
   doSubsampling = false;
 }
@@ -172,6 +171,7 @@ double BrokenExponentialDisk3D::GetValue( double x, double y )
   double  xp, yp, x_d0, y_d0, z_d0, totalIntensity;
   double  integLimit;
   double  xyParameters[16];
+  gsl_function  F;   // local, for thread safety
   
   // Calculate x,y in component (projected sky) reference frame
   xp = x_diff*cosPA + y_diff*sinPA;
@@ -201,6 +201,7 @@ double BrokenExponentialDisk3D::GetValue( double x, double y )
   xyParameters[13] = scaledZ0;
   xyParameters[14] = two_to_alpha;
   xyParameters[15] = alphaVert;
+  F.function = LuminosityDensityBED;
   F.params = xyParameters;
 
   // integrate out to +/- integLimit, which is larger of (multiple of break radius)
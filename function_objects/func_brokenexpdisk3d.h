@@ -56,6 +56,5 @@ class BrokenExponentialDisk3D : public FunctionObject
     double  PA_rad, cosPA, sinPA, inc_rad, cosInc, sinInc;   // other useful quantities
     double  exponent, J_0_times_S, delta_Rb_scaled;
     double  scaledZ0, two_to_alpha, alphaVert;
-    gsl_function  F;
 };
 
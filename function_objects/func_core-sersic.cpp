@@ -132,6 +132,9 @@ void CoreSersic::Setup( double params[], int offsetIndex, double xc, double yc )
   bn = Calculate_bn(n);
   invn = 1.0 / n;
   Iprime = I_b * pow(2.0, -gamma/alpha) * exp( bn * pow( pow(2.0, 1.0/alpha) * r_b/r_e, (1.0/n) ));
+
+  if (useProfileTable)
+    profileTable.Build(this, &CoreSersic::CalculateIntensity);
 }
 
 
@@ -144,6 +147,9 @@ double CoreSersic::CalculateIntensity( double r )
 {
   double  powerlaw_part, exp_part, intensity;
   
+  if (profileTable.Covers(r))
+    return profileTable.Interpolate(r);
+  
   // kludge to handle cases when r is very close to zero:
   if (r < R_MIN)
     r = R_MIN;
@@ -41,6 +41,7 @@ class CoreSersic : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  CanUseProfileTable( ) { return true; };
     // No destructor for now
 
     // class method for returning official short name of class
@@ -49,6 +49,8 @@
 #include <string>
 
 #include "func_exp.h"
+#include "simd_kernels.h"
+#include "helper_funcs.h"
 
 using namespace std;
 
@@ -115,6 +117,9 @@ void Exponential::Setup( double params[], int offsetIndex, double xc, double yc
   PA_rad = (PA + 90.0) * DEG2RAD;
   cosPA = cos(PA_rad);
   sinPA = sin(PA_rad);
+
+  if (useProfileTable)
+    profileTable.Build(this, &Exponential::CalculateIntensity);
 }
 
 
@@ -125,6 +130,8 @@ void Exponential::Setup( double params[], int offsetIndex, double xc, double yc
 
 double Exponential::CalculateIntensity( double r )
 {
+  if (profileTable.Covers(r))
+    return profileTable.Interpolate(r);
   return I_0 * exp(-r/h);
 }
 
@@ -172,6 +179,45 @@ double Exponential::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+// Row-oriented version of GetValue (see FunctionObject::GetEllipticalRowValues).
+
+void Exponential::GetValues( double y, double xStart, double xStep, int nPixels, 
+						double outputVals[] )
+{
+  GetEllipticalRowValues(y, xStart, xStep, nPixels, x0, y0, cosPA, sinPA, q, outputVals);
+}
+
+
+/* ---------------- PROTECTED METHOD: CalculateIntensities ------------- */
+// Converts nValues radii to intensities (in place), using the profile table if
+// it's in use and a vectorized kernel (see simd_kernels.cpp) otherwise.
+
+void Exponential::CalculateIntensities( int nValues, double values[] )
+{
+  if (useProfileTable) {
+    for (int k = 0; k < nValues; k++)
+      values[k] = CalculateIntensity(values[k]);
+  }
+  else
+    ExponentialIntensities(nValues, values, I_0, h);
+}
+
+
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// Footprint = ellipse at which the intensity falls to footprintFraction times the
+// central intensity, i.e., r = -h ln(fraction)
+
+bool Exponential::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  if ((footprintFraction <= 0.0) || (footprintFraction >= 1.0))
+    return false;
+  double  r_fp = -h * log(footprintFraction);
+  EllipseBoundingBox(x0, y0, r_fp, q, cosPA, sinPA, xMin, xMax, yMin, yMax);
+  return true;
+}
+
+
 /* ---------------- PROTECTED METHOD: CalculateSubsamples ------------------------- */
 // Function which determines the number of pixel subdivisions for sub-pixel integration,
 // given that the current pixel is a distance of r away from the center of the
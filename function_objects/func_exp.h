@@ -41,6 +41,10 @@ class Exponential : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  CanUseProfileTable( ) { return true; };
+    void  GetValues( double y, double xStart, double xStep, int nPixels, 
+    					double outputVals[] );
+    bool  GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax );
     bool CanCalculateTotalFlux(  );
     double TotalFlux( );
    // No destructor for now
@@ -51,6 +55,7 @@ class Exponential : public FunctionObject
   protected:
     double CalculateIntensity( double r );
     int  CalculateSubsamples( double r );
+    void  CalculateIntensities( int nValues, double values[] );
 
 
   private:
@@ -122,7 +122,6 @@ ExponentialDisk3D::ExponentialDisk3D( )
 
   // Stuff related to GSL integration  
   gsl_set_error_handler_off();
-  F.function = LuminosityDensity;
   
   doSubsampling = false;
 }
@@ -181,6 +180,7 @@ double ExponentialDisk3D::GetValue( double x, double y )
   double  xp, yp, x_d0, y_d0, z_d0, totalIntensity;
   double  integLimit;
   double  xyParameters[11];
+  gsl_function  F;   // local, for thread safety
 //   int  nSubsamples;
   
   // Calculate x,y in component (projected sky) reference frame
@@ -206,6 +206,7 @@ double ExponentialDisk3D::GetValue( double x, double y )
   xyParameters[8] = scaledZ0;
   xyParameters[9] = two_to_alpha;
   xyParameters[10] = alpha;
+  F.function = LuminosityDensity;
   F.params = xyParameters;
 
   // integrate out to +/- integLimit, which is multiple of exp. scale length
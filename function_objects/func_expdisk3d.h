@@ -43,6 +43,5 @@ class ExponentialDisk3D : public FunctionObject
     double  x0, y0, PA, inclination, J_0, h, n, z_0;   // parameters
     double  PA_rad, cosPA, sinPA, inc_rad, cosInc, sinInc;   // other useful quantities
     double  scaledZ0, two_to_alpha, alpha;
-    gsl_function  F;
 };
 
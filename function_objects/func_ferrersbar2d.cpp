@@ -207,6 +207,17 @@ double FerrersBar2D::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// Since the intensity is exactly zero for r > a_bar, the footprint is always
+// the (generalized) ellipse with semi-major axis = a_bar
+
+bool FerrersBar2D::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  GeneralizedEllipseBoundingBox(x0, y0, a_bar, q, cosPA, sinPA, xMin, xMax, yMin, yMax);
+  return true;
+}
+
+
 /* ---------------- PROTECTED METHOD: CalculateSubsamples ------------------------- */
 // Function which determines the number of pixel subdivisions for sub-pixel integration,
 // given that the current pixel is a distance of r away from the center of the
@@ -42,6 +42,7 @@ class FerrersBar2D : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax );
     // No destructor for now
 
     // class method for returning official short name of class
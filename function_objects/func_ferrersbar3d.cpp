@@ -96,7 +96,6 @@ FerrersBar3D::FerrersBar3D( )
 
   // Stuff related to GSL integration  
   gsl_set_error_handler_off();
-  F.function = LuminosityDensity_FerrersBar;
   
   doSubsampling = false;
 }
@@ -151,18 +150,8 @@ void FerrersBar3D::Setup( double params[], int offsetIndex, double xc, double yc
   a2 = R_bar*R_bar;
   b2 = q*q*a2;
   c2 = q_z*q_z*a2;
-
-  // for Ferrers bar, which has zero luminosity density outside its boundaries,
-  // the maximum integLimit can be defined as the larger of R_bar*sin(inc) 
-  // [imagine end-on bar inclined w.r.t. line of sight] and c [in the case
-  // of a face-on Ferrers bar]
-  
-  // Possible approach: determine distance from sky plane to major-axis "spine"
-  // of bar [fails for perfectly end-on bar!], then work out +/- integration
-  // distance around that 
-  
-  integrationLimit = 1.01 * max((sqrt(b2)*sinInc), R_bar);
-//  integrationLimit = 1.01*sqrt(b2);
+  // Note that the Ferrers bar has zero luminosity density outside its boundaries,
+  // so in GetValue we integrate only along the actual chord through the ellipsoid
 }
 
 
@@ -173,7 +162,9 @@ double FerrersBar3D::GetValue( double x, double y )
   double  x_diff = x - x0;
   double  y_diff = y - y0;
   double  xp, yp, x_d0, y_d0, z_d0, totalIntensity;
+  double  s1, s2;
   double  xyParameters[12];
+  gsl_function  F;   // local, for thread safety
 //   int  nSubsamples;
   
   // Calculate x,y in component (projected sky) reference frame, corrected for
@@ -201,14 +192,16 @@ double FerrersBar3D::GetValue( double x, double y )
   xyParameters[9] = b2;
   xyParameters[10] = c2;
   xyParameters[11] = n;
+  F.function = LuminosityDensity_FerrersBar;
   F.params = xyParameters;
 
-  // [] NOTE: ideally, we should compute the integration limits directly, given
-  // the known orientation of the ellipsoid, as the inner and outer boundaries of
-  // the ellipsoid along the current line of sight; this would be superior to our current
-  // -number,+number integration...
-  // integrate out to +/- integLimit
-  totalIntensity = Integrate(F, -integrationLimit, integrationLimit);
+  // Integrate between the points where the line of sight enters and exits the
+  // ellipsoid (NOTE: m2 = y_bar^2/a2 + x_bar^2/b2 + z_bar^2/c2 in luminosity-density
+  // function, so semi-axes along x_bar,y_bar are sqrt(b2),sqrt(a2))
+  if (! EllipsoidChord(x_d0, y_d0, z_d0, sinInc, cosInc, cosBarPA, sinBarPA, b2, a2, c2, 
+  						s1, s2))
+    return 0.0;
+  totalIntensity = IntegrateBounded(F, s1, s2);
 
   return totalIntensity;
 }
@@ -54,7 +54,6 @@ class FerrersBar3D : public FunctionObject
   private:
     double  x0, y0, PA, inclination, barPA, J_0, R_bar, q, q_z, n;   // parameters
     double  PA_rad, cosPA, sinPA, barPA_rad, cosBarPA, sinBarPA;   // other useful quantities
-    double  inc_rad, cosInc, sinInc, a2, b2, c2, integrationLimit;
-    gsl_function  F;
+    double  inc_rad, cosInc, sinInc, a2, b2, c2;
 };
 
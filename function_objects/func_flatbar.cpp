@@ -47,6 +47,7 @@
 #include <tuple>
 
 #include "func_flatbar.h"
+#include "helper_funcs.h"
 
 using namespace std;
 
@@ -225,6 +226,22 @@ double FlatBar::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// The profile is not truncated, so we use a conservative estimate: the intensity
+// is always <= I_0 exp(-(r - r_b/q)/h_max), where h_max = max(h1,h2) and r_b/q is
+// the largest possible (adjusted) break radius
+
+bool FlatBar::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  if ((footprintFraction <= 0.0) || (footprintFraction >= 1.0))
+    return false;
+  double  h_max = (h1 > h2) ? h1 : h2;
+  double  r_fp = r_b/q - h_max*log(footprintFraction);
+  EllipseBoundingBox(x0, y0, r_fp, q, cosPA, sinPA, xMin, xMax, yMin, yMax);
+  return true;
+}
+
+
 /* ---------------- PROTECTED METHOD: CalculateSubsamples ------------------------- */
 // Function which determines the number of pixel subdivisions for sub-pixel integration,
 // given that the current pixel is a distance of r away from the center of the
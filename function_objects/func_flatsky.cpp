@@ -98,5 +98,15 @@ double FlatSky::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+
+void FlatSky::GetValues( double y, double xStart, double xStep, int nPixels, 
+						double outputVals[] )
+{
+  for (int k = 0; k < nPixels; k++)
+    outputVals[k] = I_sky;
+}
+
+
 
 /* END OF FILE: func_flatsky.cpp --------------------------------------- */
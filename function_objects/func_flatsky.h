@@ -29,6 +29,9 @@ class FlatSky : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    void  GetValues( double y, double xStart, double xStep, int nPixels, 
+    					double outputVals[] );
+    bool  IsPlanar( ) { return true; };
     // No destructor for now
 
     // class method for returning official short name of class
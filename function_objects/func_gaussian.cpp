@@ -48,6 +48,8 @@
 #include <string>
 
 #include "func_gaussian.h"
+#include "simd_kernels.h"
+#include "helper_funcs.h"
 
 using namespace std;
 
@@ -117,6 +119,9 @@ void Gaussian::Setup( double params[], int offsetIndex, double xc, double yc )
   cosPA = cos(PA_rad);
   sinPA = sin(PA_rad);
   twosigma_squared = 2.0 * sigma*sigma;
+
+  if (useProfileTable)
+    profileTable.Build(this, &Gaussian::CalculateIntensity);
 }
 
 
@@ -128,6 +133,9 @@ double Gaussian::CalculateIntensity( double r )
 {
   double  r_squared = r*r;
   
+  if (profileTable.Covers(r))
+    return profileTable.Interpolate(r);
+  
   return I_0 * exp(-r_squared/twosigma_squared);
 }
 
@@ -179,6 +187,45 @@ double Gaussian::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+// Row-oriented version of GetValue (see FunctionObject::GetEllipticalRowValues).
+
+void Gaussian::GetValues( double y, double xStart, double xStep, int nPixels, 
+						double outputVals[] )
+{
+  GetEllipticalRowValues(y, xStart, xStep, nPixels, x0, y0, cosPA, sinPA, q, outputVals);
+}
+
+
+/* ---------------- PROTECTED METHOD: CalculateIntensities ------------- */
+// Converts nValues radii to intensities (in place), using the profile table if
+// it's in use and a vectorized kernel (see simd_kernels.cpp) otherwise.
+
+void Gaussian::CalculateIntensities( int nValues, double values[] )
+{
+  if (useProfileTable) {
+    for (int k = 0; k < nValues; k++)
+      values[k] = CalculateIntensity(values[k]);
+  }
+  else
+    GaussianIntensities(nValues, values, I_0, twosigma_squared);
+}
+
+
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// Footprint = ellipse at which the intensity falls to footprintFraction times the
+// central intensity, i.e., r = sigma [-2 ln(fraction)]^(1/2)
+
+bool Gaussian::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  if ((footprintFraction <= 0.0) || (footprintFraction >= 1.0))
+    return false;
+  double  r_fp = sigma * sqrt(-2.0*log(footprintFraction));
+  EllipseBoundingBox(x0, y0, r_fp, q, cosPA, sinPA, xMin, xMax, yMin, yMax);
+  return true;
+}
+
+
 /* ---------------- PROTECTED METHOD: CalculateSubsamples ------------------------- */
 // Function which determines the number of pixel subdivisions for sub-pixel integration,
 // given that the current pixel is a distance of r away from the center of the
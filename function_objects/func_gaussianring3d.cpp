@@ -99,7 +99,6 @@ GaussianRing3D::GaussianRing3D( )
 
   // Stuff related to GSL integration
   gsl_set_error_handler_off();
-  F.function = LuminosityDensityRing;
   
   doSubsampling = false;
 }
@@ -173,6 +172,7 @@ double GaussianRing3D::GetValue( double x, double y )
   double  xp, yp, x_d0, y_d0, z_d0, totalIntensity;
   double  integLimit;
   double  xyParameters[12];
+  gsl_function  F;   // local, for thread safety
 //   int  nSubsamples;
   
   // Calculate x,y in component's (projected sky) reference frame: xp,yp
@@ -199,6 +199,7 @@ double GaussianRing3D::GetValue( double x, double y )
   xyParameters[9] = a_ring;
   xyParameters[10] = h_z;
   xyParameters[11] = twosigma_squared;
+  F.function = LuminosityDensityRing;
   F.params = xyParameters;
 
   // integrate out to +/- integLimit, which is multiple of ring radius
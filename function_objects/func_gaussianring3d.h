@@ -57,6 +57,5 @@ class GaussianRing3D : public FunctionObject
     double  x0, y0, PA, inclination, ringPA, ell, J_0, a_ring, sigma, h_z;   // parameters
     double  cosPA, sinPA, cosInc, sinInc;   // other useful quantities
     double  cosRingPA, sinRingPA, q, twosigma_squared;
-    gsl_function  F;
 };
 
@@ -46,6 +46,7 @@
 #include <string>
 
 #include "func_king.h"
+#include "helper_funcs.h"
 
 using namespace std;
 
@@ -122,6 +123,9 @@ void ModifiedKing::Setup( double params[], int offsetIndex, double xc, double yc
   one_over_rc = 1.0 / r_c;
   constantTerm = 1.0 / pow(1.0 + (r_t/r_c)*(r_t/r_c), one_over_alpha);
   I_1 = I_0 * pow(1.0 - constantTerm, -alpha);
+
+  if (useProfileTable)
+    profileTable.Build(this, &ModifiedKing::CalculateIntensity);
 }
 
 
@@ -132,6 +136,8 @@ double ModifiedKing::CalculateIntensity( double r )
 {
   double  intensity = 0.0;
   if (r < r_t) {  // ensure we return 0 when r >= r_t
+    if (profileTable.Covers(r))
+      return profileTable.Interpolate(r);
     double  r_over_rc = r * one_over_rc;
     double  variableTerm = 1.0 / pow(1.0 + r_over_rc*r_over_rc, one_over_alpha);
     double  secondPart = pow(variableTerm - constantTerm, alpha);
@@ -185,6 +191,17 @@ double ModifiedKing::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// Since the intensity is exactly zero for r >= r_t, the footprint is always
+// the ellipse with semi-major axis = r_t
+
+bool ModifiedKing::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  EllipseBoundingBox(x0, y0, r_t, q, cosPA, sinPA, xMin, xMax, yMin, yMax);
+  return true;
+}
+
+
 /* ---------------- PROTECTED METHOD: CalculateSubsamples ------------------------- */
 /// Function which determines the number of pixel subdivisions for sub-pixel integration,
 /// given that the current pixel is a distance of r away from the center of the
@@ -55,6 +55,8 @@
 #include <algorithm>
 
 #include "func_moffat.h"
+#include "simd_kernels.h"
+#include "helper_funcs.h"
 
 using namespace std;
 
@@ -127,6 +129,9 @@ void Moffat::Setup( double params[], int offsetIndex, double xc, double yc )
   // compute alpha:
   double  exponent = pow(2.0, 1.0/beta);
   alpha = 0.5*fwhm/sqrt(exponent - 1.0);
+
+  if (useProfileTable)
+    profileTable.Build(this, &Moffat::CalculateIntensity);
 }
 
 
@@ -139,6 +144,9 @@ double Moffat::CalculateIntensity( double r )
 {
   double  scaledR, denominator;
   
+  if (profileTable.Covers(r))
+    return profileTable.Interpolate(r);
+  
   scaledR = r / alpha;
   denominator = pow((1.0 + scaledR*scaledR), beta);
   return (I_0 / denominator);
@@ -192,6 +200,45 @@ double Moffat::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+// Row-oriented version of GetValue (see FunctionObject::GetEllipticalRowValues).
+
+void Moffat::GetValues( double y, double xStart, double xStep, int nPixels, 
+						double outputVals[] )
+{
+  GetEllipticalRowValues(y, xStart, xStep, nPixels, x0, y0, cosPA, sinPA, q, outputVals);
+}
+
+
+/* ---------------- PROTECTED METHOD: CalculateIntensities ------------- */
+// Converts nValues radii to intensities (in place), using the profile table if
+// it's in use and a vectorized kernel (see simd_kernels.cpp) otherwise.
+
+void Moffat::CalculateIntensities( int nValues, double values[] )
+{
+  if (useProfileTable) {
+    for (int k = 0; k < nValues; k++)
+      values[k] = CalculateIntensity(values[k]);
+  }
+  else
+    MoffatIntensities(nValues, values, I_0, alpha, beta);
+}
+
+
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// Footprint = ellipse at which the intensity falls to footprintFraction times the
+// central intensity, i.e., r = alpha [fraction^(-1/beta) - 1]^(1/2)
+
+bool Moffat::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  if ((footprintFraction <= 0.0) || (footprintFraction >= 1.0))
+    return false;
+  double  r_fp = alpha * sqrt(pow(footprintFraction, -1.0/beta) - 1.0);
+  EllipseBoundingBox(x0, y0, r_fp, q, cosPA, sinPA, xMin, xMax, yMin, yMax);
+  return true;
+}
+
+
 /* ---------------- PROTECTED METHOD: CalculateSubsamples ------------------------- */
 // Function which determines the number of pixel subdivisions for sub-pixel integration,
 // given that the current pixel is a distance of r away from the center of the
@@ -35,6 +35,10 @@ class Moffat : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  CanUseProfileTable( ) { return true; };
+    void  GetValues( double y, double xStart, double xStep, int nPixels, 
+    					double outputVals[] );
+    bool  GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax );
     // No destructor for now
 
     // class method for returning official short name of class
@@ -44,6 +48,7 @@ class Moffat : public FunctionObject
   protected:
     double CalculateIntensity( double r );
     int  CalculateSubsamples( double r );
+    void  CalculateIntensities( int nValues, double values[] );
 
 
   private:
@@ -53,7 +53,6 @@ class N4608Disk : public FunctionObject
 
   protected:
     double CalculateIntensity( double r );
-    int  CalculateSubsamples( double r );
 
 
   private:
@@ -130,6 +130,9 @@ void NukerLaw::Setup( double params[], int offsetIndex, double xc, double yc )
 
   exponent = (beta - gamma)/alpha;
   Iprime = I_b * pow(2.0, exponent);
+
+  if (useProfileTable)
+    profileTable.Build(this, &NukerLaw::CalculateIntensity);
 }
 
 
@@ -141,6 +144,9 @@ double NukerLaw::CalculateIntensity( double r )
 {
   double  I1, I2;
   
+  if (profileTable.Covers(r))
+    return profileTable.Interpolate(r);
+  
   // kludge to handle cases when r is very close to zero:
   if (r < R_MIN)
     r = R_MIN;
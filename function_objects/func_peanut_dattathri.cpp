@@ -91,7 +91,6 @@ DattathriPeanut3D::DattathriPeanut3D( )
 
   // Stuff related to GSL integration  
   gsl_set_error_handler_off();
-  F.function = LuminosityDensityDattathriPeanut3D;
   
   doSubsampling = false;
 }
@@ -166,6 +165,7 @@ double DattathriPeanut3D::GetValue( double x, double y )
   double  xp, yp, x_d0, y_d0, z_d0, totalIntensity;
   double  integLimit;
   double  xyParameters[16];
+  gsl_function  F;   // local, for thread safety
 //   int  nSubsamples;
   
   // Calculate x,y in component (projected sky) reference frame
@@ -196,6 +196,7 @@ double DattathriPeanut3D::GetValue( double x, double y )
   xyParameters[13] = sinInc;
   xyParameters[14] = cosPsi;
   xyParameters[15] = sinPsi;
+  F.function = LuminosityDensityDattathriPeanut3D;
   F.params = xyParameters;
 
   // integrate out to +/- integLimit, which is multiple of exp. scale length
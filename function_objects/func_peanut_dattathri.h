@@ -41,6 +41,5 @@ class DattathriPeanut3D : public FunctionObject
     		sigma_peanut, c_bar_par, c_bar_perp;   // parameters
     double  PA_rad, cosPA, sinPA, inc_rad, cosInc, sinInc, cosPsi, sinPsi;   // other useful quantities
     double  R_bar_y, R_bar_z;   // other useful quantities
-    gsl_function  F;
 };
 
@@ -19,6 +19,7 @@
  *       = Sum_i (I_tot * I_norm,i)
  *
  *   MODIFICATION HISTORY:
+ *     17 Oct 2026: Added GetFootprint (region covered by PSF image).
  *     11 Aug 2021: Created (as modification of func_pointsource.cpp).
  */
 
@@ -45,6 +46,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <string>
+#include <algorithm>
 
 #include "func_pointsource-rot.h"
 #include "psf_interpolators.h"
@@ -123,7 +125,7 @@ void PointSourceRot::SetOversamplingScale( int oversampleScale )
 
 void PointSourceRot::AddPsfData( double *psfPixels, int nColumns_psf, int nRows_psf )
 {
-  psfInterpolator = new PsfInterpolator_bicubic(psfPixels, nColumns_psf, nRows_psf);
+  psfInterpolator = new PsfInterpolator_bicubic_native(psfPixels, nColumns_psf, nRows_psf);
   interpolatorAllocated = true;
 }
 
@@ -237,6 +239,39 @@ double PointSourceRot::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// Footprint = bounding box of the rotated region covered by the (current) PSF 
+// image, centered on (x0,y0); GetValue returns 0 outside of this
+
+bool PointSourceRot::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  double  dxMin, dxMax, dyMin, dyMax;
+  double  xp, yp, x_diff, y_diff;
+
+  if (psfInterpolator == nullptr)
+    return false;
+  psfInterpolator->GetBounds(dxMin, dxMax, dyMin, dyMax);
+  xMin = yMin = 1.0e300;
+  xMax = yMax = -1.0e300;
+  // rotate corners of PSF region from component reference frame into image frame
+  for (int k = 0; k < 4; k++) {
+    xp = (k % 2 == 0) ? dxMin : dxMax;
+    yp = (k < 2) ? dyMin : dyMax;
+    x_diff = xp*cosPA - yp*sinPA;
+    y_diff = xp*sinPA + yp*cosPA;
+    xMin = min(xMin, x_diff);
+    xMax = max(xMax, x_diff);
+    yMin = min(yMin, y_diff);
+    yMax = max(yMax, y_diff);
+  }
+  xMin = x0 + xMin/oversamplingScale;
+  xMax = x0 + xMax/oversamplingScale;
+  yMin = y0 + yMin/oversamplingScale;
+  yMax = y0 + yMax/oversamplingScale;
+  return true;
+}
+
+
 
 /* ---------------- PUBLIC METHOD: CanCalculateTotalFlux --------------- */
 
@@ -41,6 +41,7 @@ class PointSourceRot : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax );
     bool CanCalculateTotalFlux(  );
     double TotalFlux( );
     
@@ -55,6 +56,6 @@ class PointSourceRot : public FunctionObject
     double  I_scaled;
     string  interpolationType = "bicubic";
     int  oversamplingScale;
-    PsfInterpolator *psfInterpolator;
+    PsfInterpolator *psfInterpolator = nullptr;
     bool interpolatorAllocated = false;
 };
@@ -19,6 +19,9 @@
  *       = Sum_i (I_tot * I_norm,i)
  *
  *   MODIFICATION HISTORY:
+ *     17 Oct 2026: Setup() now builds a copy of the PSF shifted to the current
+ *   position, so that GetValue() is normally a lookup instead of an interpolation.
+ *     17 Oct 2026: Added GetFootprint (region covered by PSF image).
  *     2 Oct 2017: Created (as modification of func_gaussian.cpp).
  */
 
@@ -111,9 +114,15 @@ string PointSource::GetInterpolationType( )
 
 /* ---------------- PUBLIC METHOD: SetOversamplingScale ---------------- */
 
+// Callers which change the interpolator should call AddPsfInterpolator first,
+// since this is where the shifted PSF stamp is rebuilt (if necessary)
 void PointSource::SetOversamplingScale( int oversampleScale )
 {
-  oversamplingScale = oversampleScale;
+  if ((oversampleScale != oversamplingScale) || (! shiftedStamp.ready)) {
+    oversamplingScale = oversampleScale;
+    if (setupDone)
+      UpdateShiftedStamp();
+  }
 }
 
 
@@ -122,16 +131,22 @@ void PointSource::SetOversamplingScale( int oversampleScale )
 
 void PointSource::AddPsfData( double *psfPixels, int nColumns_psf, int nRows_psf )
 {
-  psfInterpolator = new PsfInterpolator_bicubic(psfPixels, nColumns_psf, nRows_psf);
+  psfInterpolator = new PsfInterpolator_bicubic_native(psfPixels, nColumns_psf, nRows_psf);
   interpolatorAllocated = true;
+  shiftedStamp.Clear();
 }
 
 
 /* ---------------- PUBLIC METHOD: AddPsfInterpolator ------------------ */
 
+// The shifted PSF stamp is discarded (if the interpolator has changed) and
+// rebuilt by SetOversamplingScale or Setup
 void PointSource::AddPsfInterpolator( PsfInterpolator *theInterpolator )
 {
-  psfInterpolator = theInterpolator;
+  if (theInterpolator != psfInterpolator) {
+    psfInterpolator = theInterpolator;
+    shiftedStamp.Clear();
+  }
 }
 
 
@@ -208,6 +223,32 @@ void PointSource::Setup( double params[], int offsetIndex, double xc, double yc
   x0 = xc;
   y0 = yc;
   I_tot = params[0 + offsetIndex] * intensityScale;
+  setupDone = true;
+  UpdateShiftedStamp();
+}
+
+
+/* ---------------- PRIVATE METHOD: UpdateShiftedStamp ----------------- */
+// Builds the copy of the PSF shifted to (x0,y0) and sampled at the pixel
+// centers where GetValue will be called. Pixel centers x satisfy
+// oversamplingScale*x = integer + 0.5*(1 - oversamplingScale) -- i.e., integer
+// values of x for the main image, and the subpixel centers within an 
+// OversampledRegion (see OversampledRegion::ComputeRegionAndDownsample) -- so
+// the fractional shift of the lattice depends only on x0 and oversamplingScale.
+
+void PointSource::UpdateShiftedStamp( )
+{
+  double  gridOffset = 0.5*(1 - oversamplingScale);
+  double  xShift, yShift;
+
+  if (psfInterpolator == nullptr) {
+    shiftedStamp.Clear();
+    return;
+  }
+  xShift = gridOffset - oversamplingScale*x0;
+  yShift = gridOffset - oversamplingScale*y0;
+  psfInterpolator->MakeShiftedStamp(xShift - floor(xShift), yShift - floor(yShift), 
+  									shiftedStamp);
 }
 
 
@@ -216,6 +257,8 @@ void PointSource::Setup( double params[], int offsetIndex, double xc, double yc
 // coordinates (x,y).
 // Note that we multiply x_diff and y_diff by oversamplingScale so that this
 // will work correctly when called from an OversampledRegion object.
+// For pixel centers, we normally just look up the value in the shifted PSF
+// stamp; other positions are interpolated directly.
 
 double PointSource::GetValue( double x, double y )
 {
@@ -223,12 +266,32 @@ double PointSource::GetValue( double x, double y )
   double  y_diff = oversamplingScale*(y - y0);
   double  normalizedIntensity;
   
-  normalizedIntensity = psfInterpolator->GetValue(x_diff, y_diff);
+  if (! shiftedStamp.Lookup(x_diff, y_diff, normalizedIntensity))
+    normalizedIntensity = psfInterpolator->GetValue(x_diff, y_diff);
 
   return I_tot * normalizedIntensity;
 }
 
 
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// Footprint = region covered by the (current) PSF image, centered on (x0,y0);
+// GetValue returns 0 outside of this
+
+bool PointSource::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  double  dxMin, dxMax, dyMin, dyMax;
+
+  if (psfInterpolator == nullptr)
+    return false;
+  psfInterpolator->GetBounds(dxMin, dxMax, dyMin, dyMax);
+  xMin = x0 + dxMin/oversamplingScale;
+  xMax = x0 + dxMax/oversamplingScale;
+  yMin = y0 + dyMin/oversamplingScale;
+  yMax = y0 + dyMax/oversamplingScale;
+  return true;
+}
+
+
 
 /* ---------------- PUBLIC METHOD: CanCalculateTotalFlux --------------- */
 
@@ -39,6 +39,7 @@ class PointSource : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax );
     bool CanCalculateTotalFlux(  );
     double TotalFlux( );
     
@@ -48,10 +49,14 @@ class PointSource : public FunctionObject
 
 
   private:
+    void  UpdateShiftedStamp( );
+
     double  x0, y0, I_tot;   // parameters
     double  I_scaled;
     string  interpolationType = "bicubic";
     int  oversamplingScale;
-    PsfInterpolator *psfInterpolator;
+    PsfInterpolator *psfInterpolator = nullptr;
     bool interpolatorAllocated = false;
+    bool  setupDone = false;
+    ShiftedPsfStamp  shiftedStamp;   // PSF shifted to (x0,y0), sampled at pixel centers
 };
@@ -17,6 +17,8 @@
  * convert it to radians] relative to +x axis.
  *
  *   MODIFICATION HISTORY:
+ *     17 Oct 2026: Footprint now also large enough that the flux outside it is
+ * < footprintFraction of the total.
  *     [v0.4]  20--26 Mar 2010: Preliminary support for pixel subsampling.
  *     [v0.3]: 21 Jan 2010: Modified to treat x0,y0 as separate inputs.
  *     [v0.2]: 28 Nov 2009: Updated to new FunctionObject interface.
@@ -51,6 +53,7 @@
 #include <gsl/gsl_sf_gamma.h>
 
 #include "func_sersic.h"
+#include "simd_kernels.h"
 #include "helper_funcs.h"
 
 using namespace std;
@@ -64,6 +67,8 @@ const char  FUNCTION_NAME[] = "Sersic function";
 const double  DEG2RAD = 0.017453292519943295;
 const double PI = 3.14159265358979;
 const int  SUBSAMPLE_R = 10;
+// relative precision for the footprint radius set by the lost-flux criterion
+const double  FOOTPRINT_Z_TOLERANCE = 1.0e-6;
 
 const char Sersic::className[] = "Sersic";
 
@@ -124,6 +129,9 @@ void Sersic::Setup( double params[], int offsetIndex, double xc, double yc )
   sinPA = sin(PA_rad);
   bn = Calculate_bn(n);
   invn = 1.0 / n;
+
+  if (useProfileTable)
+    profileTable.Build(this, &Sersic::CalculateIntensity);
 }
 
 
@@ -136,6 +144,9 @@ double Sersic::CalculateIntensity( double r )
 {
   double  intensity;
   
+  if (profileTable.Covers(r))
+    return profileTable.Interpolate(r);
+  
   intensity = I_e * exp( -bn * (pow((r/r_e), invn) - 1.0));
   return intensity;
 }
@@ -188,6 +199,69 @@ double Sersic::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+// Row-oriented version of GetValue (see FunctionObject::GetEllipticalRowValues).
+
+void Sersic::GetValues( double y, double xStart, double xStep, int nPixels, 
+						double outputVals[] )
+{
+  GetEllipticalRowValues(y, xStart, xStep, nPixels, x0, y0, cosPA, sinPA, q, outputVals);
+}
+
+
+/* ---------------- PROTECTED METHOD: CalculateIntensities ------------- */
+// Converts nValues radii to intensities (in place), using the profile table if
+// it's in use and a vectorized kernel (see simd_kernels.cpp) otherwise.
+
+void Sersic::CalculateIntensities( int nValues, double values[] )
+{
+  if (useProfileTable) {
+    for (int k = 0; k < nValues; k++)
+      values[k] = CalculateIntensity(values[k]);
+  }
+  else
+    SersicIntensities(nValues, values, I_e, bn, invn, r_e);
+}
+
+
+/* ---------------- PUBLIC METHOD: GetFootprint ------------------------ */
+// Footprint = ellipse at which the intensity falls to footprintFraction times the
+// central intensity I_e exp(b_n), i.e., r = r_e [-ln(fraction)/b_n]^n -- or, if
+// larger, the ellipse outside of which only footprintFraction of the total flux
+// remains. (For high-n profiles, the central intensity is so large that the first
+// criterion alone would leave out a sizeable fraction of the total flux.) The 
+// fraction of the total flux outside r is Q(2n, b_n (r/r_e)^(1/n)), where Q is the
+// regularized upper incomplete gamma function.
+
+bool Sersic::GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  if ((footprintFraction <= 0.0) || (footprintFraction >= 1.0))
+    return false;
+  double  twoN = 2.0*n;
+  double  z_low = -log(footprintFraction);   // = b_n (r/r_e)^(1/n) for the first criterion
+  double  z_high = z_low;
+  if (gsl_sf_gamma_inc_Q(twoN, z_low) > footprintFraction) {
+    // bracket, then bisect, the value of z where Q(2n, z) = footprintFraction
+    // (small steps, to avoid underflow of Q for very small fractions)
+    z_high = 1.25*z_low;
+    while (gsl_sf_gamma_inc_Q(twoN, z_high) > footprintFraction) {
+      z_low = z_high;
+      z_high = 1.25*z_high;
+    }
+    while ((z_high - z_low) > FOOTPRINT_Z_TOLERANCE*z_high) {
+      double  z_mid = 0.5*(z_low + z_high);
+      if (gsl_sf_gamma_inc_Q(twoN, z_mid) > footprintFraction)
+        z_low = z_mid;
+      else
+        z_high = z_mid;
+    }
+  }
+  double  r_fp = r_e * pow(z_high/bn, n);
+  EllipseBoundingBox(x0, y0, r_fp, q, cosPA, sinPA, xMin, xMax, yMin, yMax);
+  return true;
+}
+
+
 /* ---------------- PROTECTED METHOD: CalculateSubsamples ------------------------- */
 // Function which determines the number of pixel subdivisions for sub-pixel integration,
 // given that the current pixel is a distance of r away from the center of the
@@ -39,6 +39,10 @@ class Sersic : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  CanUseProfileTable( ) { return true; };
+    void  GetValues( double y, double xStart, double xStep, int nPixels, 
+    					double outputVals[] );
+    bool  GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax );
     bool CanCalculateTotalFlux(  );
     double TotalFlux( );
     // No destructor for now
@@ -50,6 +54,7 @@ class Sersic : public FunctionObject
   protected:
     double CalculateIntensity( double r );
     int  CalculateSubsamples( double r );
+    void  CalculateIntensities( int nValues, double values[] );
 
 
   private:
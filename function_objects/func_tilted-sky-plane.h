@@ -29,6 +29,7 @@ class TiltedSkyPlane : public FunctionObject
 									double adjustedFunctionParams[], int offsetIndex );
     void  Setup( double params[], int offsetIndex, double xc, double yc );
     double  GetValue( double x, double y );
+    bool  IsPlanar( ) { return true; };
     // No destructor for now
 
     // class method for returning official short name of class
@@ -63,7 +63,10 @@ const char  FUNCTION_NAME[] = "TriaxBar3D function";
 const double  DEG2RAD = 0.017453292519943295;
 const int  SUBSAMPLE_R = 10;
 
-const double  INTEGRATION_MULTIPLIER = 2;
+// Luminosity density is < exp(-40) ~ 4e-18 times central value outside the ellipsoid
+// with r^2 = GAUSSIAN_TRUNCATION * twosigma_squared, so we only integrate along the
+// line-of-sight chord through that ellipsoid
+const double  GAUSSIAN_TRUNCATION = 40.0;
 
 const char TriaxBar3D::className[] = "TriaxBar3D";
 
@@ -93,7 +96,6 @@ TriaxBar3D::TriaxBar3D( )
 
   // Stuff related to GSL integration  
   gsl_set_error_handler_off();
-  F.function = LuminosityDensity_TriaxBar;
   
   doSubsampling = false;
 }
@@ -136,9 +138,10 @@ double TriaxBar3D::GetValue( double x, double y )
 {
   double  x_diff = x - x0;
   double  y_diff = y - y0;
-  double  xp, yp, x_d0, y_d0, z_d0, totalIntensity, error;
-  double  integLimit;
+  double  xp, yp, x_d0, y_d0, z_d0, totalIntensity;
+  double  s1, s2, r2_max;
   double  xyParameters[11];
+  gsl_function  F;   // local, for thread safety
   
   // Calculate x,y in component (projected sky) reference frame, corrected for
   // rotation of line of nodes
@@ -164,16 +167,16 @@ double TriaxBar3D::GetValue( double x, double y )
   xyParameters[8] = q;
   xyParameters[9] = q_z;
   xyParameters[10] = twosigma_squared;
+  F.function = LuminosityDensity_TriaxBar;
   F.params = xyParameters;
 
-  // [] NOTE: ideally, we should compute the integration limits directly, given
-  // the known orientation of the ellipsoid, as the inner and outer boundaries of
-  // the ellipsoid along the current line of sight; this would be superior to our current
-  // -number,+number integration...
-
-  // integrate out to +/- integLimit, which is multiple of Gaussian sigma^2
-  integLimit = INTEGRATION_MULTIPLIER * twosigma_squared;
-  totalIntensity = Integrate(F, -integLimit, integLimit);
+  // Integrate between the points where the line of sight enters and exits the
+  // truncation ellipsoid (semi-axes along x_bar,y_bar,z_bar = r_max, q*r_max, q_z*r_max)
+  r2_max = GAUSSIAN_TRUNCATION * twosigma_squared;
+  if (! EllipsoidChord(x_d0, y_d0, z_d0, sinInc, cosInc, cosBarPA, sinBarPA, r2_max, 
+  						q*q*r2_max, q_z*q_z*r2_max, s1, s2))
+    return 0.0;
+  totalIntensity = IntegrateBounded(F, s1, s2);
 
   return totalIntensity;
 }
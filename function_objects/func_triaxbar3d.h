@@ -52,6 +52,5 @@ class TriaxBar3D : public FunctionObject
     double  x0, y0, PA, inclination, barPA, J_0, sigma, q, q_z;   // parameters
     double  PA_rad, cosPA, sinPA, barPA_rad, cosBarPA, sinBarPA;   // other useful quantities
     double  inc_rad, cosInc, sinInc, twosigma_squared;
-    gsl_function  F;
 };
 
@@ -44,6 +44,8 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+#include <algorithm>
 #include <map>
 #include <string>
 
@@ -52,6 +54,10 @@
 
 using namespace std;
 
+// number of pixels per chunk in GetEllipticalRowValues (radii for one chunk are
+// kept on the stack)
+const int  ELLIPTICAL_ROW_CHUNK = 256;
+
 
 /* ---------------- Definitions ---------------------------------------- */
 
@@ -89,6 +95,36 @@ void FunctionObject::SetZeroPoint( double zeroPoint )
 }
 
 
+/* ---------------- PUBLIC METHOD: SetFootprintFraction ---------------- */
+/// Specify the intensity threshold, as a fraction of the function's central (peak)
+/// intensity, beyond which the function's contribution is considered negligible
+/// for the purposes of computing footprints (see GetFootprint); functions may use
+/// a larger footprint to limit the fraction of their total flux which is left
+/// out (e.g., Sersic, whose peak intensity can be >> I_e). Functions which
+/// are intrinsically truncated report their exact footprints regardless of this
+/// value; other functions only report footprints if fraction > 0.
+void FunctionObject::SetFootprintFraction( double fraction )
+{
+  footprintFraction = fraction;
+}
+
+
+/* ---------------- PUBLIC METHOD: UseProfileTable --------------------- */
+/// Turns on use of a lookup table (computed in Setup) for the radial intensity
+/// profile, extending to radius rMax; rMax <= 0 turns off use of the table.
+/// Has no effect for functions which cannot use such a table.
+void FunctionObject::UseProfileTable( double rMax )
+{
+  if (! CanUseProfileTable())
+    return;
+  useProfileTable = (rMax > 0.0);
+  if (useProfileTable)
+    profileTable.SetMaxRadius(rMax);
+  else
+    profileTable.Clear();
+}
+
+
 /* ---------------- PUBLIC METHOD: SetLabel ---------------------------- */
 /// Used to specify a string label for a particular function instance.
 void FunctionObject::SetLabel( string &userLabel )
@@ -154,6 +190,59 @@ double FunctionObject::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+/// Base method for 2D functions: compute function values for nPixels pixels along
+/// a single row (fixed y), starting at x = xStart and stepping by xStep, storing
+/// them in outputVals. This default version just calls GetValue for each pixel;
+/// derived classes can override it with a faster row-oriented calculation.
+void FunctionObject::GetValues( double y, double xStart, double xStep, int nPixels, 
+								double outputVals[] )
+{
+  for (int k = 0; k < nPixels; k++)
+    outputVals[k] = GetValue(xStart + k*xStep, y);
+}
+
+
+/* ---------------- PROTECTED METHOD: GetEllipticalRowValues ----------- */
+/// Computes function values for nPixels pixels along the row at y (as GetValues),
+/// for a function with elliptical isophotes centered at (xc,yc) with the given
+/// position-angle cosine and sine and axis ratio q. The row is done in chunks;
+/// the radii for each chunk are stored, copied into outputVals, and converted 
+/// to intensities by CalculateIntensities (which can be a vectorized kernel).
+/// If subsampling is on, pixels whose stored radii need it are then recomputed
+/// with GetValue.
+void FunctionObject::GetEllipticalRowValues( double y, double xStart, double xStep, 
+						int nPixels, double xc, double yc, double cosPA, double sinPA, 
+						double q, double outputVals[] )
+{
+  double  radii[ELLIPTICAL_ROW_CHUNK];
+  double  y_diff = y - yc;
+  double  y_diff_sinPA = y_diff*sinPA;
+  double  y_diff_cosPA = y_diff*cosPA;
+  double  x_diff, xp, yp_scaled;
+  
+  for (int kStart = 0; kStart < nPixels; kStart += ELLIPTICAL_ROW_CHUNK) {
+    int  nChunk = min(ELLIPTICAL_ROW_CHUNK, nPixels - kStart);
+    double  xChunkStart = xStart + kStart*xStep;
+    double  *chunkVals = outputVals + kStart;
+    // Calculate x,y in component reference frame, and scale y by 1/axis_ratio
+    for (int k = 0; k < nChunk; k++) {
+      x_diff = xChunkStart + k*xStep - xc;
+      xp = x_diff*cosPA + y_diff_sinPA;
+      yp_scaled = (-x_diff*sinPA + y_diff_cosPA)/q;
+      radii[k] = sqrt(xp*xp + yp_scaled*yp_scaled);
+      chunkVals[k] = radii[k];
+    }
+    CalculateIntensities(nChunk, chunkVals);
+    if (doSubsampling) {
+      for (int k = 0; k < nChunk; k++)
+        if (CalculateSubsamples(radii[k]) > 1)
+          chunkVals[k] = GetValue(xChunkStart + k*xStep, y);
+    }
+  }
+}
+
+
 /* ---------------- PUBLIC METHOD: GetValue ---------------------------- */
 /// Base method for 1D functions: Compute and return actual function value at
 /// specified value of independent variable x.
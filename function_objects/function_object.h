@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "psf_interpolators.h"
+#include "radial_profile_table.h"
 
 using namespace std;
 
@@ -56,6 +57,28 @@ class FunctionObject
     // probably no need to modify this (for 1D functions):
     virtual void SetZeroPoint( double zeroPoint );
 
+    // probably no need to modify this:
+    /// Set intensity threshold (as fraction of central intensity) for footprint
+    /// calculations; 0 = no footprint unless function is intrinsically truncated
+    virtual void SetFootprintFraction( double fraction );
+
+    // override in derived classes which can determine the region outside of which
+    // their intensity is zero or negligible
+    /// Returns true if function (given current parameters) has a finite footprint,
+    /// which is stored as bounding box [xMin,xMax], [yMin,yMax]
+    virtual bool GetFootprint( double& xMin, double& xMax, double& yMin, double& yMax ) 
+    							{ return false; };
+
+    // override in derived classes whose intensity depends only on (elliptical) radius,
+    // and which build and use profileTable when useProfileTable is true
+    /// Returns true if function can use a lookup table for its radial profile
+    virtual bool CanUseProfileTable( ) { return false; };
+
+    // probably no need to modify this:
+    /// Turn on use of a radial-profile lookup table extending to radius rMax
+    /// (in pixels); rMax <= 0 turns it off
+    virtual void UseProfileTable( double rMax );
+
     // NEW MULTIMFIT STUFF
     // probably no need to modify this:
     virtual void SetImageParameters( double pixScale, double imageRot, double intensScale );
@@ -74,9 +97,17 @@ class FunctionObject
     // all derived classes working with 1D data must override this:
     virtual void Setup( double params[], int offsetIndex, double xc );
 
-    // all derived classes working with 2D images must override this:
+    // all derived classes working with 2D images must override this.
+    // NOTE: GetValue (and GetValues) are called simultaneously from multiple
+    // OpenMP threads after Setup, so they must not modify any data members;
+    // per-call scratch data (e.g., gsl_function for integration) must be local
     virtual double GetValue( double x, double y );
 
+    // derived classes working with 2D images can override this with a faster
+    // row-oriented version (default is to call GetValue for each pixel):
+    virtual void GetValues( double y, double xStart, double xStep, int nPixels, 
+    						double outputVals[] );
+
     // all derived classes working with 1D data must override this:
     virtual double GetValue( double x );
 
@@ -84,6 +115,10 @@ class FunctionObject
     // which should *not* be used in total flux calculations
     /// Returns true if class can calculate total flux internally
     virtual bool IsBackground(  ) { return isBackground; }
+    // override in derived classes only if said class's intensity is a linear
+    // function of x and y (e.g., constant or tilted-plane backgrounds)
+    /// Returns true if function is planar (PSF convolution = shift by PSF centroid)
+    virtual bool IsPlanar(  ) { return(false); }
     // override in derived classes only if said class *can* calcluate total flux
     /// Returns true if class can calculate total flux internally
     virtual bool CanCalculateTotalFlux(  ) { return(false); }
@@ -123,11 +158,30 @@ class FunctionObject
   private:
   
   protected:
+    // Row-oriented evaluation for functions with elliptical isophotes (used by
+    // derived-class GetValues): computes the radii for the row, converts them to
+    // intensities with CalculateIntensities, and calls GetValue for pixels which
+    // need subsampling
+    void GetEllipticalRowValues( double y, double xStart, double xStep, int nPixels,
+    						double xc, double yc, double cosPA, double sinPA, double q,
+    						double outputVals[] );
+
+    // derived classes using GetEllipticalRowValues must override this: converts
+    // nValues radii to intensities, in place
+    virtual void CalculateIntensities( int nValues, double values[] ) { ; }
+
+    // derived classes using GetEllipticalRowValues with subsampling must override
+    // this: number of pixel subdivisions (in x and y) at radius r
+    virtual int CalculateSubsamples( double r ) { return 1; }
+
     int  nParams;  ///< number of input parameters that image-function uses
     bool  doSubsampling;
     bool  isBackground = false;
     bool  parameterUnitsExist = false;
     bool  extraParamsSet = false;
+    double  footprintFraction = 0.0;
+    bool  useProfileTable = false;
+    RadialProfileTable  profileTable;
     vector<string>  parameterLabels, parameterUnits;
     map<string, string>  inputExtraParams;
     string  functionName, shortFunctionName, label;
@@ -62,6 +62,36 @@ double GeneralizedRadius( double deltaX, double deltaY, double cosPA, double sin
 }
 
 
+// Bounding box for an ellipse with semi-major axis a, axis ratio q, and major axis
+// oriented along (cosPA, sinPA)
+void EllipseBoundingBox( double x0, double y0, double a, double q, double cosPA, 
+						double sinPA, double& xMin, double& xMax, double& yMin, double& yMax )
+{
+  double  halfWidth_x = a*sqrt(cosPA*cosPA + q*q*sinPA*sinPA);
+  double  halfWidth_y = a*sqrt(sinPA*sinPA + q*q*cosPA*cosPA);
+  xMin = x0 - halfWidth_x;
+  xMax = x0 + halfWidth_x;
+  yMin = y0 - halfWidth_y;
+  yMax = y0 + halfWidth_y;
+}
+
+
+// Bounding box for a generalized ellipse: since r >= max(|xp|, |yp_scaled|) for
+// any (positive) ellExponent, the shape always lies within the a x (q*a) rectangle
+// aligned with the major axis, so we use the bounding box of that rectangle
+void GeneralizedEllipseBoundingBox( double x0, double y0, double a, double q, 
+						double cosPA, double sinPA, double& xMin, double& xMax, 
+						double& yMin, double& yMax )
+{
+  double  halfWidth_x = a*(fabs(cosPA) + q*fabs(sinPA));
+  double  halfWidth_y = a*(fabs(sinPA) + q*fabs(cosPA));
+  xMin = x0 - halfWidth_x;
+  xMax = x0 + halfWidth_x;
+  yMin = y0 - halfWidth_y;
+  yMax = y0 + halfWidth_y;
+}
+
+
 double LinearInterp( double r, double r1, double r2, double c01, double c02 )
 {
   if (r < r1)
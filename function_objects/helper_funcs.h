@@ -28,6 +28,17 @@ double GeneralizedRadius( double deltaX, double deltaY, double cosPA, double sin
 							double q, double ellExponent, double invEllExponent );
 
 
+/// Calculate bounding box (in image coordinates) for an ellipse centered at (x0,y0)
+/// with semi-major axis a and axis ratio q; cosPA and sinPA as for GeneralizedRadius
+void EllipseBoundingBox( double x0, double y0, double a, double q, double cosPA, 
+						double sinPA, double& xMin, double& xMax, double& yMin, double& yMax );
+
+/// Calculate bounding box (in image coordinates) for a generalized ellipse
+/// (any value of ellExponent) with semi-major axis a and axis ratio q
+void GeneralizedEllipseBoundingBox( double x0, double y0, double a, double q, 
+						double cosPA, double sinPA, double& xMin, double& xMax, 
+						double& yMin, double& yMax );
+
 
 // Experimental functions for interpolating c0 values
 
@@ -36,6 +36,7 @@
 
 #include <math.h>
 #include <tuple>
+#include <utility>
 
 #include "helper_funcs_3d.h"
 
@@ -84,6 +85,42 @@ std::tuple<double, double, double> Compute3dObjectCoords( double s, double x_d0,
 
 
 
+// Compute line-of-sight distances s1 < s2 where the line-of-sight ray (as used by
+// Compute3dObjectCoords) enters and exits the ellipsoid
+//    x_obj^2/a2_x + y_obj^2/a2_y + z_obj^2/a2_z = 1
+// (a2_x, etc. = squared semi-axes along x_obj, y_obj, z_obj). The object coordinates
+// are linear in s, so this is a quadratic in s. Returns false if the ray misses
+// the ellipsoid.
+bool EllipsoidChord( double x_d0, double y_d0, double z_d0, double sinInc, 
+					double cosInc, double cosObjPA, double sinObjPA, double a2_x, 
+					double a2_y, double a2_z, double& s1, double& s2 )
+{
+  // object coordinates at s = 0, and their derivatives with respect to s
+  double  x_obj0 = x_d0*cosObjPA + y_d0*sinObjPA;
+  double  y_obj0 = -x_d0*sinObjPA + y_d0*cosObjPA;
+  double  dx_ds = sinInc*sinObjPA;
+  double  dy_ds = sinInc*cosObjPA;
+  double  dz_ds = -cosInc;
+  double  A, B, C, discriminant, qq;
+
+  // (A s^2 + B s + C) - 1 = 0
+  A = dx_ds*dx_ds/a2_x + dy_ds*dy_ds/a2_y + dz_ds*dz_ds/a2_z;
+  B = 2.0*(x_obj0*dx_ds/a2_x + y_obj0*dy_ds/a2_y + z_d0*dz_ds/a2_z);
+  C = x_obj0*x_obj0/a2_x + y_obj0*y_obj0/a2_y + z_d0*z_d0/a2_z;
+  discriminant = B*B - 4.0*A*(C - 1.0);
+  if ((A <= 0.0) || (discriminant <= 0.0))
+    return false;
+  // numerically stable form of quadratic roots
+  qq = -0.5*(B + copysign(sqrt(discriminant), B));
+  s1 = qq/A;
+  s2 = (C - 1.0)/qq;
+  if (s1 > s2)
+    std::swap(s1, s2);
+  return true;
+}
+
+
+
 // Compute equivalent radius given position (xp, yp, zp) relative to center of
 // object for triaxial ellipsoid with super-quadric isodensity contours
 double CalculateTriaxEquivRadius( double xp, double yp, double zp, double q, double q_z, 
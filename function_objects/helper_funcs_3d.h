@@ -14,6 +14,10 @@ std::tuple<double, double, double> Compute3dObjectCoords( double s, double x_d0,
 												double z_d0, double sinInc, double cosInc, 
 												double cosObjPA, double sinObjPA );
 
+bool EllipsoidChord( double x_d0, double y_d0, double z_d0, double sinInc, 
+					double cosInc, double cosObjPA, double sinObjPA, double a2_x, 
+					double a2_y, double a2_z, double& s1, double& s2 );
+
 double CalculateTriaxEquivRadius( double xp, double yp, double zp, double q, double q_z, 
 									double c_xy, double c_z );
 
@@ -8,8 +8,23 @@
 #include "gsl/gsl_integration.h"
 
 
+// Integration using the calling thread's own (reusable) workspace
 double  Integrate( gsl_function F, double s1, double s2 );
 double  Integrate_cquad( gsl_function F, double s1, double s2 );
+
+// Integration over a finite chord [s1,s2] at whose ends the integrand goes to zero
+// (e.g., entry and exit points of a bounded density distribution), using fixed-order
+// Gauss-Kronrod rules, with automatic fallback to QAGS
+double  IntegrateBounded( gsl_function F, double s1, double s2 );
+
+// Integration using a caller-supplied workspace (e.g., from GetIntegrationWorkspace)
+double  Integrate( gsl_function F, double s1, double s2, 
+					gsl_integration_workspace *workspace );
+
+// Returns the calling thread's QAGS (or CQUAD) workspace, allocating it on first use;
+// the workspace is freed automatically when the thread exits
+gsl_integration_workspace * GetIntegrationWorkspace( );
+gsl_integration_cquad_workspace * GetIntegrationWorkspace_cquad( );
 // the following is for occasional testing purposes
 // double  Integrate_Alt( gsl_function F, double s1, double s2 );
 
@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <vector>
 
 // The following requires GSL version 2.0 or later
 #include "gsl/gsl_spline2d.h"
@@ -31,6 +32,40 @@ const double PI = 3.14159265358979;
 const double PI_SQUARED = 9.86960440108936;
 
 
+static void MakeLanczosStamp( double *psfDataArray, int nColumns, int nRows, 
+						double *xArray, double *yArray, int n, ShiftedPsfStamp& stamp );
+static void SplineDerivatives( const double yVals[], int nVals, int stride, 
+						double derivs[] );
+
+
+
+// BASE CLASS: PsfInterpolator
+
+/* ---------------- PUBLIC METHOD: MakeShiftedStamp -------------------- */
+// Generic version: evaluates GetValue at each lattice point (derived classes
+// with separable kernels can do this more efficiently)
+
+void PsfInterpolator::MakeShiftedStamp( double xFrac, double yFrac, ShiftedPsfStamp& stamp )
+{
+  stamp.SetLattice(xFrac, yFrac, deltaXMin, deltaXMax, deltaYMin, deltaYMax);
+  for (int ky = 0; ky < stamp.nRows; ky++)
+    for (int kx = 0; kx < stamp.nColumns; kx++)
+      stamp.values[ky*stamp.nColumns + kx] = GetValue(stamp.XValue(kx), stamp.YValue(ky));
+  stamp.ready = true;
+}
+
+
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+// Generic version: calls GetValue for each point
+
+void PsfInterpolator::GetValues( double xStart, double deltaX, double y, int nValues, 
+								double values[] )
+{
+  for (int k = 0; k < nValues; k++)
+    values[k] = GetValue(xStart + k*deltaX, y);
+}
+
+
 
 // DERIVED CLASS: PsfInterpolator_bicubic -- uses GNU Scientific Library's
 // 2D bicubic interpolation
@@ -103,6 +138,192 @@ double PsfInterpolator_bicubic::GetValue( double x, double y )
 
 
 
+// DERIVED CLASS: PsfInterpolator_bicubic_native -- bicubic interpolation with
+// precomputed per-cell coefficients
+
+/* ---------------- CONSTRUCTOR ---------------------------------------- */
+// Derivatives (df/dx, df/dy, d2f/dxdy) at each PSF pixel center are computed
+// the same way as in GSL's gsl_interp2d_bicubic -- from natural cubic splines
+// along rows (df/dx) and columns (df/dy), and from splines of df/dy along rows
+// (d2f/dxdy) -- and then converted to bicubic polynomial coefficients for each
+// cell. PSF pixels are 1 unit apart, so no rescaling of derivatives is needed.
+
+PsfInterpolator_bicubic_native::PsfInterpolator_bicubic_native( double *inputImage, 
+												int nCols_image, int nRows_image )
+{
+  // Hermite basis matrix: p(t) = sum_i (M*[f(0), f(1), f'(0), f'(1)])_i t^i
+  const double  M[4][4] = {{1.0, 0.0, 0.0, 0.0}, {0.0, 0.0, 1.0, 0.0},
+  							{-3.0, 3.0, -2.0, -1.0}, {2.0, -2.0, 1.0, 1.0}};
+  double  F[4][4], MF[4][4];
+  double  *dfdx, *dfdy, *d2fdxdy, *a;
+  long  i00, i10, i01, i11;
+
+  nColumns = nCols_image;
+  nRows = nRows_image;
+  nPixelsTot = (long)(nColumns * nRows);
+  xBound = (nColumns - 1) / 2.0;
+  yBound = (nRows - 1) / 2.0;
+  deltaXMin = -xBound;
+  deltaXMax = xBound;
+  deltaYMin = -yBound;
+  deltaYMax = yBound;
+  nCellColumns = nColumns - 1;
+  nCellRows = nRows - 1;
+  
+  dfdx = (double *)calloc((size_t)nPixelsTot, sizeof(double));
+  dfdy = (double *)calloc((size_t)nPixelsTot, sizeof(double));
+  d2fdxdy = (double *)calloc((size_t)nPixelsTot, sizeof(double));
+  for (int j = 0; j < nRows; j++)
+    SplineDerivatives(inputImage + j*nColumns, nColumns, 1, dfdx + j*nColumns);
+  for (int i = 0; i < nColumns; i++)
+    SplineDerivatives(inputImage + i, nRows, nColumns, dfdy + i);
+  for (int j = 0; j < nRows; j++)
+    SplineDerivatives(dfdy + j*nColumns, nColumns, 1, d2fdxdy + j*nColumns);
+
+  // coefficients for each cell: A = M F M^T, where F holds the values and
+  // derivatives at the cell's four corners
+  cellCoeffs = (double *)calloc((size_t)(16*nCellColumns*nCellRows), sizeof(double));
+  for (int iy = 0; iy < nCellRows; iy++) {
+    for (int ix = 0; ix < nCellColumns; ix++) {
+      i00 = iy*nColumns + ix;
+      i10 = i00 + 1;
+      i01 = i00 + nColumns;
+      i11 = i01 + 1;
+      F[0][0] = inputImage[i00];   F[0][1] = inputImage[i01];
+      F[1][0] = inputImage[i10];   F[1][1] = inputImage[i11];
+      F[0][2] = dfdy[i00];         F[0][3] = dfdy[i01];
+      F[1][2] = dfdy[i10];         F[1][3] = dfdy[i11];
+      F[2][0] = dfdx[i00];         F[2][1] = dfdx[i01];
+      F[3][0] = dfdx[i10];         F[3][1] = dfdx[i11];
+      F[2][2] = d2fdxdy[i00];      F[2][3] = d2fdxdy[i01];
+      F[3][2] = d2fdxdy[i10];      F[3][3] = d2fdxdy[i11];
+      for (int m = 0; m < 4; m++)
+        for (int n = 0; n < 4; n++) {
+          MF[m][n] = 0.0;
+          for (int k = 0; k < 4; k++)
+            MF[m][n] += M[m][k]*F[k][n];
+        }
+      a = cellCoeffs + 16*(iy*nCellColumns + ix);
+      for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++) {
+          a[4*j + i] = 0.0;
+          for (int k = 0; k < 4; k++)
+            a[4*j + i] += MF[i][k]*M[j][k];
+        }
+    }
+  }
+  free(dfdx);
+  free(dfdy);
+  free(d2fdxdy);
+
+  interpolatorType = kInterpolator_bicubic;
+}
+
+
+/* ---------------- DESTRUCTOR ----------------------------------------- */
+
+PsfInterpolator_bicubic_native::~PsfInterpolator_bicubic_native( )
+{
+  free(cellCoeffs);
+}
+
+
+/* ---------------- PUBLIC METHOD: GetValue ---------------------------- */
+// This function calculates and returns the bicubic interpolation of the PSF
+// at x_diff,y_diff, with those coordinates being relative to the center of 
+// the PSF. (Points on the upper edges of the PSF are treated as belonging
+// to the last cell, as in GSL.)
+
+double PsfInterpolator_bicubic_native::GetValue( double x, double y )
+{
+  int  ix, iy;
+  double  t, u;
+  double  c[4];
+  const double  *a;
+
+  if ((x < deltaXMin) || (x > deltaXMax) || (y < deltaYMin) || (y > deltaYMax))
+    return 0.0;
+  t = x - deltaXMin;
+  u = y - deltaYMin;
+  ix = (int)t;
+  iy = (int)u;
+  if (ix > nCellColumns - 1)
+    ix = nCellColumns - 1;
+  if (iy > nCellRows - 1)
+    iy = nCellRows - 1;
+  t -= ix;
+  u -= iy;
+  a = cellCoeffs + 16*(iy*nCellColumns + ix);
+  for (int j = 0; j < 4; j++)
+    c[j] = a[4*j] + t*(a[4*j + 1] + t*(a[4*j + 2] + t*a[4*j + 3]));
+  return c[0] + u*(c[1] + u*(c[2] + u*c[3]));
+}
+
+
+/* ---------------- PUBLIC METHOD: GetValues --------------------------- */
+// Span version of GetValue, for nValues points (xStart + k*deltaX, y) along
+// a row. Since y is the same for all points, we first reduce the coefficients
+// for the cells in this row to cubic polynomials in t; the main loop over 
+// points can then be vectorized.
+
+void PsfInterpolator_bicubic_native::GetValues( double xStart, double deltaX, double y, 
+											int nValues, double values[] )
+{
+  int  iy;
+  double  u;
+  const double  *a;
+
+  if ((y < deltaYMin) || (y > deltaYMax)) {
+    for (int k = 0; k < nValues; k++)
+      values[k] = 0.0;
+    return;
+  }
+  u = y - deltaYMin;
+  iy = (int)u;
+  if (iy > nCellRows - 1)
+    iy = nCellRows - 1;
+  u -= iy;
+
+  std::vector<double>  rowCoeffs(4*nCellColumns);
+  for (int ix = 0; ix < nCellColumns; ix++) {
+    a = cellCoeffs + 16*(iy*nCellColumns + ix);
+    for (int i = 0; i < 4; i++)
+      rowCoeffs[4*ix + i] = a[i] + u*(a[4 + i] + u*(a[8 + i] + u*a[12 + i]));
+  }
+
+  const double  *b = rowCoeffs.data();
+  int  lastCell = nCellColumns - 1;
+  double  xMin = deltaXMin;
+  double  xMax = deltaXMax;
+  #pragma omp simd
+  for (int k = 0; k < nValues; k++) {
+    double  x = xStart + k*deltaX;
+    double  t = x - xMin;
+    int  ix = (int)t;
+    ix = (ix < 0) ? 0 : ((ix > lastCell) ? lastCell : ix);
+    t -= ix;
+    double  newVal = b[4*ix] + t*(b[4*ix + 1] + t*(b[4*ix + 2] + t*b[4*ix + 3]));
+    values[k] = ((x < xMin) || (x > xMax)) ? 0.0 : newVal;
+  }
+}
+
+
+/* ---------------- PUBLIC METHOD: MakeShiftedStamp -------------------- */
+// Each row of the stamp is computed with a single call to GetValues
+
+void PsfInterpolator_bicubic_native::MakeShiftedStamp( double xFrac, double yFrac, 
+													ShiftedPsfStamp& stamp )
+{
+  stamp.SetLattice(xFrac, yFrac, deltaXMin, deltaXMax, deltaYMin, deltaYMax);
+  if (stamp.nColumns > 0)
+    for (int ky = 0; ky < stamp.nRows; ky++)
+      GetValues(stamp.XValue(0), 1.0, stamp.YValue(ky), stamp.nColumns, 
+      			stamp.values.data() + ky*stamp.nColumns);
+  stamp.ready = true;
+}
+
+
+
 // DERIVED CLASS: PsfInterpolator_lanczos2 -- uses Lanczos2 interpolation
 
 /* ---------------- CONSTRUCTOR ---------------------------------------- */
@@ -182,7 +403,7 @@ double PsfInterpolator_lanczos2::GetValue( double x, double y )
           else {
             y_dat = yArray[i_data_y];  // current y-value for PSF pixels
             lanczosScaling = Lanczos(x - x_dat, 2) * Lanczos(y - y_dat, 2);
-            newVal += lanczosScaling * psfDataArray[i_data_x*nColumns + i_data_y];
+            newVal += lanczosScaling * psfDataArray[i_data_y*nColumns + i_data_x];
           }
         }
       }
@@ -192,6 +413,18 @@ double PsfInterpolator_lanczos2::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: MakeShiftedStamp -------------------- */
+// Separable version: the Lanczos2 kernel is a product of 1D kernels in x and y,
+// so we interpolate the PSF rows in x and then the resulting columns in y
+
+void PsfInterpolator_lanczos2::MakeShiftedStamp( double xFrac, double yFrac, 
+												ShiftedPsfStamp& stamp )
+{
+  stamp.SetLattice(xFrac, yFrac, deltaXMin, deltaXMax, deltaYMin, deltaYMax);
+  MakeLanczosStamp(psfDataArray, nColumns, nRows, xArray, yArray, 2, stamp);
+}
+
+
 
 // DERIVED CLASS: PsfInterpolator_lanczos3 -- uses Lanczos3 interpolation
 
@@ -272,7 +505,7 @@ double PsfInterpolator_lanczos3::GetValue( double x, double y )
           else {
             y_dat = yArray[i_data_y];  // current y-value for PSF pixels
             lanczosScaling = Lanczos(x - x_dat, 3) * Lanczos(y - y_dat, 3);
-            newVal += lanczosScaling * psfDataArray[i_data_x*nColumns + i_data_y];
+            newVal += lanczosScaling * psfDataArray[i_data_y*nColumns + i_data_x];
           }
         }
       }
@@ -282,6 +515,18 @@ double PsfInterpolator_lanczos3::GetValue( double x, double y )
 }
 
 
+/* ---------------- PUBLIC METHOD: MakeShiftedStamp -------------------- */
+// Separable version: the Lanczos3 kernel is a product of 1D kernels in x and y,
+// so we interpolate the PSF rows in x and then the resulting columns in y
+
+void PsfInterpolator_lanczos3::MakeShiftedStamp( double xFrac, double yFrac, 
+												ShiftedPsfStamp& stamp )
+{
+  stamp.SetLattice(xFrac, yFrac, deltaXMin, deltaXMax, deltaYMin, deltaYMax);
+  MakeLanczosStamp(psfDataArray, nColumns, nRows, xArray, yArray, 3, stamp);
+}
+
+
 
 // Extra non-method functions
 
@@ -307,3 +552,105 @@ double Lanczos( double x, int n )
   else
     return (n * sin(PI*x_abs) * sin(PI*x_abs/n)) / (PI_SQUARED*x_abs*x_abs);
 }
+
+
+// Fills in values of stamp (whose lattice has already been set up) with 
+// the Lanczos-n interpolation of the PSF image, done as two 1D passes. The 1D
+// weights depend only on the fractional shift of the lattice, so they are
+// computed once for each stamp column and row.
+static void MakeLanczosStamp( double *psfDataArray, int nColumns, int nRows, 
+						double *xArray, double *yArray, int n, ShiftedPsfStamp& stamp )
+{
+  int  nWeights = 2*n + 1;
+  int  nStampCols = stamp.nColumns;
+  int  nStampRows = stamp.nRows;
+  int  i_data, i_data_first;
+  double  x, y, newVal;
+  std::vector<int>  xFirstIndex(nStampCols), yFirstIndex(nStampRows);
+  std::vector<double>  xWeights((size_t)nStampCols*nWeights, 0.0);
+  std::vector<double>  yWeights((size_t)nStampRows*nWeights, 0.0);
+  std::vector<double>  rowPass((size_t)nRows*nStampCols, 0.0);
+
+  // 1D weights for PSF columns (same index range as in GetValue); weights for
+  // indices outside the PSF image are left = 0
+  for (int kx = 0; kx < nStampCols; kx++) {
+    x = stamp.XValue(kx);
+    i_data_first = FindIndex(xArray, x) - n;
+    xFirstIndex[kx] = i_data_first;
+    for (int i = 0; i < nWeights; i++) {
+      i_data = i_data_first + i;
+      if ((i_data >= 0) && (i_data < nColumns))
+        xWeights[kx*nWeights + i] = Lanczos(x - xArray[i_data], n);
+    }
+  }
+  // 1D weights for PSF rows
+  for (int ky = 0; ky < nStampRows; ky++) {
+    y = stamp.YValue(ky);
+    i_data_first = FindIndex(yArray, y) - n;
+    yFirstIndex[ky] = i_data_first;
+    for (int j = 0; j < nWeights; j++) {
+      i_data = i_data_first + j;
+      if ((i_data >= 0) && (i_data < nRows))
+        yWeights[ky*nWeights + j] = Lanczos(y - yArray[i_data], n);
+    }
+  }
+
+  // first pass: interpolate each row of the PSF image in x
+  for (int j_data = 0; j_data < nRows; j_data++) {
+    for (int kx = 0; kx < nStampCols; kx++) {
+      newVal = 0.0;
+      for (int i = 0; i < nWeights; i++) {
+        i_data = xFirstIndex[kx] + i;
+        if ((i_data >= 0) && (i_data < nColumns))
+          newVal += xWeights[kx*nWeights + i] * psfDataArray[j_data*nColumns + i_data];
+      }
+      rowPass[j_data*nStampCols + kx] = newVal;
+    }
+  }
+  // second pass: interpolate the x-interpolated rows in y
+  for (int ky = 0; ky < nStampRows; ky++) {
+    for (int kx = 0; kx < nStampCols; kx++) {
+      newVal = 0.0;
+      for (int j = 0; j < nWeights; j++) {
+        i_data = yFirstIndex[ky] + j;
+        if ((i_data >= 0) && (i_data < nRows))
+          newVal += yWeights[ky*nWeights + j] * rowPass[i_data*nStampCols + kx];
+      }
+      stamp.values[ky*nStampCols + kx] = newVal;
+    }
+  }
+  stamp.ready = true;
+}
+
+
+// Computes the first derivatives at the data points of a natural cubic spline
+// through the nVals values yVals[0], yVals[stride], ..., which have unit spacing
+// in x (same as gsl_spline_eval_deriv for a gsl_interp_cspline spline). 
+// Derivatives are stored in derivs with the same stride.
+static void SplineDerivatives( const double yVals[], int nVals, int stride, 
+						double derivs[] )
+{
+  if (nVals < 2) {
+    if (nVals == 1)
+      derivs[0] = 0.0;
+    return;
+  }
+  // second derivatives M_i, with M_0 = M_(n-1) = 0, from the tridiagonal system
+  // M_(i-1) + 4 M_i + M_(i+1) = 6 (y_(i+1) - 2 y_i + y_(i-1)), solved by forward
+  // elimination and back substitution
+  std::vector<double>  secondDerivs(nVals, 0.0), diag(nVals, 4.0), rhs(nVals, 0.0);
+  for (int i = 1; i < nVals - 1; i++)
+    rhs[i] = 6.0*(yVals[(i + 1)*stride] - 2.0*yVals[i*stride] + yVals[(i - 1)*stride]);
+  for (int i = 2; i < nVals - 1; i++) {
+    diag[i] -= 1.0/diag[i - 1];
+    rhs[i] -= rhs[i - 1]/diag[i - 1];
+  }
+  for (int i = nVals - 2; i >= 1; i--)
+    secondDerivs[i] = (rhs[i] - secondDerivs[i + 1]) / diag[i];
+
+  for (int i = 0; i < nVals - 1; i++)
+    derivs[i*stride] = (yVals[(i + 1)*stride] - yVals[i*stride]) 
+    					- (2.0*secondDerivs[i] + secondDerivs[i + 1])/6.0;
+  derivs[(nVals - 1)*stride] = (yVals[(nVals - 1)*stride] - yVals[(nVals - 2)*stride])
+  					+ (secondDerivs[nVals - 2] + 2.0*secondDerivs[nVals - 1])/6.0;
+}
@@ -3,6 +3,8 @@
 
 // The following requires GSL version 2.0 or later
 #include "gsl/gsl_spline2d.h"
+#include <math.h>
+#include <vector>
 
 #define kInterpolator_Base 0
 #define kInterpolator_bicubic 1
@@ -16,6 +18,79 @@ double Lanczos( double x, int n );
 int FindIndex( double xArray[], double xVal );
 
 
+// maximum distance (in PSF pixels) of a point from the lattice of a ShiftedPsfStamp
+// for which the stamp value is used
+const double  STAMP_LATTICE_TOLERANCE = 1.0e-8;
+
+
+// Copy of the PSF interpolated onto the lattice of points (kx + xFrac, ky + yFrac)
+// (kx, ky = integers, in PSF-center-relative coordinates) which lie within the
+// PSF bounds. This is built once for a given fractional shift (e.g., by
+// PointSource::Setup), so that later evaluations on the same lattice (i.e.,
+// at pixel centers of the model image) are simple lookups. Lookup() only reads
+// data members, so it can be called from multiple threads.
+class ShiftedPsfStamp
+{
+  public:
+  ShiftedPsfStamp( ) { Clear(); };
+
+  // Sets up the lattice for fractional shift (xFrac_in,yFrac_in) and the PSF
+  // bounds (from PsfInterpolator::GetBounds); values must then be filled in
+  void SetLattice( double xFrac_in, double yFrac_in, double xMin, double xMax,
+  					double yMin, double yMax )
+  {
+    xFrac = xFrac_in;
+    yFrac = yFrac_in;
+    kxMin = (int)ceil(xMin - xFrac);
+    kyMin = (int)ceil(yMin - yFrac);
+    nColumns = (int)floor(xMax - xFrac) - kxMin + 1;
+    nRows = (int)floor(yMax - yFrac) - kyMin + 1;
+    if (nColumns < 0)
+      nColumns = 0;
+    if (nRows < 0)
+      nRows = 0;
+    values.assign((size_t)nColumns*nRows, 0.0);
+    ready = false;
+  };
+
+  void Clear( )
+  {
+    xFrac = yFrac = 0.0;
+    kxMin = kyMin = nColumns = nRows = 0;
+    values.clear();
+    ready = false;
+  };
+
+  // (x,y) coordinates of lattice point with stamp column kx and row ky
+  double XValue( int kx ) { return kxMin + kx + xFrac; };
+  double YValue( int ky ) { return kyMin + ky + yFrac; };
+
+  // Returns true and sets value if (x,y) is a lattice point inside the stamp;
+  // otherwise returns false (caller should then use PsfInterpolator::GetValue)
+  bool Lookup( double x, double y, double& value ) const
+  {
+    if (! ready)
+      return false;
+    double  kx_real = x - xFrac - kxMin;
+    double  ky_real = y - yFrac - kyMin;
+    long  kx = lround(kx_real);
+    long  ky = lround(ky_real);
+    if ((fabs(kx_real - kx) > STAMP_LATTICE_TOLERANCE) 
+    		|| (fabs(ky_real - ky) > STAMP_LATTICE_TOLERANCE))
+      return false;
+    if ((kx < 0) || (kx >= nColumns) || (ky < 0) || (ky >= nRows))
+      return false;
+    value = values[ky*nColumns + kx];
+    return true;
+  };
+
+  double  xFrac, yFrac;
+  int  kxMin, kyMin, nColumns, nRows;
+  std::vector<double>  values;   // row-major: values[ky*nColumns + kx]
+  bool  ready;
+};
+
+
 
 // Classes
 
@@ -35,6 +110,25 @@ class PsfInterpolator
   // pure virtual function (making this an abstract base class)
   virtual double GetValue( double x, double y ) = 0;
 
+  // Fills stamp with the PSF interpolated onto the lattice with fractional
+  // shift (xFrac,yFrac); the default version calls GetValue for each point
+  virtual void MakeShiftedStamp( double xFrac, double yFrac, ShiftedPsfStamp& stamp );
+
+  // Computes values at the nValues points (xStart + k*deltaX, y) along a row;
+  // the default version calls GetValue for each point
+  virtual void GetValues( double xStart, double deltaX, double y, int nValues, 
+  						double values[] );
+
+  // Returns the range of (x,y) offsets from the PSF center (in PSF pixels) outside
+  // of which GetValue returns 0
+  void GetBounds( double& xMin, double& xMax, double& yMin, double& yMax )
+  {
+    xMin = deltaXMin;
+    xMax = deltaXMax;
+    yMin = deltaYMin;
+    yMax = deltaYMax;
+  };
+
   protected:
     int  interpolatorType = kInterpolator_Base;
     // data members proper
@@ -45,6 +139,8 @@ class PsfInterpolator
 
 
 // Derived class using GNU Scientific Library's 2D bicubic interpolation
+// (reference version for PsfInterpolator_bicubic_native; note that GetValue
+// modifies the GSL accelerator objects, so it is *not* thread-safe)
 class PsfInterpolator_bicubic : public PsfInterpolator
 {
   public:
@@ -64,6 +160,35 @@ class PsfInterpolator_bicubic : public PsfInterpolator
 };
 
 
+// Derived class using our own implementation of bicubic interpolation (same
+// method as GSL's gsl_interp2d_bicubic: derivatives at PSF pixel centers from
+// natural cubic splines, then bicubic Hermite interpolation within each cell).
+// The 16 polynomial coefficients for each cell (the square between four
+// neighboring PSF pixel centers) are precomputed and stored contiguously, and
+// there is no per-call mutable state, so GetValue and GetValues can safely be
+// called from multiple threads.
+class PsfInterpolator_bicubic_native : public PsfInterpolator
+{
+  public:
+  PsfInterpolator_bicubic_native( double *inputImage, int nCols_image, int nRows_image );
+  
+  ~PsfInterpolator_bicubic_native( );
+  
+  double GetValue( double x, double y );
+
+  void GetValues( double xStart, double deltaX, double y, int nValues, double values[] );
+
+  void MakeShiftedStamp( double xFrac, double yFrac, ShiftedPsfStamp& stamp );
+
+  private:
+    // new data members
+    int  nCellColumns, nCellRows;
+    // coefficients a_ij (for t^i u^j) for cell (ix,iy) are stored in
+    // cellCoeffs[16*(iy*nCellColumns + ix) + 4*j + i]
+    double *cellCoeffs;
+};
+
+
 // Derived class using Lanczos2 kernel
 class PsfInterpolator_lanczos2 : public PsfInterpolator
 {
@@ -73,6 +198,8 @@ class PsfInterpolator_lanczos2 : public PsfInterpolator
   ~PsfInterpolator_lanczos2( );
   
   double GetValue( double x, double y );
+  
+  void MakeShiftedStamp( double xFrac, double yFrac, ShiftedPsfStamp& stamp );
 
   private:
     // new data members
@@ -91,6 +218,8 @@ class PsfInterpolator_lanczos3 : public PsfInterpolator
 ~PsfInterpolator_lanczos3( );
   
   double GetValue( double x, double y );
+  
+  void MakeShiftedStamp( double xFrac, double yFrac, ShiftedPsfStamp& stamp );
 
   private:
     // new data members
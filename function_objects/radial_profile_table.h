@@ -0,0 +1,176 @@
+// Lookup table for the radial intensity profile I(r) of an image function whose
+// intensity depends only on (elliptical) radius, for use by the function's
+// CalculateIntensity() method in place of direct calculation.
+//
+// The table is sampled uniformly in log(r) from R_MIN to R_BREAK (where the
+// profiles of cuspy functions like Sersic or Nuker change rapidly, and where
+// most pixel subsampling takes place), and then more finely in log(r) from R_BREAK
+// to the maximum radius (normally the diagonal size of the model image). The
+// number of entries in the outer part is bounded (the spacing is increased for
+// very large images), so the table has at most a few thousand entries, which
+// must be recomputed whenever Setup() is called. Values are interpolated with 
+// cubic Hermite (Catmull-Rom) splines; relative errors are typically < 1e-5 for 
+// smooth profiles. Radii < R_MIN or >= the maximum radius are not covered by 
+// the table, and must be computed directly.
+//
+// Usage (in a FunctionObject subclass, e.g. Sersic):
+//    in Setup(), after computing the derived parameters:
+//       if (useProfileTable)
+//         profileTable.Build(this, &Sersic::CalculateIntensity);
+//    at the start of CalculateIntensity(r):
+//       if (profileTable.Covers(r))
+//         return profileTable.Interpolate(r);
+//
+// All methods are defined inline here, so there is no separate .cpp file.
+
+#ifndef _RADIAL_PROFILE_TABLE_H_
+#define _RADIAL_PROFILE_TABLE_H_
+
+#include <math.h>
+#include <vector>
+
+using namespace std;
+
+
+// radii (in pixels) for the log-spaced part of the table
+const double  PROFILE_TABLE_R_MIN = 1.0e-4;
+const double  PROFILE_TABLE_R_BREAK = 10.0;
+// number of samples per decade in radius for inner part of the table
+const int  PROFILE_TABLE_PER_DECADE = 64;
+// number of samples per decade in radius for outer part of the table, and 
+// maximum number of samples in outer part
+const int  PROFILE_TABLE_OUTER_PER_DECADE = 512;
+const int  PROFILE_TABLE_MAX_OUTER = 2048;
+
+
+/// \brief Lookup table (with cubic interpolation) for radial intensity profiles
+class RadialProfileTable
+{
+  public:
+    RadialProfileTable( )
+    {
+      rMax = 0.0;
+      nLog = nOuter = 0;
+      ready = false;
+      logRMin = log(PROFILE_TABLE_R_MIN);
+      logRBreak = log(PROFILE_TABLE_R_BREAK);
+      deltaLogR = log(10.0) / PROFILE_TABLE_PER_DECADE;
+      deltaLogR_outer = log(10.0) / PROFILE_TABLE_OUTER_PER_DECADE;
+    };
+
+    /// Sets up the sampling radii so that the table extends to maxRadius;
+    /// table values must then be (re)computed with Build()
+    void SetMaxRadius( double maxRadius )
+    {
+      rMax = maxRadius;
+      nLog = (int)ceil((logRBreak - logRMin) / deltaLogR) + 1;
+      deltaLogR_outer = log(10.0) / PROFILE_TABLE_OUTER_PER_DECADE;
+      nOuter = 2;
+      if (rMax > PROFILE_TABLE_R_BREAK) {
+        double  logRange = log(rMax) - logRBreak;
+        nOuter = (int)ceil(logRange / deltaLogR_outer) + 1;
+        if (nOuter > PROFILE_TABLE_MAX_OUTER) {
+          nOuter = PROFILE_TABLE_MAX_OUTER;
+          deltaLogR_outer = logRange / (nOuter - 1);
+        }
+        else if (nOuter < 2)
+          nOuter = 2;
+      }
+      logValues.assign(nLog, 0.0);
+      logSlopes.assign(nLog, 0.0);
+      outerValues.assign(nOuter, 0.0);
+      outerSlopes.assign(nOuter, 0.0);
+      ready = false;
+    };
+
+    /// Frees memory and marks table as unusable
+    void Clear( )
+    {
+      rMax = 0.0;
+      nLog = nOuter = 0;
+      logValues.clear();
+      logSlopes.clear();
+      outerValues.clear();
+      outerSlopes.clear();
+      ready = false;
+    };
+
+    double GetMaxRadius( ) { return rMax; };
+
+    /// Returns the total number of table entries (= intensity evaluations per Build)
+    int GetNEntries( ) { return nLog + nOuter; };
+
+    /// Computes table values using the supplied (intensity-vs-radius) member
+    /// function of funcObj
+    template <class T>
+    void Build( T *funcObj, double (T::*intensityFunc)( double ) )
+    {
+      // mark table as not ready, so that intensityFunc does direct calculations
+      ready = false;
+      if (nOuter < 2)
+        return;
+      for (int k = 0; k < nLog; k++)
+        logValues[k] = (funcObj->*intensityFunc)(exp(logRMin + k*deltaLogR));
+      for (int k = 0; k < nOuter; k++)
+        outerValues[k] = (funcObj->*intensityFunc)(exp(logRBreak + k*deltaLogR_outer));
+      ComputeSlopes(logValues, logSlopes);
+      ComputeSlopes(outerValues, outerSlopes);
+      ready = true;
+    };
+
+    /// Returns true if the table is ready and r lies within its range
+    bool Covers( double r )
+    {
+      return (ready && (r >= PROFILE_TABLE_R_MIN) && (r < rMax));
+    };
+
+    /// Returns interpolated intensity at radius r (assumes Covers(r) is true)
+    double Interpolate( double r )
+    {
+      double  x;
+      if (r < PROFILE_TABLE_R_BREAK) {
+        x = (log(r) - logRMin) / deltaLogR;
+        return HermiteInterp(logValues, logSlopes, nLog, x);
+      }
+      x = (log(r) - logRBreak) / deltaLogR_outer;
+      return HermiteInterp(outerValues, outerSlopes, nOuter, x);
+    };
+
+
+  private:
+    // Catmull-Rom slopes (derivatives with respect to index), using one-sided
+    // second-order differences at the ends
+    void ComputeSlopes( vector<double>& values, vector<double>& slopes )
+    {
+      int  n = (int)values.size();
+      if (n < 3) {
+        slopes[0] = slopes[n - 1] = values[n - 1] - values[0];
+        return;
+      }
+      for (int k = 1; k < n - 1; k++)
+        slopes[k] = 0.5*(values[k + 1] - values[k - 1]);
+      slopes[0] = 0.5*(-3.0*values[0] + 4.0*values[1] - values[2]);
+      slopes[n - 1] = 0.5*(3.0*values[n - 1] - 4.0*values[n - 2] + values[n - 3]);
+    };
+
+    // Cubic Hermite interpolation at (fractional) index position x
+    double HermiteInterp( vector<double>& values, vector<double>& slopes, int n, double x )
+    {
+      int  k = (int)x;
+      if (k > n - 2)
+        k = n - 2;
+      double  t = x - k;
+      double  t2 = t*t;
+      double  t3 = t2*t;
+      return (2.0*t3 - 3.0*t2 + 1.0)*values[k] + (t3 - 2.0*t2 + t)*slopes[k]
+      			+ (-2.0*t3 + 3.0*t2)*values[k + 1] + (t3 - t2)*slopes[k + 1];
+    };
+
+    double  rMax, logRMin, logRBreak, deltaLogR, deltaLogR_outer;
+    int  nLog, nOuter;
+    bool  ready;
+    vector<double>  logValues, logSlopes, outerValues, outerSlopes;
+};
+
+
+#endif  // _RADIAL_PROFILE_TABLE_H_
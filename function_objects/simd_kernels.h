@@ -0,0 +1,38 @@
+// Vectorizable ("SIMD") intensity kernels for the most commonly used elliptical
+// image functions (Sersic, Exponential, Gaussian, Moffat), used by the
+// row-oriented GetValues() methods of those classes.
+//
+// Each kernel takes an array of (scaled) radius values and replaces them --
+// in place -- with the corresponding intensities. The kernels use inline,
+// branch-free versions of exp() and log() so that the compiler can vectorize
+// the loops; where supported (GCC on x86-64 Linux), multiple versions of each
+// kernel are compiled (AVX-512, AVX2, and the default SSE2), with the best
+// version selected at run time.
+
+#ifndef _SIMD_KERNELS_H_
+#define _SIMD_KERNELS_H_
+
+
+/// Replaces each value in vals with exp(value)
+void VectorExp( int nVals, double vals[] );
+
+/// Replaces each value in vals with log(value) (values must be > 0)
+void VectorLog( int nVals, double vals[] );
+
+
+/// Replaces radius values in vals with Sersic intensities
+void SersicIntensities( int nVals, double vals[], double I_e, double bn,
+						double invn, double r_e );
+
+/// Replaces radius values in vals with exponential intensities
+void ExponentialIntensities( int nVals, double vals[], double I_0, double h );
+
+/// Replaces radius values in vals with Gaussian intensities
+void GaussianIntensities( int nVals, double vals[], double I_0, double twosigma_squared );
+
+/// Replaces radius values in vals with Moffat intensities
+void MoffatIntensities( int nVals, double vals[], double I_0, double alpha,
+						double beta );
+
+
+#endif  // _SIMD_KERNELS_H_
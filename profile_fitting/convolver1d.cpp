@@ -4,6 +4,12 @@
  *   Module for profile convolution functions.
  *
  *   MODIFICATION HISTORY:
+ *     17 Oct 2026: Padding of input arrays is zeroed once (after FFTW planning)
+ *   instead of for every convolution.
+ *     17 Oct 2026: Switched to real-to-complex/complex-to-real FFTs, with
+ *   FFT-friendly padded sizes, FFTW plans shared between Convolver1D objects,
+ *   and batched convolution of multiple profiles.
+ *     17 Oct 2026: Added selectable FFTW planning rigor (with saved FFTW wisdom).
  *     [v0.01]: 13--14 Aug 2010: Created as modification of convolver.cpp.
  */
 
@@ -15,12 +21,103 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <vector>
+#include <algorithm>
 
 #include "fftw3.h"
 
+#include "definitions.h"
+#include "convolver.h"
 #include "convolver1d.h"
 
-//using namespace std;
+using namespace std;
+
+
+/// FFTW plans for the forward (r2c) and inverse (c2r) FFTs of nProfiles padded
+/// profiles stored one after the other. Since each Convolver1D executes the plans
+/// with its own arrays (via fftw_execute_dft_r2c, etc.), the plans can be shared
+/// by all Convolver1D objects with the same padded size, number of profiles, and
+/// planning mode -- e.g., the many ModelObject1D objects created in bootstrap
+/// resampling.
+struct SharedFFTWPlans1D
+{
+  // identifying information
+  int  nPixels_padded, nProfiles;
+  int  fftwPlanningMode;
+  // shared data
+  fftw_plan  plan_InputProfile, plan_inverse;
+  int  nUsers;
+};
+
+// All currently existing shared plans. Note that this (like FFTW planning itself)
+// is not thread-safe: Convolver1D setup and deletion should not be done from
+// multiple threads at once.
+static vector<SharedFFTWPlans1D *>  sharedPlansRegistry1D;
+
+
+/* ---------------- FUNCTION: AcquireFFTWPlans1D ----------------------- */
+// Returns existing plans for nProfiles profiles of nPixels_padded pixels each, or
+// creates new plans (using the supplied arrays, which must have been allocated 
+// with fftw_malloc) if there are none.
+static SharedFFTWPlans1D * AcquireFFTWPlans1D( int nPixels_padded, int nProfiles, 
+									int planningMode, double *realIn, 
+									fftw_complex *complexArray, double *realOut, 
+									int debugLevel )
+{
+  SharedFFTWPlans1D  *plans;
+  int  nPixels_padded_complex = nPixels_padded/2 + 1;
+  unsigned  fftwFlags;
+  
+  for (SharedFFTWPlans1D *candidate : sharedPlansRegistry1D) {
+    if ((candidate->nPixels_padded == nPixels_padded) && (candidate->nProfiles == nProfiles)
+    		&& (candidate->fftwPlanningMode == planningMode)) {
+      candidate->nUsers += 1;
+      if (debugLevel >= 1)
+        printf("Using FFTW plans from previous Convolver1D ...\n");
+      return candidate;
+    }
+  }
+  
+  fftwFlags = GetFFTWPlannerFlags(planningMode);
+  plans = new SharedFFTWPlans1D;
+  plans->nPixels_padded = nPixels_padded;
+  plans->nProfiles = nProfiles;
+  plans->fftwPlanningMode = planningMode;
+  plans->nUsers = 1;
+  if (nProfiles == 1) {
+    plans->plan_InputProfile = fftw_plan_dft_r2c_1d(nPixels_padded, realIn, complexArray,
+    											fftwFlags);
+    plans->plan_inverse = fftw_plan_dft_c2r_1d(nPixels_padded, complexArray, realOut,
+    											fftwFlags);
+  } else {
+    plans->plan_InputProfile = fftw_plan_many_dft_r2c(1, &nPixels_padded, nProfiles,
+    						realIn, nullptr, 1, nPixels_padded,
+    						complexArray, nullptr, 1, nPixels_padded_complex, fftwFlags);
+    plans->plan_inverse = fftw_plan_many_dft_c2r(1, &nPixels_padded, nProfiles,
+    						complexArray, nullptr, 1, nPixels_padded_complex,
+    						realOut, nullptr, 1, nPixels_padded, fftwFlags);
+  }
+  sharedPlansRegistry1D.push_back(plans);
+  return plans;
+}
+
+
+/* ---------------- FUNCTION: ReleaseFFTWPlans1D ----------------------- */
+// Stops using the shared plans; these are destroyed if no other Convolver1D
+// is using them.
+static void ReleaseFFTWPlans1D( SharedFFTWPlans1D *plans )
+{
+  if (plans == nullptr)
+    return;
+  plans->nUsers -= 1;
+  if (plans->nUsers == 0) {
+    fftw_destroy_plan(plans->plan_InputProfile);
+    fftw_destroy_plan(plans->plan_inverse);
+    sharedPlansRegistry1D.erase(std::find(sharedPlansRegistry1D.begin(), 
+    								sharedPlansRegistry1D.end(), plans));
+    delete plans;
+  }
+}
 
 
 
@@ -31,7 +128,13 @@ Convolver1D::Convolver1D( )
   psfInfoSet = false;
   profileInfoSet = false;
   fftVectorsAllocated = false;
-  fftPlansCreated = false;
+  fftwPlanningMode = FFTW_PLANNING_ESTIMATE;
+  batchSize = 1;
+  plans = nullptr;
+  batchPlans = nullptr;
+  batch_in_padded = nullptr;
+  batch_out = nullptr;
+  batch_fft_cmplx = nullptr;
 }
 
 
@@ -40,19 +143,16 @@ Convolver1D::Convolver1D( )
 Convolver1D::~Convolver1D( )
 {
 
-  if (fftPlansCreated) {
-    fftw_destroy_plan(plan_InputProfile);
-    fftw_destroy_plan(plan_psf);
-    fftw_destroy_plan(plan_inverse);
-  }
+  ReleaseFFTWPlans1D(plans);
+  ReleaseFFTWPlans1D(batchPlans);
   if (fftVectorsAllocated) {
-    fftw_free(profile_in_cmplx);
+    fftw_free(profile_in_padded);
     fftw_free(profile_fft_cmplx);
-    fftw_free(psf_in_cmplx);
     fftw_free(psf_fft_cmplx);
-    fftw_free(multiplied_cmplx);
-    fftw_free(convolvedProfile_cmplx);
-
+    fftw_free(convolvedProfile_out);
+    fftw_free(batch_in_padded);
+    fftw_free(batch_fft_cmplx);
+    fftw_free(batch_out);
   }
 }
 
@@ -79,15 +179,41 @@ void Convolver1D::SetupProfile( int nPixels )
 }
 
 
+/* ---------------- SetFFTWPlanning ------------------------------------ */
+// Specify rigor of FFTW planning (FFTW_PLANNING_ESTIMATE, FFTW_PLANNING_MEASURE,
+// etc.); must be called before DoFullSetup().
+void Convolver1D::SetFFTWPlanning( int planningMode )
+{
+  fftwPlanningMode = planningMode;
+}
+
+
+/* ---------------- SetBatchSize --------------------------------------- */
+// Specify the number of profiles to be convolved together (with a single set
+// of batched FFTs) by ConvolveProfiles(); must be called before DoFullSetup().
+void Convolver1D::SetBatchSize( int nProfiles )
+{
+  batchSize = (nProfiles > 1) ? nProfiles : 1;
+}
+
+
+/* ---------------- GetPaddedSize -------------------------------------- */
+int Convolver1D::GetPaddedSize( )
+{
+  return nPixels_padded;
+}
+
+
 /* ---------------- DoFullSetup ---------------------------------------- */
 // General setup prior to actually supplying the profiles data and doing the
 // convolution: determine padding size; allocate FFTW arrays and plans;
 // normalize, shift, and Fourier transform the PSF profiles.
 int Convolver1D::DoFullSetup( int debugLevel, bool doFFTWMeasure )
 {
-  int  k;
-  unsigned  fftwFlags;
-  double  psfSum;
+  int  k, dummyRows;
+  double  psfSum, rescaleFactor;
+  double  *psf_in_padded;
+  fftw_plan  plan_psf;
   
   debugStatus = debugLevel;
   
@@ -96,47 +222,51 @@ int Convolver1D::DoFullSetup( int debugLevel, bool doFFTWMeasure )
     fprintf(stderr, "*** WARNING: Convolver1D.DoFullSetup: PSF and/or data-profile parameters not set!\n");
     return -1;
   }
-  nPixels_padded = nPixels_data + nPixels_psf - 1;
-  rescaleFactor = 1.0 / nPixels_padded;
+  // any padded size >= nPixels_data + nPixels_psf - 1 gives the same convolution,
+  // so we use the cheapest size with only small prime factors
+  GetFFTFriendlyPaddedSize(nPixels_data + nPixels_psf - 1, 1, nPixels_padded, dummyRows);
+  nPixels_padded_complex = nPixels_padded/2 + 1;
   if (debugStatus >= 1)
     printf("Profiles will be padded to %d pixels in size\n", nPixels_padded);
 
-#ifdef FFTW_THREADING
-  // TEST: multi-threaded FFTW:
-  int  threadStatus;
-  threadStatus = fftw_init_threads();
-#endif  // FFTW_THREADING
-
-  // allocate memory for fftw_complex arrays
-  profile_in_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded);
-  profile_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded);
-  psf_in_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded);
-  psf_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded);
-  multiplied_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded);
-  convolvedProfile_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded);
+  // allocate memory for real and fftw_complex arrays (the transforms of real
+  // profiles only need nPixels_padded/2 + 1 complex values)
+  profile_in_padded = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
+  profile_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex);
+  psf_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex);
+  convolvedProfile_out = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
+  psf_in_padded = (double*) fftw_malloc(sizeof(double) * nPixels_padded);
+  if (batchSize > 1) {
+    batch_in_padded = (double*) fftw_malloc(sizeof(double) * nPixels_padded * batchSize);
+    batch_fft_cmplx = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nPixels_padded_complex 
+    												* batchSize);
+    batch_out = (double*) fftw_malloc(sizeof(double) * nPixels_padded * batchSize);
+  }
   fftVectorsAllocated = true;
 
-  // set up FFTW plans
-  if (doFFTWMeasure)
-    fftwFlags = FFTW_MEASURE;
-  else
-    fftwFlags = FFTW_ESTIMATE;
-  // Note that there's not much purpose in multi-threading plan_psf, since we only do
-  // the FFT of the PSF once
-  plan_psf = fftw_plan_dft_1d(nPixels_padded, psf_in_cmplx, psf_fft_cmplx, FFTW_FORWARD,
-                             fftwFlags);
-
-#ifdef FFTW_THREADING
-  // TEST: multi-threaded FFTW:
-  int nThreads = 2;
-  fftw_plan_with_nthreads(nThreads);
-#endif  // FFTW_THREADING
-
-  plan_InputProfile = fftw_plan_dft_1d(nPixels_padded, profile_in_cmplx, profile_fft_cmplx, FFTW_FORWARD,
-                             fftwFlags);
-  plan_inverse = fftw_plan_dft_1d(nPixels_padded, multiplied_cmplx, convolvedProfile_cmplx, FFTW_BACKWARD, 
-                             fftwFlags);
-  fftPlansCreated = true;
+  // set up FFTW plans (doFFTWMeasure is the older way of requesting FFTW_MEASURE)
+  if (doFFTWMeasure && (fftwPlanningMode == FFTW_PLANNING_ESTIMATE))
+    fftwPlanningMode = FFTW_PLANNING_MEASURE;
+  if (fftwPlanningMode != FFTW_PLANNING_ESTIMATE)
+    UseFFTWWisdomFile();
+  // Note that FFTW_MEASURE, etc. can overwrite the arrays during planning, so
+  // plans must be made before the PSF is copied into psf_in_padded
+  plan_psf = fftw_plan_dft_r2c_1d(nPixels_padded, psf_in_padded, psf_fft_cmplx,
+  									GetFFTWPlannerFlags(fftwPlanningMode));
+  plans = AcquireFFTWPlans1D(nPixels_padded, 1, fftwPlanningMode, profile_in_padded,
+  							profile_fft_cmplx, convolvedProfile_out, debugStatus);
+  if (batchSize > 1)
+    batchPlans = AcquireFFTWPlans1D(nPixels_padded, batchSize, fftwPlanningMode, 
+  							batch_in_padded, batch_fft_cmplx, batch_out, debugStatus);
+  // Zero the padded input arrays (FFTW_MEASURE, etc. planning may have written to
+  // them); since the forward FFT preserves its input and only the first 
+  // nPixels_data values of each profile are ever written to, the padding stays 
+  // zero from now on
+  for (k = 0; k < nPixels_padded; k++)
+    profile_in_padded[k] = 0.0;
+  if (batchSize > 1)
+    for (k = 0; k < nPixels_padded*batchSize; k++)
+      batch_in_padded[k] = 0.0;
   
 
   // Generate the Fourier transform of the PSF:
@@ -158,115 +288,152 @@ int Convolver1D::DoFullSetup( int debugLevel, bool doFFTWMeasure )
     PrintRealProfile(psfPixels, nPixels_psf);
   }
 
-  // Second, prepare (complex) psf array for FFT, and then copy input PSF into
+  // Second, prepare padded psf array for FFT, and then copy input PSF into
   // it with appropriate shift/wrap:
-  for (k = 0; k < nPixels_padded; k++) {
-    psf_in_cmplx[k][0] = 0.0;
-    psf_in_cmplx[k][1] = 0.0;
-  }
+  for (k = 0; k < nPixels_padded; k++)
+    psf_in_padded[k] = 0.0;
   if (debugStatus >= 1)
     printf("Shifting and wrapping the PSF ...\n");
-  ShiftAndWrapPSF();
+  ShiftAndWrapPSF(psf_in_padded);
   if (debugStatus >= 2) {
     printf("The whole padded, normalized PSF profile:\n");
-    PrintComplexProfile_RealPart(psf_in_cmplx, nPixels_padded);
+    PrintRealProfile(psf_in_padded, nPixels_padded);
   }
   
-  // Finally, do forward FFT on PSF profile
+  // Finally, do forward FFT on PSF profile, then discard padded PSF profile. The 
+  // transform is multiplied by 1/nPixels_padded, to account for FFTW's unnormalized
+  // inverse transform, so that convolved profiles don't need to be rescaled.
   if (debugStatus >= 1)
     printf("Performing FFT of PSF profile ...\n");
   fftw_execute(plan_psf);
+  fftw_destroy_plan(plan_psf);
+  fftw_free(psf_in_padded);
+  rescaleFactor = 1.0 / nPixels_padded;
+  for (k = 0; k < nPixels_padded_complex; k++) {
+    psf_fft_cmplx[k][0] *= rescaleFactor;
+    psf_fft_cmplx[k][1] *= rescaleFactor;
+  }
   
   return 0;
 }
 
 
+/* ---------------- MultiplyByPSFTransform ----------------------------- */
+// Multiplies each of the nProfiles transformed profiles in profile_fft (stored
+// one after the other) by the transform of the PSF, in place.
+void Convolver1D::MultiplyByPSFTransform( fftw_complex *profile_fft, int nProfiles )
+{
+  double  a, b, c, d;
+  
+  for (int n = 0; n < nProfiles; n++) {
+    fftw_complex  *fft = profile_fft + (long)n*nPixels_padded_complex;
+    for (int jj = 0; jj < nPixels_padded_complex; jj++) {
+      a = fft[jj][0];   // real part
+      b = fft[jj][1];   // imaginary part
+      c = psf_fft_cmplx[jj][0];
+      d = psf_fft_cmplx[jj][1];
+      fft[jj][0] = a*c - b*d;
+      fft[jj][1] = b*c + a*d;
+    }
+  }
+}
+
+
 /* ---------------- ConvolveProfile ------------------------------------ */
 // Given an input profiles (pointer to its pixel vector), convolve it with the PSF
-// by: 1) Copying profiles to fft_complex array; 2) Taking FFT of profiles; 3)
-// Multiplying transform of profiles by transform of PSF; 4) Taking inverse FFT
-// of product; 5) Copying (and rescaling) result back into input profile.
+// by: 1) Copying profile into padded array; 2) Taking FFT of profile; 3)
+// Multiplying transform of profile (in place) by transform of PSF, which includes
+// the 1/N rescaling; 4) Taking inverse FFT of product; 5) Copying result back
+// into input profile.
 void Convolver1D::ConvolveProfile( double *pixelVector )
 {
-  int  ii, jj;
-  double  a, b, c, d, realPart;
+  int  ii;
   
   if (debugStatus >= 3) {
     printf("nPixels_data = %d, nPixels_padded = %d\n", nPixels_data, nPixels_padded);
     printf("Original input profile [pixelVector]:\n");
     PrintRealProfile(pixelVector, nPixels_data);
   }
-  // Populate (complex) input profiles array for FFT
-  //   First, zero the complex array (especially need to do this if this isn't the
-  // first time we've called this function!):
-  for (ii = 0; ii < nPixels_padded; ii++) {
-    profile_in_cmplx[ii][0] = 0.0;
-    profile_in_cmplx[ii][1] = 0.0;
-  }
-  //   Second, copy input profile array into complex array (accounting for padding):
-  for (ii = 0; ii < nPixels_data; ii++) {   // step by row number = y
-    profile_in_cmplx[ii][0] = pixelVector[ii];
-  }
+  // Populate input profile array for FFT (padding is already zero)
+  for (ii = 0; ii < nPixels_data; ii++)
+    profile_in_padded[ii] = pixelVector[ii];
   if (debugStatus >= 3) {
-    printf("The whole (padded) input profile [profile_in_cmplx]:\n");
-    PrintComplexProfile_RealPart(profile_in_cmplx, nPixels_padded);
+    printf("The whole (padded) input profile [profile_in_padded]:\n");
+    PrintRealProfile(profile_in_padded, nPixels_padded);
   }
 
   // Do FFT of input profile:
   if (debugStatus >= 2)
     printf("Performing FFT of input profile ...\n");
-  fftw_execute(plan_InputProfile);
+  fftw_execute_dft_r2c(plans->plan_InputProfile, profile_in_padded, profile_fft_cmplx);
   if (debugStatus >= 3) {
     printf("The (modulus of the) transform of the input profile [profile_fft_cmplx]:\n");
-    PrintComplexProfile_Absolute(profile_fft_cmplx, nPixels_padded);
+    PrintComplexProfile_Absolute(profile_fft_cmplx, nPixels_padded_complex);
   }
   
   // Multiply transformed arrays:
-  for (jj = 0; jj < nPixels_padded; jj++) {
-    a = profile_fft_cmplx[jj][0];   // real part
-    b = profile_fft_cmplx[jj][1];   // imaginary part
-    c = psf_fft_cmplx[jj][0];
-    d = psf_fft_cmplx[jj][1];
-    multiplied_cmplx[jj][0] = a*c - b*d;
-    multiplied_cmplx[jj][1] = b*c + a*d;
-  }
+  MultiplyByPSFTransform(profile_fft_cmplx, 1);
   if (debugStatus >= 3) {
-    printf("The product [multiplied_cmplx]:\n");
-    for (jj = 0; jj < nPixels_padded; jj++) {
-      printf("%f + %fi\n", multiplied_cmplx[jj][0], multiplied_cmplx[jj][1]);
-    }
-    printf("\n");
-    printf("The (modulus of the) product [multiplied_cmplx]:\n");
-    PrintComplexProfile_Absolute(multiplied_cmplx, nPixels_padded);
+    printf("The (modulus of the) product [profile_fft_cmplx]:\n");
+    PrintComplexProfile_Absolute(profile_fft_cmplx, nPixels_padded_complex);
   }
 
-  // Do the inverse FFT on the product array:
+  // Do the inverse FFT on the product array (this overwrites the product array):
   if (debugStatus >= 2)
     printf("Performing inverse FFT of multiplied profile ...\n");
-  fftw_execute(plan_inverse);
+  fftw_execute_dft_c2r(plans->plan_inverse, profile_fft_cmplx, convolvedProfile_out);
   if (debugStatus >= 3) {
     printf("The full inverse FFT:\n");
-    for (jj = 0; jj < nPixels_padded; jj++) {
-      printf("%f + %fi\n", convolvedProfile_cmplx[jj][0], convolvedProfile_cmplx[jj][1]);
-    }
-    printf("\n");
+    PrintRealProfile(convolvedProfile_out, nPixels_padded);
+  }
+
+  // Copy the convolved profile into input pixel vector:
+  for (ii = 0; ii < nPixels_data; ii++)
+    pixelVector[ii] = convolvedProfile_out[ii];
+}
+
+
+/* ---------------- ConvolveProfiles ----------------------------------- */
+// Convolves batchSize profiles (stored one after the other in pixelVectors, each
+// with nPixels_data values) with the PSF, using a single batched forward FFT and
+// a single batched inverse FFT. The convolved profiles replace the input profiles.
+void Convolver1D::ConvolveProfiles( double *pixelVectors )
+{
+  int  n, ii;
+  
+  if (batchSize == 1) {
+    ConvolveProfile(pixelVectors);
+    return;
   }
 
+  for (n = 0; n < batchSize; n++) {
+    double  *input = pixelVectors + (long)n*nPixels_data;
+    double  *padded = batch_in_padded + (long)n*nPixels_padded;
+    for (ii = 0; ii < nPixels_data; ii++)
+      padded[ii] = input[ii];
+  }
 
-  // Extract & rescale the real part of the convolved profile and copy into
-  // input pixel vector:
-  for (ii = 0; ii < nPixels_data; ii++) {
-//      realPart = fabs(convolvedProfile_cmplx[ii][0]);
-      realPart = convolvedProfile_cmplx[ii][0];
-      pixelVector[ii] = rescaleFactor * realPart;
+  if (debugStatus >= 2)
+    printf("Performing batched FFT of %d input profiles ...\n", batchSize);
+  fftw_execute_dft_r2c(batchPlans->plan_InputProfile, batch_in_padded, batch_fft_cmplx);
+  MultiplyByPSFTransform(batch_fft_cmplx, batchSize);
+  if (debugStatus >= 2)
+    printf("Performing batched inverse FFT of multiplied profiles ...\n");
+  fftw_execute_dft_c2r(batchPlans->plan_inverse, batch_fft_cmplx, batch_out);
+
+  for (n = 0; n < batchSize; n++) {
+    double  *output = pixelVectors + (long)n*nPixels_data;
+    double  *convolved = batch_out + (long)n*nPixels_padded;
+    for (ii = 0; ii < nPixels_data; ii++)
+      output[ii] = convolved[ii];
   }
 }
 
 
 // ShiftAndWrapPSF: Takes the input PSF (assumed to be centered in the central pixel
-// of the profile) and copy it into the real part of the (padded) fftw_complex profile,
+// of the profile) and copy it into the (padded) real profile psf_in_padded,
 // with the PSF wrapped into the edges, suitable for convolutions.
-void Convolver1D::ShiftAndWrapPSF( )
+void Convolver1D::ShiftAndWrapPSF( double *psf_in_padded )
 {
   int  centerX_psf;
   int  psfPixel, destPixel;
@@ -274,7 +441,7 @@ void Convolver1D::ShiftAndWrapPSF( )
   centerX_psf = nPixels_psf / 2;
   for (psfPixel = 0; psfPixel < nPixels_psf; psfPixel++) {
     destPixel = (nPixels_padded - centerX_psf + psfPixel) % nPixels_padded;
-    psf_in_cmplx[destPixel][0] = psfPixels[psfPixel];
+    psf_in_padded[destPixel] = psfPixels[psfPixel];
   }
 }
 
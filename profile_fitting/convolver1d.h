@@ -3,21 +3,18 @@
  */
  
 //  Convolver object should contain (or contain pointers to):
-// 	input PSF image (pointer to)
-// 	input image (pointer to)
-// 	sizes of PSF image
-// 	sizes of input image
+// 	input PSF profile (pointer to)
+// 	sizes of PSF and data profiles
 // 	
-// 	fftw_complex arrays:
-// 		psf_in
+// 	real arrays (padded):
+// 		profile_in
+// 		convolvedProfile_out
+// 	fftw_complex arrays (padded size/2 + 1):
+// 		profile_fft
 // 		psf_fft
-// 		image_in
-// 		image_fft
-// 		multiplied
-// 		multiplied_fft
 // 	
-// 	FFTW plans:
-// 		plan_psf
+// 	FFTW plans (r2c/c2r, shared with other Convolver1D objects which have
+// 	the same padded size, batch size, and planning mode):
 // 		plan_InputProfile
 // 		plan_inverse
 
@@ -38,6 +35,12 @@ void PrintComplexProfile_RealPart( fftw_complex *data_cmplx, int nPixels );
 void PrintComplexProfile_Absolute( fftw_complex *data_cmplx, int nPixels );
 
 
+/// FFTW plans for forward and inverse transforms of padded profiles, shared by 
+/// all Convolver1D objects with the same padded size, batch size, and planning
+/// mode (defined in convolver1d.cpp)
+struct SharedFFTWPlans1D;
+
+
 class Convolver1D
 {
   public:
@@ -49,27 +52,37 @@ class Convolver1D
     void SetupPSF( double *psfPixels_input, int nPixels );
     
     void SetupProfile( int nPixels );
+
+    void SetFFTWPlanning( int planningMode );
+    
+    void SetBatchSize( int nProfiles );
     
     int DoFullSetup( int debugLevel=0, bool doFFTWMeasure=false );
 
+    int GetPaddedSize( );
+
     void ConvolveProfile( double *pixelVector );
 
+    void ConvolveProfiles( double *pixelVectors );
+
 
   private:
   // Private member functions:
-    void ShiftAndWrapPSF( );
+    void ShiftAndWrapPSF( double *psf_in_padded );
+
+    void MultiplyByPSFTransform( fftw_complex *profile_fft, int nProfiles );
   
     // Data members:
-    int  nPixels_data, nPixels_psf, nPixels_padded;
-    double  rescaleFactor;
-    double  *dataPixels;
+    int  nPixels_data, nPixels_psf, nPixels_padded, nPixels_padded_complex;
+    int  batchSize;
     double  *psfPixels;
-    double  *convolvedData_real, *convolvedData_padded;
-    fftw_complex  *profile_in_cmplx, *profile_fft_cmplx;
-    fftw_complex  *psf_in_cmplx, *psf_fft_cmplx;
-    fftw_complex  *multiplied_cmplx, *convolvedProfile_cmplx;
-    fftw_plan  plan_InputProfile, plan_psf, plan_inverse;
-    bool  psfInfoSet, profileInfoSet, fftVectorsAllocated, fftPlansCreated;
+    double  *profile_in_padded, *convolvedProfile_out;
+    fftw_complex  *profile_fft_cmplx, *psf_fft_cmplx;
+    double  *batch_in_padded, *batch_out;
+    fftw_complex  *batch_fft_cmplx;
+    SharedFFTWPlans1D  *plans, *batchPlans;
+    bool  psfInfoSet, profileInfoSet, fftVectorsAllocated;
+    int  fftwPlanningMode;
     int  debugStatus;
 };
 
@@ -785,7 +785,7 @@ ModelObject1d::~ModelObject1d()
     maskVectorAllocated = false;
   }
   if (doConvolution) {
-    free(psfConvolver);
+    delete psfConvolver;
     free(modelXValues);
     doConvolution = false;
   }
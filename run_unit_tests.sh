@@ -53,6 +53,16 @@ echo $RESULT
 RESULT+=$?
 echo $RESULT
 
+# Unit tests for convolver
+./run_unittest_convolver.sh 2>> temperror.log
+RESULT+=$?
+echo $RESULT
+
+# Unit tests for 1D convolver (profile fitting)
+./run_unittest_convolver1d.sh 2>> temperror.log
+RESULT+=$?
+echo $RESULT
+
 # Unit tests for downsample
 ./run_unittest_downsample.sh 2>> temperror.log
 RESULT+=$?
@@ -32,10 +32,11 @@ function_objects/func_ferrersbar2d.cpp function_objects/func_king.cpp \
 function_objects/func_king2.cpp function_objects/func_pointsource.cpp \
 function_objects/func_pointsource-rot.cpp function_objects/func_peanut_dattathri.cpp \
 function_objects/helper_funcs.cpp function_objects/helper_funcs_3d.cpp \
+function_objects/simd_kernels.cpp \
 function_objects/psf_interpolators.cpp \
 core/mersenne_twister.cpp core/mp_enorm.cpp \
 -I. -Icore -Isolvers -I$EXTERNAL_INCLUDE_PATH -Ifunction_objects -I$CXXTEST \
--L$EXTERNAL_LIB_PATH -lfftw3_threads -lfftw3 -lcfitsio -lgsl -lgslcblas -lm
+-L$EXTERNAL_LIB_PATH -lfftw3_threads -lfftw3 -lfftw3f -lcfitsio -lgsl -lgslcblas -lm
 if [ $? -eq 0 ]
 then
   echo "Running unit tests for add_functions:"
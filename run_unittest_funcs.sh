@@ -15,13 +15,14 @@ $CPP -std=c++11 -o test_runner_funcs test_runner_funcs.cpp function_objects/func
 function_objects/func_exp.cpp function_objects/func_flatsky.cpp \
 function_objects/func_gaussian.cpp function_objects/func_moffat.cpp \
 function_objects/func_sersic.cpp function_objects/func_king.cpp function_objects/func_king2.cpp \
-function_objects/func_nuker.cpp \
+function_objects/func_nuker.cpp function_objects/func_core-sersic.cpp \
 function_objects/func_broken-exp.cpp function_objects/func_double-broken-exp.cpp \
 function_objects/func_broken-exp2d.cpp function_objects/func_edge-on-disk.cpp \
 function_objects/func_gauss_extraparams.cpp function_objects/func_ferrersbar3d.cpp \
 function_objects/func_pointsource.cpp function_objects/psf_interpolators.cpp \
 function_objects_1d/func1d_exp_test.cpp \
 function_objects/helper_funcs.cpp function_objects/helper_funcs_3d.cpp \
+function_objects/simd_kernels.cpp \
 function_objects/integrator.cpp core/utilities.cpp \
 -I$EXTERNAL_INCLUDE_PATH -I$CXXTEST -I. -Icore -Isolvers -Ifunction_objects \
 -L$EXTERNAL_LIB_PATH -lm -lgsl -lgslcblas
@@ -15,9 +15,9 @@ $CXXTESTGEN --error-printer -o test_runner_setup_modelobj.cpp unit_tests/unittes
 $CPP -std=c++11 -o test_runner_setup_modelobj test_runner_setup_modelobj.cpp core/model_object.cpp \
 core/setup_model_object.cpp core/utilities.cpp core/convolver.cpp core/config_file_parser.cpp \
 core/mersenne_twister.cpp core/mp_enorm.cpp core/oversampled_region.cpp core/downsample.cpp \
-core/image_io.cpp core/psf_oversampling_info.cpp function_objects/psf_interpolators.cpp \
+core/image_io.cpp core/psf_oversampling_info.cpp core/estimate_memory.cpp function_objects/psf_interpolators.cpp \
 -I. -Icore -Isolvers -I$EXTERNAL_INCLUDE_PATH -Ifunction_objects -I$CXXTEST \
--L$EXTERNAL_LIB_PATH -lfftw3_threads -lcfitsio -lfftw3 -lgsl -lgslcblas -lm
+-L$EXTERNAL_LIB_PATH -lfftw3_threads -lcfitsio -lfftw3 -lfftw3f -lgsl -lgslcblas -lm
 if [ $? -eq 0 ]
 then
   echo "Running unit tests for setup_model_object:"
@@ -0,0 +1,410 @@
+// Unit tests for convolver.cpp
+//
+// Convolutions (by each method) are compared with brute-force (direct summation)
+// convolutions of the same image, computed within the tests.
+//
+// cxxtestgen --error-printer -o test_runner_convolver.cpp unit_tests/unittest_convolver.t.h
+// g++ -o test_runner_convolver test_runner_convolver.cpp core/convolver.cpp \
+//   -I. -Icore -I/usr/local/include -I$CXXTEST -L/usr/local/lib -lfftw3 -lfftw3f -lgsl -lgslcblas -lm
+// ./test_runner_convolver
+
+#include <cxxtest/TestSuite.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+#include "convolver.h"
+
+// tolerance for double-precision convolutions (absolute, for images with
+// peak values ~ 1 -- 100)
+#define DELTA  1.0e-10
+// Single-precision FFTs have rounding errors ~ 1e-7 times the largest values
+// in the transforms, accumulating roughly as log(N); for the small images used
+// here, we require agreement with the double-precision result to within 1e-5
+// of the image's peak value (~ 1e-6 is typical)
+#define FLOAT_RELATIVE_DELTA  1.0e-5
+
+
+// Brute-force convolution (pixels outside the image = 0), with the PSF center at
+// (nColumns_psf/2, nRows_psf/2), matching Convolver; PSF is normalized here
+void BruteForceConvolution( const vector<double>& image, int nColumns, int nRows,
+							const vector<double>& psf, int nColumns_psf, int nRows_psf,
+							vector<double>& output )
+{
+  int  centerX = nColumns_psf / 2;
+  int  centerY = nRows_psf / 2;
+  double  psfSum = 0.0;
+
+  for (int k = 0; k < nColumns_psf*nRows_psf; k++)
+    psfSum += psf[k];
+  output.assign(nColumns*nRows, 0.0);
+  for (int i = 0; i < nRows; i++) {
+    for (int j = 0; j < nColumns; j++) {
+      double  sum = 0.0;
+      for (int k = 0; k < nRows_psf; k++) {
+        for (int l = 0; l < nColumns_psf; l++) {
+          int  ii = i + centerY - k;
+          int  jj = j + centerX - l;
+          if ((ii >= 0) && (ii < nRows) && (jj >= 0) && (jj < nColumns))
+            sum += psf[k*nColumns_psf + l] * image[ii*nColumns + jj];
+        }
+      }
+      output[i*nColumns + j] = sum / psfSum;
+    }
+  }
+}
+
+
+class TestConvolver : public CxxTest::TestSuite
+{
+  // data members
+  int  nColumns, nRows;
+  int  nColumns_psf, nRows_psf;
+  vector<double>  inputImage;
+  vector<double>  gaussianPSF, asymmetricPSF;
+
+
+public:
+  void setUp()
+  {
+    // 37 x 29 image: smooth elliptical blob plus a bright point near one corner
+    nColumns = 37;
+    nRows = 29;
+    inputImage.assign(nColumns*nRows, 0.0);
+    for (int i = 0; i < nRows; i++) {
+      for (int j = 0; j < nColumns; j++) {
+        double  dx = j - 20.3;
+        double  dy = i - 13.7;
+        inputImage[i*nColumns + j] = 10.0*exp(-(dx*dx/50.0 + dy*dy/20.0));
+      }
+    }
+    inputImage[3*nColumns + 4] += 100.0;
+
+    // 7 x 5 PSFs: off-center elliptical Gaussian (separable), and a
+    // non-separable asymmetric PSF
+    nColumns_psf = 7;
+    nRows_psf = 5;
+    gaussianPSF.assign(nColumns_psf*nRows_psf, 0.0);
+    asymmetricPSF.assign(nColumns_psf*nRows_psf, 0.0);
+    for (int k = 0; k < nRows_psf; k++) {
+      for (int l = 0; l < nColumns_psf; l++) {
+        double  dx = l - 3.3;
+        double  dy = k - 1.8;
+        gaussianPSF[k*nColumns_psf + l] = exp(-(dx*dx/3.0 + dy*dy/2.0));
+        asymmetricPSF[k*nColumns_psf + l] = exp(-sqrt(dx*dx + dy*dy + 0.7*dx*dy + 0.1));
+      }
+    }
+    asymmetricPSF[1*nColumns_psf + 5] += 0.3;
+  }
+
+
+  // Convolves a copy of inputImage with the PSF using the specified method and
+  // precision, and returns the result in output
+  void DoConvolution( vector<double>& psf, int engineType, bool useFloat,
+  					vector<double>& output )
+  {
+    Convolver  *convolver = new Convolver();
+    vector<double>  psfCopy = psf;
+
+    output = inputImage;
+    convolver->SetupPSF(psfCopy.data(), nColumns_psf, nRows_psf);
+    convolver->SetupImage(nColumns, nRows);
+    convolver->SetConvolutionEngine(engineType);
+    convolver->UseFloatConvolution(useFloat);
+    TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+    convolver->ConvolveImage(output.data());
+    delete convolver;
+  }
+
+
+  void testFFTConvolution( void )
+  {
+    vector<double>  reference, output;
+
+    BruteForceConvolution(inputImage, nColumns, nRows, asymmetricPSF, nColumns_psf,
+    						nRows_psf, reference);
+    DoConvolution(asymmetricPSF, CONVOLUTION_ENGINE_FFT, false, output);
+    for (int k = 0; k < nColumns*nRows; k++)
+      TS_ASSERT_DELTA( output[k], reference[k], DELTA );
+  }
+
+  void testSpatialConvolution( void )
+  {
+    vector<double>  reference, output;
+
+    BruteForceConvolution(inputImage, nColumns, nRows, asymmetricPSF, nColumns_psf,
+    						nRows_psf, reference);
+    DoConvolution(asymmetricPSF, CONVOLUTION_ENGINE_DIRECT, false, output);
+    for (int k = 0; k < nColumns*nRows; k++)
+      TS_ASSERT_DELTA( output[k], reference[k], DELTA );
+
+    BruteForceConvolution(inputImage, nColumns, nRows, gaussianPSF, nColumns_psf,
+    						nRows_psf, reference);
+    DoConvolution(gaussianPSF, CONVOLUTION_ENGINE_SEPARABLE, false, output);
+    for (int k = 0; k < nColumns*nRows; k++)
+      TS_ASSERT_DELTA( output[k], reference[k], DELTA );
+  }
+
+  // The Convolver keeps its own copy of the PSF, so changing (or freeing) the
+  // caller's PSF array after setup must not affect any of the methods
+  void testPSFCopiedAtSetup( void )
+  {
+    vector<double>  reference, output;
+    int  engineTypes[3] = {CONVOLUTION_ENGINE_FFT, CONVOLUTION_ENGINE_DIRECT,
+    						CONVOLUTION_ENGINE_SEPARABLE};
+
+    BruteForceConvolution(inputImage, nColumns, nRows, gaussianPSF, nColumns_psf,
+    						nRows_psf, reference);
+    for (int m = 0; m < 3; m++) {
+      vector<double>  psfCopy = gaussianPSF;
+      Convolver  *convolver = new Convolver();
+      convolver->SetupPSF(psfCopy.data(), nColumns_psf, nRows_psf);
+      convolver->SetupImage(nColumns, nRows);
+      convolver->SetConvolutionEngine(engineTypes[m]);
+      TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+      psfCopy.assign(psfCopy.size(), -1.0);
+      output = inputImage;
+      convolver->ConvolveImage(output.data());
+      for (int k = 0; k < nColumns*nRows; k++)
+        TS_ASSERT_DELTA( output[k], reference[k], DELTA );
+      delete convolver;
+    }
+  }
+
+  // Automatic choice is between the exact methods only, based on image and PSF
+  // sizes: direct convolution for a very small PSF, FFT for a large one, and
+  // never the (approximate) separable method, even for a separable PSF
+  void testAutomaticEngineChoice( void )
+  {
+    Convolver  *convolver;
+    vector<double>  reference, output;
+    vector<double>  smallPSF(3*3, 0.0);
+    vector<double>  largePSF(25*25, 1.0);
+
+    smallPSF[4] = 1.0;
+    convolver = new Convolver();
+    convolver->SetupPSF(smallPSF.data(), 3, 3);
+    convolver->SetupImage(nColumns, nRows);
+    TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+    TS_ASSERT_EQUALS( convolver->GetConvolutionEngine(), CONVOLUTION_ENGINE_DIRECT );
+    delete convolver;
+
+    convolver = new Convolver();
+    convolver->SetupPSF(largePSF.data(), 25, 25);
+    convolver->SetupImage(nColumns, nRows);
+    TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+    TS_ASSERT_EQUALS( convolver->GetConvolutionEngine(), CONVOLUTION_ENGINE_FFT );
+    delete convolver;
+
+    BruteForceConvolution(inputImage, nColumns, nRows, gaussianPSF, nColumns_psf,
+    						nRows_psf, reference);
+    vector<double>  psfCopy = gaussianPSF;
+    convolver = new Convolver();
+    convolver->SetupPSF(psfCopy.data(), nColumns_psf, nRows_psf);
+    convolver->SetupImage(nColumns, nRows);
+    TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+    TS_ASSERT_DIFFERS( convolver->GetConvolutionEngine(), CONVOLUTION_ENGINE_SEPARABLE );
+    output = inputImage;
+    convolver->ConvolveImage(output.data());
+    for (int k = 0; k < nColumns*nRows; k++)
+      TS_ASSERT_DELTA( output[k], reference[k], DELTA );
+    delete convolver;
+  }
+
+  // Convolvers with the same padded size and PSF share the PSF transform and
+  // FFTW plans; results must be unaffected, including after the Convolver which
+  // created the shared resources is deleted
+  void testSharedPSFTransform( void )
+  {
+    vector<double>  reference, output1, output2, output3;
+    vector<double>  psfCopy1 = asymmetricPSF;
+    vector<double>  psfCopy2 = asymmetricPSF;
+    vector<double>  psfCopy3 = gaussianPSF;
+
+    BruteForceConvolution(inputImage, nColumns, nRows, asymmetricPSF, nColumns_psf,
+    						nRows_psf, reference);
+    Convolver  *convolver1 = new Convolver();
+    Convolver  *convolver2 = new Convolver();
+    Convolver  *convolver3 = new Convolver();
+    convolver1->SetupPSF(psfCopy1.data(), nColumns_psf, nRows_psf);
+    convolver2->SetupPSF(psfCopy2.data(), nColumns_psf, nRows_psf);
+    convolver3->SetupPSF(psfCopy3.data(), nColumns_psf, nRows_psf);
+    convolver1->SetupImage(nColumns, nRows);
+    convolver2->SetupImage(nColumns, nRows);
+    convolver3->SetupImage(nColumns, nRows);
+    convolver1->SetConvolutionEngine(CONVOLUTION_ENGINE_FFT);
+    convolver2->SetConvolutionEngine(CONVOLUTION_ENGINE_FFT);
+    convolver3->SetConvolutionEngine(CONVOLUTION_ENGINE_FFT);
+    TS_ASSERT_EQUALS( convolver1->DoFullSetup(), 0 );
+    TS_ASSERT_EQUALS( convolver2->DoFullSetup(), 0 );
+    TS_ASSERT_EQUALS( convolver3->DoFullSetup(), 0 );
+    TS_ASSERT_EQUALS( convolver1->GetNSharingConvolvers(), 2 );
+    TS_ASSERT_EQUALS( convolver2->GetNSharingConvolvers(), 2 );
+    TS_ASSERT_EQUALS( convolver3->GetNSharingConvolvers(), 1 );
+
+    output1 = inputImage;
+    convolver1->ConvolveImage(output1.data());
+    delete convolver1;
+    TS_ASSERT_EQUALS( convolver2->GetNSharingConvolvers(), 1 );
+    output2 = inputImage;
+    convolver2->ConvolveImage(output2.data());
+    output3 = inputImage;
+    convolver3->ConvolveImage(output3.data());
+    for (int k = 0; k < nColumns*nRows; k++) {
+      TS_ASSERT_DELTA( output1[k], reference[k], DELTA );
+      TS_ASSERT_EQUALS( output2[k], output1[k] );
+    }
+    BruteForceConvolution(inputImage, nColumns, nRows, gaussianPSF, nColumns_psf,
+    						nRows_psf, reference);
+    for (int k = 0; k < nColumns*nRows; k++)
+      TS_ASSERT_DELTA( output3[k], reference[k], DELTA );
+    delete convolver2;
+    delete convolver3;
+  }
+
+  // Writing the image directly into the padded FFT input array (repeatedly, as
+  // when computing successive model images) must give the same result as
+  // ConvolveImage()
+  void testPaddedInputConvolution( void )
+  {
+    vector<double>  reference, output(nColumns*nRows, 0.0);
+    vector<double>  psfCopy = asymmetricPSF;
+    long  rowStride;
+
+    BruteForceConvolution(inputImage, nColumns, nRows, asymmetricPSF, nColumns_psf,
+    						nRows_psf, reference);
+    Convolver  *convolver = new Convolver();
+    convolver->SetupPSF(psfCopy.data(), nColumns_psf, nRows_psf);
+    convolver->SetupImage(nColumns, nRows);
+    convolver->SetConvolutionEngine(CONVOLUTION_ENGINE_FFT);
+    TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+    double  *paddedImage = convolver->GetPaddedInputImage(rowStride);
+    TS_ASSERT( paddedImage != nullptr );
+    TS_ASSERT( rowStride >= nColumns );
+    for (int n = 0; n < 2; n++) {
+      for (int i = 0; i < nRows; i++)
+        for (int j = 0; j < nColumns; j++)
+          paddedImage[i*rowStride + j] = inputImage[i*nColumns + j];
+      convolver->ConvolvePaddedImage(output.data());
+      for (int k = 0; k < nColumns*nRows; k++)
+        TS_ASSERT_DELTA( output[k], reference[k], DELTA );
+    }
+    delete convolver;
+
+    // not available for spatial-domain or single-precision convolution
+    psfCopy = asymmetricPSF;
+    convolver = new Convolver();
+    convolver->SetupPSF(psfCopy.data(), nColumns_psf, nRows_psf);
+    convolver->SetupImage(nColumns, nRows);
+    convolver->SetConvolutionEngine(CONVOLUTION_ENGINE_DIRECT);
+    TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+    TS_ASSERT( convolver->GetPaddedInputImage(rowStride) == nullptr );
+    delete convolver;
+    psfCopy = asymmetricPSF;
+    convolver = new Convolver();
+    convolver->SetupPSF(psfCopy.data(), nColumns_psf, nRows_psf);
+    convolver->SetupImage(nColumns, nRows);
+    convolver->SetConvolutionEngine(CONVOLUTION_ENGINE_FFT);
+    convolver->UseFloatConvolution(true);
+    TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+    TS_ASSERT( convolver->GetPaddedInputImage(rowStride) == nullptr );
+    delete convolver;
+  }
+
+  // Tiled (overlap-save) FFT convolution, with tiles which don't evenly divide
+  // the image; tiles as large as the image mean ordinary FFT convolution
+  void testTiledConvolution( void )
+  {
+    vector<double>  reference, output;
+    vector<double>  psfCopy;
+    int  tileSizes[3] = {8, 16, 40};
+    int  expectedEngines[3] = {CONVOLUTION_ENGINE_TILED, CONVOLUTION_ENGINE_TILED,
+    							CONVOLUTION_ENGINE_FFT};
+
+    BruteForceConvolution(inputImage, nColumns, nRows, asymmetricPSF, nColumns_psf,
+    						nRows_psf, reference);
+    for (int n = 0; n < 3; n++) {
+      Convolver  *convolver = new Convolver();
+      psfCopy = asymmetricPSF;
+      output = inputImage;
+      convolver->SetupPSF(psfCopy.data(), nColumns_psf, nRows_psf);
+      convolver->SetupImage(nColumns, nRows);
+      convolver->SetConvolutionEngine(CONVOLUTION_ENGINE_TILED);
+      convolver->SetTileSize(tileSizes[n]);
+      TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+      TS_ASSERT_EQUALS( convolver->GetConvolutionEngine(), expectedEngines[n] );
+      convolver->ConvolveImage(output.data());
+      for (int k = 0; k < nColumns*nRows; k++)
+        TS_ASSERT_DELTA( output[k], reference[k], DELTA );
+      delete convolver;
+    }
+  }
+
+  // Spatially varying PSF = sum of two (unnormalized) basis PSFs, with weights
+  // varying linearly across the image; compared with the sum of brute-force 
+  // convolutions of the weighted images
+  void testPSFBasisConvolution( void )
+  {
+    vector<double>  reference(nColumns*nRows, 0.0), weightedImage, output;
+    vector<double>  psf0 = gaussianPSF;
+    vector<double>  psf1 = asymmetricPSF;
+    vector<double>  coeffs0(nColumns*nRows), coeffs1(nColumns*nRows);
+    vector<double *>  basisPixels = {psf0.data(), psf1.data()};
+    vector<double *>  coeffMaps = {coeffs0.data(), coeffs1.data()};
+    int  engineTypes[2] = {CONVOLUTION_ENGINE_FFT, CONVOLUTION_ENGINE_DIRECT};
+
+    for (int i = 0; i < nRows; i++) {
+      for (int j = 0; j < nColumns; j++) {
+        coeffs0[i*nColumns + j] = (double)j / (nColumns - 1);
+        coeffs1[i*nColumns + j] = 2.0*(1.0 - coeffs0[i*nColumns + j]) + 0.01*i;
+      }
+    }
+    for (int k = 0; k < 2; k++) {
+      vector<double>  convolved;
+      double  psfSum = 0.0;
+      for (int n = 0; n < nColumns_psf*nRows_psf; n++)
+        psfSum += basisPixels[k][n];
+      weightedImage = inputImage;
+      for (int n = 0; n < nColumns*nRows; n++)
+        weightedImage[n] *= coeffMaps[k][n];
+      BruteForceConvolution(weightedImage, nColumns, nRows, (k == 0) ? psf0 : psf1,
+      						nColumns_psf, nRows_psf, convolved);
+      for (int n = 0; n < nColumns*nRows; n++)
+        reference[n] += psfSum*convolved[n];
+    }
+
+    for (int m = 0; m < 2; m++) {
+      Convolver  *convolver = new Convolver();
+      output = inputImage;
+      convolver->SetupPSFBasis(basisPixels, nColumns_psf, nRows_psf, coeffMaps);
+      convolver->SetupImage(nColumns, nRows);
+      convolver->SetConvolutionEngine(engineTypes[m]);
+      TS_ASSERT_EQUALS( convolver->DoFullSetup(), 0 );
+      TS_ASSERT_EQUALS( convolver->GetNBasisPSFs(), 2 );
+      TS_ASSERT_EQUALS( convolver->GetConvolutionEngine(), engineTypes[m] );
+      convolver->ConvolveImage(output.data());
+      for (int n = 0; n < nColumns*nRows; n++)
+        TS_ASSERT_DELTA( output[n], reference[n], DELTA );
+      delete convolver;
+    }
+    // basis PSFs are not normalized
+    TS_ASSERT_EQUALS( psf0, gaussianPSF );
+  }
+
+  // Single-precision FFT convolution vs double-precision FFT convolution
+  void testFloatConvolution( void )
+  {
+    vector<double>  reference, output;
+    double  peakValue = 0.0;
+
+    DoConvolution(asymmetricPSF, CONVOLUTION_ENGINE_FFT, false, reference);
+    DoConvolution(asymmetricPSF, CONVOLUTION_ENGINE_FFT, true, output);
+    for (int k = 0; k < nColumns*nRows; k++)
+      peakValue = fmax(peakValue, fabs(reference[k]));
+    for (int k = 0; k < nColumns*nRows; k++)
+      TS_ASSERT_DELTA( output[k], reference[k], FLOAT_RELATIVE_DELTA*peakValue );
+  }
+};
@@ -0,0 +1,176 @@
+// Unit tests for convolver1d.cpp
+//
+// Convolutions (single and batched) are compared with brute-force (direct
+// summation) convolutions of the same profiles, computed within the tests.
+//
+// cxxtestgen --error-printer -o test_runner_convolver1d.cpp unit_tests/unittest_convolver1d.t.h
+// g++ -o test_runner_convolver1d test_runner_convolver1d.cpp profile_fitting/convolver1d.cpp \
+//   core/convolver.cpp -I. -Icore -Iprofile_fitting -I/usr/local/include -I$CXXTEST \
+//   -L/usr/local/lib -lfftw3 -lfftw3f -lgsl -lgslcblas -lm
+// ./test_runner_convolver1d
+
+#include <cxxtest/TestSuite.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+#include "convolver1d.h"
+
+#define DELTA  1.0e-10
+
+
+// Brute-force 1D convolution (pixels outside the profile = 0), with the PSF center
+// at nPixels_psf/2, matching Convolver1D; PSF is normalized here
+void BruteForceConvolution1D( const vector<double>& profile, const vector<double>& psf,
+								vector<double>& output )
+{
+  int  nPixels = (int)profile.size();
+  int  nPixels_psf = (int)psf.size();
+  int  center = nPixels_psf / 2;
+  double  psfSum = 0.0;
+
+  for (int k = 0; k < nPixels_psf; k++)
+    psfSum += psf[k];
+  output.assign(nPixels, 0.0);
+  for (int i = 0; i < nPixels; i++) {
+    for (int k = 0; k < nPixels_psf; k++) {
+      int  j = i + center - k;
+      if ((j >= 0) && (j < nPixels))
+        output[i] += profile[j] * psf[k] / psfSum;
+    }
+  }
+}
+
+// Simple test profile: exponential plus a small sinusoidal component
+void MakeTestProfile( int nPixels, double h, vector<double>& profile )
+{
+  profile.resize(nPixels);
+  for (int i = 0; i < nPixels; i++)
+    profile[i] = 100.0*exp(-i/h) + 2.0*sin(0.3*i) + 3.0;
+}
+
+// Asymmetric test PSF (so that errors in shifting/wrapping are detected)
+void MakeTestPSF( int nPixels_psf, vector<double>& psf )
+{
+  psf.resize(nPixels_psf);
+  for (int k = 0; k < nPixels_psf; k++)
+    psf[k] = exp(-0.5*pow((k - nPixels_psf/2 + 0.3)/1.7, 2.0)) + 0.01*k;
+}
+
+
+class NewTestSuite : public CxxTest::TestSuite
+{
+public:
+
+  void testPaddedSizeIsFFTFriendly( void )
+  {
+    vector<double>  psf;
+    Convolver1D  psfConvolver;
+    int  nPadded, n;
+
+    // minimum padded size = 101 + 15 - 1 = 115 = 5*23; next size with only
+    // small prime factors is 120
+    MakeTestPSF(15, psf);
+    psfConvolver.SetupPSF(psf.data(), 15);
+    psfConvolver.SetupProfile(101);
+    psfConvolver.DoFullSetup();
+    nPadded = psfConvolver.GetPaddedSize();
+    TS_ASSERT( nPadded >= 115 );
+    n = nPadded;
+    for (int p : {2, 3, 5, 7})
+      while ((n % p) == 0)
+        n /= p;
+    TS_ASSERT_EQUALS(n, 1);
+  }
+
+  void testConvolveProfile( void )
+  {
+    vector<double>  profile, psf, correct;
+
+    for (int nPixels_psf : {1, 4, 15, 40}) {
+      Convolver1D  psfConvolver;
+      MakeTestProfile(77, 10.0, profile);
+      MakeTestPSF(nPixels_psf, psf);
+      BruteForceConvolution1D(profile, psf, correct);
+
+      psfConvolver.SetupPSF(psf.data(), nPixels_psf);
+      psfConvolver.SetupProfile(77);
+      TS_ASSERT_EQUALS(psfConvolver.DoFullSetup(), 0);
+      // do it twice, to check that the padding stays zero
+      for (int n = 0; n < 2; n++) {
+        vector<double>  output(profile);
+        psfConvolver.ConvolveProfile(output.data());
+        for (int i = 0; i < 77; i++)
+          TS_ASSERT_DELTA(output[i], correct[i], DELTA);
+      }
+    }
+  }
+
+  void testConvolveProfiles_batched( void )
+  {
+    int  nProfiles = 5;
+    int  nPixels = 60;
+    int  nPixels_psf = 11;
+    vector<double>  profile, psf, correct;
+    vector<double>  allProfiles;
+    Convolver1D  psfConvolver;
+
+    MakeTestPSF(nPixels_psf, psf);
+    for (int n = 0; n < nProfiles; n++) {
+      MakeTestProfile(nPixels, 3.0 + 2.0*n, profile);
+      allProfiles.insert(allProfiles.end(), profile.begin(), profile.end());
+    }
+
+    psfConvolver.SetupPSF(psf.data(), nPixels_psf);
+    psfConvolver.SetupProfile(nPixels);
+    psfConvolver.SetBatchSize(nProfiles);
+    TS_ASSERT_EQUALS(psfConvolver.DoFullSetup(), 0);
+    psfConvolver.ConvolveProfiles(allProfiles.data());
+
+    for (int n = 0; n < nProfiles; n++) {
+      MakeTestProfile(nPixels, 3.0 + 2.0*n, profile);
+      BruteForceConvolution1D(profile, psf, correct);
+      for (int i = 0; i < nPixels; i++)
+        TS_ASSERT_DELTA(allProfiles[n*nPixels + i], correct[i], DELTA);
+    }
+  }
+
+  // Convolver1D objects with the same sizes share FFTW plans, but must still
+  // give correct (and independent) results, including after one is deleted
+  void testSharedPlans( void )
+  {
+    int  nPixels = 50;
+    vector<double>  profile, psf1, psf2, correct1, correct2;
+
+    MakeTestProfile(nPixels, 8.0, profile);
+    MakeTestPSF(9, psf1);
+    psf2.assign(9, 0.0);
+    psf2[2] = 1.0;
+    psf2[3] = 3.0;
+    BruteForceConvolution1D(profile, psf1, correct1);
+    BruteForceConvolution1D(profile, psf2, correct2);
+
+    Convolver1D  *convolver1 = new Convolver1D();
+    Convolver1D  *convolver2 = new Convolver1D();
+    convolver1->SetupPSF(psf1.data(), 9);
+    convolver1->SetupProfile(nPixels);
+    convolver1->DoFullSetup();
+    convolver2->SetupPSF(psf2.data(), 9);
+    convolver2->SetupProfile(nPixels);
+    convolver2->DoFullSetup();
+    TS_ASSERT_EQUALS(convolver1->GetPaddedSize(), convolver2->GetPaddedSize());
+
+    vector<double>  output1(profile), output2(profile);
+    convolver1->ConvolveProfile(output1.data());
+    delete convolver1;
+    convolver2->ConvolveProfile(output2.data());
+    for (int i = 0; i < nPixels; i++) {
+      TS_ASSERT_DELTA(output1[i], correct1[i], DELTA);
+      TS_ASSERT_DELTA(output2[i], correct2[i], DELTA);
+    }
+    delete convolver2;
+  }
+};
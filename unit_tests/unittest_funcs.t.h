@@ -11,6 +11,8 @@
 #include <math.h>
 #include <string>
 #include <vector>
+#include <thread>
+#include <gsl/gsl_sf_gamma.h>
 using namespace std;
 
 // test stuff (not official image functions)
@@ -32,6 +34,10 @@ using namespace std;
 #include "function_objects/func_ferrersbar3d.h"
 #include "function_objects/func_double-broken-exp.h"
 #include "function_objects/func_nuker.h"
+#include "function_objects/func_core-sersic.h"
+#include "function_objects/simd_kernels.h"
+#include "function_objects/integrator.h"
+#include "function_objects/helper_funcs.h"
 //#include "function_objects/func_spline-profile.h"
 
 const double  DELTA = 1.0e-9;
@@ -41,6 +47,40 @@ const double  DELTA_e7 = 1.0e-7;
 const double PI = 3.14159265358979;
 
 
+// Checks that intensities interpolated from the radial-profile lookup table
+// match directly computed ones, at radii (along the x axis, from x0,y0) 
+// covering both the inner and outer parts of the table. Values which are tiny 
+// compared to the central value are only checked in absolute terms.
+void CheckProfileTable( FunctionObject *funcObj, double params[], double tolerance )
+{
+  double  x0 = 1000.0;
+  double  y0 = 1000.0;
+  double  radii[14] = {0.0, 0.00031, 0.0071, 0.093, 0.47, 1.3, 3.7, 8.9, 10.4, 17.3, 
+  						42.6, 95.1, 230.7, 611.9};
+  double  directVals[14];
+  double  centralVal;
+
+  funcObj->UseProfileTable(0.0);
+  funcObj->Setup(params, 0, x0, y0);
+  for (int k = 0; k < 14; k++)
+    directVals[k] = funcObj->GetValue(x0 + radii[k], y0 + 0.3*radii[k]);
+  centralVal = directVals[0];
+
+  funcObj->UseProfileTable(2000.0);
+  funcObj->Setup(params, 0, x0, y0);
+  for (int k = 0; k < 14; k++) {
+    double  tableVal = funcObj->GetValue(x0 + radii[k], y0 + 0.3*radii[k]);
+    if (fabs(directVals[k]) > 1.0e-8*fabs(centralVal)) {
+      TS_ASSERT_DELTA( tableVal/directVals[k], 1.0, tolerance );
+    }
+    else {
+      TS_ASSERT_DELTA( tableVal, directVals[k], 1.0e-8*fabs(centralVal) );
+    }
+  }
+  funcObj->UseProfileTable(0.0);
+}
+
+
 // Testing temporary 1D function (exponential with linear input and output,
 // plus SetExtraParams testing)
 class TestExp1DTest : public CxxTest::TestSuite 
@@ -239,6 +279,14 @@ public:
 
 
   // and now the actual tests
+  void testProfileTable( void )
+  {
+    // PA, ell, I_0, h
+    double  params[4] = {30.0, 0.3, 100.0, 20.0};
+
+    CheckProfileTable(thisFunc, params, 1.0e-5);
+  }
+
   void testBasic( void )
   {
     vector<string>  paramNames;
@@ -419,6 +467,111 @@ public:
 
   }
 
+  void testGetValues( void )
+  {
+    // centered at x0,y0 = 10,10
+    double  x0 = 10.0;
+    double  y0 = 10.0;
+    // FUNCTION-SPECIFIC:
+    // test setup: elliptical Sersic with n = 2, I_e = 1, r_e = 5,
+    double  params[5] = {30.0, 0.4, 2.0, 1.0, 5.0};
+    int  nPixels = 20;
+    double  rowVals[20];
+    
+    // row-oriented values should match pixel-by-pixel values, both with and
+    // without subsampling (subsampled pixels are near the center)
+    thisFunc->Setup(params, 0, x0, y0);
+    thisFunc->GetValues(11.0, 1.0, 1.0, nPixels, rowVals);
+    for (int k = 0; k < nPixels; k++)
+      TS_ASSERT_DELTA( rowVals[k], thisFunc->GetValue(1.0 + k, 11.0), DELTA );
+
+    thisFunc->SetSubsampling(true);
+    thisFunc->Setup(params, 0, x0, y0);
+    thisFunc->GetValues(11.0, 0.5, 0.25, nPixels, rowVals);
+    for (int k = 0; k < nPixels; k++)
+      TS_ASSERT_DELTA( rowVals[k], thisFunc->GetValue(0.5 + k*0.25, 11.0), DELTA );
+  }
+
+  void testGetFootprint( void )
+  {
+    double  x0 = 10.0;
+    double  y0 = 10.0;
+    double  params[5] = {90.0, 0.0, 2.0, 1.0, 10.0};
+    double  params_n04[5] = {90.0, 0.0, 0.4, 1.0, 10.0};
+    double  nVals[2] = {2.0, 4.0};
+    double  xMin, xMax, yMin, yMax;
+    double  centralValue, r_fp, bn;
+    
+    // no footprint by default
+    thisFunc->Setup(params, 0, x0, y0);
+    TS_ASSERT_EQUALS( thisFunc->GetFootprint(xMin, xMax, yMin, yMax), false );
+
+    // n = 0.4 (falls off faster than a Gaussian): intensity at edge of (circular)
+    // footprint should = fraction * central intensity
+    thisFunc->SetFootprintFraction(1.0e-3);
+    thisFunc->Setup(params_n04, 0, x0, y0);
+    TS_ASSERT_EQUALS( thisFunc->GetFootprint(xMin, xMax, yMin, yMax), true );
+    TS_ASSERT_DELTA( xMax - x0, x0 - xMin, DELTA );
+    TS_ASSERT_DELTA( yMax - y0, xMax - x0, DELTA );
+    TS_ASSERT_DELTA( yMax - y0, y0 - yMin, DELTA );
+    centralValue = thisFunc->GetValue(x0, y0);
+    TS_ASSERT_DELTA( thisFunc->GetValue(xMax, y0)/centralValue, 1.0e-3, DELTA );
+    TS_ASSERT_DELTA( thisFunc->GetValue(x0, yMin)/centralValue, 1.0e-3, DELTA );
+
+    // larger n: footprint set by requirement that flux outside it = fraction of
+    // total flux (and intensity at edge is < fraction * central intensity)
+    for (int i = 0; i < 2; i++) {
+      params[2] = nVals[i];
+      thisFunc->Setup(params, 0, x0, y0);
+      TS_ASSERT_EQUALS( thisFunc->GetFootprint(xMin, xMax, yMin, yMax), true );
+      centralValue = thisFunc->GetValue(x0, y0);
+      TS_ASSERT( thisFunc->GetValue(xMax, y0)/centralValue < 1.0e-3 );
+      r_fp = xMax - x0;
+      bn = Calculate_bn(nVals[i]);
+      TS_ASSERT_DELTA( gsl_sf_gamma_inc_Q(2.0*nVals[i], bn*pow(r_fp/10.0, 1.0/nVals[i])), 
+      					1.0e-3, 1.0e-8 );
+    }
+  }
+
+  void testProfileTable( void )
+  {
+    double  x0 = 10.0;
+    double  y0 = 10.0;
+    double  params[5] = {30.0, 0.3, 4.0, 1.0, 5.0};
+    double  xVals[6] = {10.0, 10.00001, 10.3, 12.7, 24.5, 80.0};
+    double  yVals[6] = {10.0, 10.0, 9.6, 11.1, 3.2, 61.0};
+    double  directVals[6];
+    
+    thisFunc->Setup(params, 0, x0, y0);
+    for (int k = 0; k < 6; k++)
+      directVals[k] = thisFunc->GetValue(xVals[k], yVals[k]);
+
+    // table-interpolated values should match directly computed values
+    thisFunc->UseProfileTable(200.0);
+    thisFunc->Setup(params, 0, x0, y0);
+    for (int k = 0; k < 6; k++)
+      TS_ASSERT_DELTA( thisFunc->GetValue(xVals[k], yVals[k])/directVals[k], 1.0, 1.0e-5 );
+
+    // turning tables off restores direct computation
+    thisFunc->UseProfileTable(0.0);
+    thisFunc->Setup(params, 0, x0, y0);
+    for (int k = 0; k < 6; k++)
+      TS_ASSERT_EQUALS( thisFunc->GetValue(xVals[k], yVals[k]), directVals[k] );
+  }
+
+  // the number of table entries (intensity evaluations per Setup call) should be 
+  // a few thousand at most, even for very large images
+  void testProfileTableSize( void )
+  {
+    RadialProfileTable  table;
+
+    // diagonal of 2k x 2k image
+    table.SetMaxRadius(2900.0);
+    TS_ASSERT( table.GetNEntries() < 2000 );
+    table.SetMaxRadius(1.0e6);
+    TS_ASSERT( table.GetNEntries() <= 400 + PROFILE_TABLE_MAX_OUTER );
+  }
+
   void testUnitNames( void )
   {
     int  nParams = 5;
@@ -499,6 +652,33 @@ public:
 
 
 
+class TestCoreSersic : public CxxTest::TestSuite 
+{
+  FunctionObject  *thisFunc;
+  
+public:
+  void setUp()
+  {
+    thisFunc = new CoreSersic();
+    thisFunc->SetSubsampling(false);
+  }
+  
+  void tearDown()
+  {
+    delete thisFunc;
+  }
+
+  void testProfileTable( void )
+  {
+    // PA, ell, n, I_b, r_e, r_b, alpha, gamma
+    double  params[8] = {30.0, 0.3, 4.0, 10.0, 50.0, 5.0, 2.0, 0.3};
+
+    CheckProfileTable(thisFunc, params, 1.0e-5);
+  }
+};
+
+
+
 class TestGaussian : public CxxTest::TestSuite 
 {
   FunctionObject  *thisFunc, *thisFunc_subsampled;
@@ -519,6 +699,14 @@ public:
 
 
   // and now the actual tests
+  void testProfileTable( void )
+  {
+    // PA, ell, I_0, sigma
+    double  params[4] = {30.0, 0.3, 100.0, 15.0};
+
+    CheckProfileTable(thisFunc, params, 1.0e-5);
+  }
+
   void testBasic( void )
   {
     vector<string>  paramNames;
@@ -904,6 +1092,19 @@ public:
     TS_ASSERT_DELTA( thisFunc->GetValue(10.0, 9.0), rEqualsOneValue, DELTA );
   }
 
+  void testGetValues( void )
+  {
+    double  params1[1] = {1.5};
+    double  rowVals[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+    
+    thisFunc->Setup(params1, 0, 10.0, 10.0);
+    thisFunc->GetValues(10.0, 1.0, 1.0, 4, rowVals);
+    for (int k = 0; k < 4; k++)
+      TS_ASSERT_DELTA( rowVals[k], 1.5, DELTA );
+    // values beyond nPixels should not be touched
+    TS_ASSERT_DELTA( rowVals[4], 0.0, DELTA );
+  }
+
   void testUnitNames( void )
   {
     int  nParams = 1;
@@ -951,6 +1152,14 @@ public:
 
 
   // and now the actual tests
+  void testProfileTable( void )
+  {
+    // PA, ell, I_0, fwhm, beta
+    double  params[5] = {30.0, 0.3, 100.0, 10.0, 2.5};
+
+    CheckProfileTable(thisFunc, params, 1.0e-5);
+  }
+
   void testBasic( void )
   {
     vector<string>  paramNames;
@@ -1040,6 +1249,82 @@ public:
 };
 
 
+// Vectorized exp/log and intensity kernels used by GetValues methods
+class TestSimdKernels : public CxxTest::TestSuite 
+{
+public:
+  void testVectorExp( void )
+  {
+    int  nVals = 9;
+    double  inputVals[9] = {-700.0, -300.0, -20.5, -1.0, -1.0e-5, 0.0, 0.3, 7.25, 300.0};
+    double  vals[9];
+    
+    for (int k = 0; k < nVals; k++)
+      vals[k] = inputVals[k];
+    VectorExp(nVals, vals);
+    for (int k = 0; k < nVals; k++)
+      TS_ASSERT_DELTA( vals[k]/exp(inputVals[k]), 1.0, 1.0e-14 );
+    
+    // arguments too small to produce normalized output are set to 0
+    vals[0] = -750.0;
+    VectorExp(1, vals);
+    TS_ASSERT_EQUALS( vals[0], 0.0 );
+  }
+
+  void testVectorLog( void )
+  {
+    int  nVals = 8;
+    double  inputVals[8] = {1.0e-300, 1.0e-5, 0.5, 0.999999, 1.0, 1.41, 3.0, 1.0e200};
+    double  vals[8];
+    
+    for (int k = 0; k < nVals; k++)
+      vals[k] = inputVals[k];
+    VectorLog(nVals, vals);
+    for (int k = 0; k < nVals; k++)
+      TS_ASSERT_DELTA( vals[k], log(inputVals[k]), 1.0e-13 );
+  }
+
+  void testIntensityKernels( void )
+  {
+    int  nVals = 6;
+    double  radii[6] = {0.0, 0.5, 1.0, 5.0, 20.0, 150.0};
+    double  vals[6];
+    double  trueVal;
+    
+    // Sersic with n = 4, I_e = 2, r_e = 10
+    double  n = 4.0;
+    double  bn = 7.669249442500;
+    for (int k = 0; k < nVals; k++)
+      vals[k] = radii[k];
+    SersicIntensities(nVals, vals, 2.0, bn, 1.0/n, 10.0);
+    for (int k = 0; k < nVals; k++) {
+      trueVal = 2.0 * exp(-bn * (pow(radii[k]/10.0, 1.0/n) - 1.0));
+      TS_ASSERT_DELTA( vals[k], trueVal, DELTA );
+    }
+    // Exponential with I_0 = 50, h = 3
+    for (int k = 0; k < nVals; k++)
+      vals[k] = radii[k];
+    ExponentialIntensities(nVals, vals, 50.0, 3.0);
+    for (int k = 0; k < nVals; k++)
+      TS_ASSERT_DELTA( vals[k], 50.0*exp(-radii[k]/3.0), DELTA );
+    // Gaussian with I_0 = 50, sigma = 5
+    for (int k = 0; k < nVals; k++)
+      vals[k] = radii[k];
+    GaussianIntensities(nVals, vals, 50.0, 50.0);
+    for (int k = 0; k < nVals; k++)
+      TS_ASSERT_DELTA( vals[k], 50.0*exp(-radii[k]*radii[k]/50.0), DELTA );
+    // Moffat with I_0 = 50, alpha = 2, beta = 2.5
+    for (int k = 0; k < nVals; k++)
+      vals[k] = radii[k];
+    MoffatIntensities(nVals, vals, 50.0, 2.0, 2.5);
+    for (int k = 0; k < nVals; k++) {
+      trueVal = 50.0 / pow(1.0 + (radii[k]/2.0)*(radii[k]/2.0), 2.5);
+      TS_ASSERT_DELTA( vals[k], trueVal, DELTA );
+    }
+  }
+};
+
+
 class TestModifiedKing : public CxxTest::TestSuite 
 {
   FunctionObject  *thisFunc, *thisFunc_subsampled;
@@ -1060,6 +1345,14 @@ public:
 
 
   // and now the actual tests
+  void testProfileTable( void )
+  {
+    // PA, ell, I_0, r_c, r_t, alpha
+    double  params[6] = {30.0, 0.3, 100.0, 5.0, 300.0, 2.0};
+
+    CheckProfileTable(thisFunc, params, 1.0e-5);
+  }
+
   void testBasic( void )
   {
     vector<string>  paramNames;
@@ -1180,6 +1473,23 @@ public:
     TS_ASSERT_DELTA( thisFunc->GetValue(10.0, 0.0), rEqualsSigmaValue, DELTA );
   }
 
+  void testGetFootprint( void )
+  {
+    double  x0 = 10.0;
+    double  y0 = 10.0;
+    // elliptical ModifiedKing with ell = 0.5, major axis parallel to x-axis, r_t = 9
+    double  params[6] = {90.0, 0.5, 100.0, 5.0, 9.0, 2.0};
+    double  xMin, xMax, yMin, yMax;
+    
+    // truncated function always has footprint = bounding box of r_t ellipse
+    thisFunc->Setup(params, 0, x0, y0);
+    TS_ASSERT_EQUALS( thisFunc->GetFootprint(xMin, xMax, yMin, yMax), true );
+    TS_ASSERT_DELTA( xMin, 1.0, DELTA );
+    TS_ASSERT_DELTA( xMax, 19.0, DELTA );
+    TS_ASSERT_DELTA( yMin, 5.5, DELTA );
+    TS_ASSERT_DELTA( yMax, 14.5, DELTA );
+  }
+
   void testCanCalculateTotalFlux( void )
   {
     bool result = thisFunc->CanCalculateTotalFlux();
@@ -1208,6 +1518,14 @@ public:
 
 
   // and now the actual tests
+  void testProfileTable( void )
+  {
+    // PA, ell, I_0, r_c, c, alpha
+    double  params[6] = {30.0, 0.3, 100.0, 5.0, 60.0, 2.0};
+
+    CheckProfileTable(thisFunc, params, 1.0e-5);
+  }
+
   void testBasic( void )
   {
     vector<string>  paramNames;
@@ -1386,6 +1704,43 @@ public:
     TS_ASSERT_EQUALS( thisFunc->IsPointSource(), true );
   }
 
+  // GetValue (which uses the shifted PSF stamp for pixel centers) should match
+  // direct interpolation, both at pixel centers and elsewhere, for the main
+  // image and for oversampled regions (subpixel centers)
+  void testGetValue_ShiftedStamp( void )
+  {
+    double  psfPixels[35];
+    double  params[1] = {10.0};
+    double  x0 = 20.3, y0 = 11.85;
+    double  x, y, xs, ys, correctVal;
+    
+    for (int j = 0; j < 5; j++)
+      for (int i = 0; i < 7; i++)
+        psfPixels[j*7 + i] = exp(-0.5*((i - 3.2)*(i - 3.2) + (j - 2.1)*(j - 2.1))) + 0.01*i;
+    PsfInterpolator_lanczos3  psfInterp(psfPixels, 7, 5);
+    
+    thisFunc->AddPsfInterpolator(&psfInterp);
+    thisFunc->Setup(params, 0, x0, y0);
+    for (int oversampleScale : {1, 2, 3}) {
+      thisFunc->SetOversamplingScale(oversampleScale);
+      double  subpixFrac = 1.0 / oversampleScale;
+      for (int j = 0; j < 30; j++) {
+        for (int i = 0; i < 30; i++) {
+          // subpixel centers (= pixel centers when oversampleScale = 1)
+          x = 14 + 0.5*subpixFrac - 0.5 + i*subpixFrac;
+          y = 6 + 0.5*subpixFrac - 0.5 + j*subpixFrac;
+          xs = oversampleScale*(x - x0);
+          ys = oversampleScale*(y - y0);
+          correctVal = 10.0 * psfInterp.GetValue(xs, ys);
+          TS_ASSERT_DELTA( thisFunc->GetValue(x, y), correctVal, 1.0e-10 );
+          // positions which aren't pixel centers
+          correctVal = 10.0 * psfInterp.GetValue(xs + 0.23, ys);
+          TS_ASSERT_DELTA( thisFunc->GetValue(x + 0.23*subpixFrac, y), correctVal, 1.0e-10 );
+        }
+      }
+    }
+  }
+
   void testCanCalculateTotalFlux( void )
   {
     bool result = thisFunc->CanCalculateTotalFlux();
@@ -1524,6 +1879,14 @@ public:
 
 
   // and now the actual tests
+  void testProfileTable( void )
+  {
+    // PA, ell, I_b, r_b, alpha, beta, gamma
+    double  params[7] = {30.0, 0.3, 100.0, 10.0, 2.0, 1.5, 0.5};
+
+    CheckProfileTable(thisFunc, params, 1.0e-5);
+  }
+
   void testBasic( void )
   {
     vector<string>  paramNames;
@@ -1642,6 +2005,14 @@ public:
 
 
   // and now the actual tests
+  void testProfileTable( void )
+  {
+    // PA, ell, I_0, h1, h2, r_b, alpha
+    double  params[7] = {30.0, 0.3, 100.0, 20.0, 10.0, 50.0, 0.5};
+
+    CheckProfileTable(thisFunc, params, 1.0e-5);
+  }
+
   void testBasic( void )
   {
     vector<string>  paramNames;
@@ -2086,8 +2457,9 @@ public:
     thisFunc->Setup(params, 0, x0, y0);
     
     // FUNCTION-SPECIFIC:
-    // central value (Python numerical integration gives 106.66666666666666)
-    double  centralValue = 106.666666573;
+    // central value (Python numerical integration gives 106.66666666666666;
+    // analytic value = 320/3)
+    double  centralValue = 106.666666666667;
     TS_ASSERT_DELTA( thisFunc->GetValue(100.0, 100.0), centralValue, DELTA );
 
 	// value outside bar should = 0
@@ -2098,8 +2470,8 @@ public:
 	TS_ASSERT_DELTA( thisFunc->GetValue(201.0, 100.0), 0.0, DELTA );
 	
 	// at r = R_bar/2 along major axis, integrated flux should be
-	// (Python numerical integration gives 51.96152422430678)
-	double  halfRadiusValue = 51.9615240239;
+	// (Python numerical integration gives 51.96152422430678; analytic value = 30 sqrt(3))
+	double  halfRadiusValue = 51.9615242270663;
     TS_ASSERT_DELTA( thisFunc->GetValue(100.0, 100.0 + R_bar/2.0), halfRadiusValue, DELTA );
     TS_ASSERT_DELTA( thisFunc->GetValue(100.0 - R_bar/2.0, 100.0), halfRadiusValue, DELTA );
     
@@ -2112,6 +2484,15 @@ public:
     TS_ASSERT_DELTA( thisFunc->GetValue(100.0, 100.0 - R_bar/2.0), halfRadiusValue, DELTA );
     TS_ASSERT_DELTA( thisFunc->GetValue(100.0 + R_bar/2.0, 100.0), 0.0, DELTA );
     TS_ASSERT_DELTA( thisFunc->GetValue(100.0 + R_bar/4.0, 100.0), halfRadiusValue, DELTA );
+
+    // Spherical bar (q = q_z = 1): projection should be independent of inclination
+    // and bar PA (checks line-of-sight integration limits for inclined bars)
+    double  params3[8] = {PA, 60.0, 30.0, J_0, R_bar, q, q_z, n};
+    thisFunc->Setup(params3, 0, x0, y0);
+    TS_ASSERT_DELTA( thisFunc->GetValue(100.0, 100.0), centralValue, DELTA );
+    TS_ASSERT_DELTA( thisFunc->GetValue(100.0, 100.0 + R_bar/2.0), halfRadiusValue, DELTA );
+    TS_ASSERT_DELTA( thisFunc->GetValue(100.0 - R_bar/2.0, 100.0), halfRadiusValue, DELTA );
+    TS_ASSERT_DELTA( thisFunc->GetValue(100.0, 201.0), 0.0, DELTA );
   }
 
   void testCanCalculateTotalFlux( void )
@@ -2236,3 +2617,71 @@ public:
 //     TS_ASSERT_DELTA( theFunc->GetValue(25.0), -5.0, DELTA );
 //   }
 // };
+
+
+
+// Integrand for testing Integrate(): exp(-x^2)
+double GaussianIntegrand( double x, void *params )
+{
+  return exp(-x*x);
+}
+
+class TestIntegrator : public CxxTest::TestSuite 
+{
+public:
+
+  // Each thread should allocate its workspaces once and reuse them
+  void testWorkspaceReusedWithinThread( void )
+  {
+    gsl_integration_workspace  *workspace1 = GetIntegrationWorkspace();
+    gsl_integration_cquad_workspace  *workspace1_cquad = GetIntegrationWorkspace_cquad();
+    gsl_function  F;
+
+    TS_ASSERT( workspace1 != nullptr );
+    TS_ASSERT( workspace1_cquad != nullptr );
+    F.function = &GaussianIntegrand;
+    F.params = nullptr;
+    Integrate(F, -5.0, 5.0);
+    Integrate_cquad(F, -5.0, 5.0);
+    TS_ASSERT_EQUALS( GetIntegrationWorkspace(), workspace1 );
+    TS_ASSERT_EQUALS( GetIntegrationWorkspace_cquad(), workspace1_cquad );
+  }
+
+  // Different threads should have different workspaces
+  void testWorkspacesDistinctAcrossThreads( void )
+  {
+    gsl_integration_workspace  *workspace_main = GetIntegrationWorkspace();
+    gsl_integration_workspace  *workspace_other = nullptr;
+    gsl_integration_workspace  *workspace_other2 = nullptr;
+    gsl_integration_cquad_workspace  *workspace_main_cquad = GetIntegrationWorkspace_cquad();
+    gsl_integration_cquad_workspace  *workspace_other_cquad = nullptr;
+
+    thread  otherThread([&]() {
+      workspace_other = GetIntegrationWorkspace();
+      workspace_other2 = GetIntegrationWorkspace();
+      workspace_other_cquad = GetIntegrationWorkspace_cquad();
+    });
+    otherThread.join();
+    TS_ASSERT( workspace_other != nullptr );
+    TS_ASSERT( workspace_other != workspace_main );
+    TS_ASSERT_EQUALS( workspace_other2, workspace_other );
+    TS_ASSERT( workspace_other_cquad != nullptr );
+    TS_ASSERT( workspace_other_cquad != workspace_main_cquad );
+  }
+
+  // Results with the thread's workspace, a caller-supplied workspace, and CQUAD
+  // should agree with the analytic value
+  void testIntegrate( void )
+  {
+    double  correct = sqrt(PI)*erf(5.0);
+    gsl_function  F;
+    gsl_integration_workspace  *workspace = gsl_integration_workspace_alloc(1000);
+
+    F.function = &GaussianIntegrand;
+    F.params = nullptr;
+    TS_ASSERT_DELTA( Integrate(F, -5.0, 5.0), correct, 1.0e-6*correct );
+    TS_ASSERT_DELTA( Integrate(F, -5.0, 5.0, workspace), correct, 1.0e-6*correct );
+    TS_ASSERT_DELTA( Integrate_cquad(F, -5.0, 5.0), correct, 1.0e-6*correct );
+    gsl_integration_workspace_free(workspace);
+  }
+};
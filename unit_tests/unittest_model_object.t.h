@@ -352,6 +352,118 @@ public:
     for (int i = 0; i < nDataVals; i++)
       TS_ASSERT_EQUALS(outputModelVect[i], trueResidualVals[i]);
   }
+
+
+   void testModelImageGeneration_componentCache( void )
+  {
+    // Exponential + FlatSky model images with and without per-component image 
+    // cache should be identical, including when only some parameters are changed
+    double *outputModelVect, *outputModelVect_cached;
+    double params1[7] = {5.0, 5.0, 10.0, 0.4, 90.0, 3.0, 20.0};   // X0, Y0, Exp params, I_sky
+    double params2[7] = {5.0, 5.0, 10.0, 0.4, 90.0, 3.0, 25.0};   // I_sky changed
+    double params3[7] = {5.0, 5.0, 10.0, 0.4, 90.0, 4.0, 25.0};   // h changed
+    double params4[7] = {5.5, 5.0, 10.0, 0.4, 90.0, 4.0, 25.0};   // X0 changed
+    double *paramsList[4] = {params1, params2, params3, params4};
+    int  nCols = 10;
+    int  nRows = 10;
+  
+    modelObj1->SetupModelImage(nCols, nRows);
+    modelObj4->SetupModelImage(nCols, nRows);
+    modelObj4->UseComponentCache(true);
+    for (int n = 0; n < 4; n++) {
+      modelObj1->CreateModelImage(paramsList[n]);
+      modelObj4->CreateModelImage(paramsList[n]);
+      outputModelVect = modelObj1->GetModelImageVector();
+      outputModelVect_cached = modelObj4->GetModelImageVector();
+      for (int i = 0; i < nCols*nRows; i++)
+        TS_ASSERT_EQUALS(outputModelVect_cached[i], outputModelVect[i]);
+    }
+  }
+
+   void testComponentCacheMemoryUse( void )
+  {
+    // Exponential + FlatSky model, no PSF convolution: cache holds one image
+    // per component; nothing is allocated if cache is off or exceeds its limit
+    int  nCols = 10;
+    int  nRows = 10;
+    long  cacheBytes = 2 * nCols*nRows * sizeof(double);
+  
+    modelObj4->SetupModelImage(nCols, nRows);
+    TS_ASSERT_EQUALS(modelObj4->EstimateComponentCacheMemoryUse(), 0);
+    modelObj4->UseComponentCache(true);
+    TS_ASSERT_EQUALS(modelObj4->EstimateComponentCacheMemoryUse(), cacheBytes);
+    modelObj4->UseComponentCache(true, (double)cacheBytes);
+    TS_ASSERT_EQUALS(modelObj4->EstimateComponentCacheMemoryUse(), cacheBytes);
+    modelObj4->UseComponentCache(true, (double)(cacheBytes - 1));
+    TS_ASSERT_EQUALS(modelObj4->EstimateComponentCacheMemoryUse(), 0);
+  }
+
+   void testModelImageGeneration_ompTiles( void )
+  {
+    // Exponential + FlatSky model images computed with different OpenMP schedules
+    // and tile sizes (including tiles which don't evenly divide the image) should
+    // be identical to the default
+    double *outputModelVect, *outputModelVect_tiles;
+    double params[7] = {5.0, 5.0, 10.0, 0.4, 90.0, 3.0, 20.0};   // X0, Y0, Exp params, I_sky
+    int  scheduleTypes[4] = {OMP_SCHEDULE_STATIC, OMP_SCHEDULE_STATIC, OMP_SCHEDULE_DYNAMIC,
+    							OMP_SCHEDULE_GUIDED};
+    int  tileRows[4] = {10, 1, 3, 4};
+    int  tileColumns[4] = {0, 1, 4, 7};
+    int  nCols = 10;
+    int  nRows = 10;
+  
+    modelObj1->SetupModelImage(nCols, nRows);
+    modelObj4->SetupModelImage(nCols, nRows);
+    modelObj1->CreateModelImage(params);
+    outputModelVect = modelObj1->GetModelImageVector();
+    for (int n = 0; n < 4; n++) {
+      modelObj4->SetOMPSchedule(scheduleTypes[n]);
+      modelObj4->SetOMPTileSize(tileRows[n], tileColumns[n]);
+      modelObj4->CreateModelImage(params);
+      outputModelVect_tiles = modelObj4->GetModelImageVector();
+      for (int i = 0; i < nCols*nRows; i++)
+        TS_ASSERT_EQUALS(outputModelVect_tiles[i], outputModelVect[i]);
+    }
+  }
+
+   void testModelImageGeneration_frozenComponents( void )
+  {
+    // Exponential + FlatSky model with X0,Y0 and I_sky fixed, so that FlatSky
+    // is a "frozen" component; model images should match those made without
+    // frozen-component caching, including if the fixed value of I_sky is changed
+    double *outputModelVect, *outputModelVect_frozen;
+    double params1[7] = {5.0, 5.0, 10.0, 0.4, 90.0, 3.0, 20.0};   // X0, Y0, Exp params, I_sky
+    double params2[7] = {5.0, 5.0, 10.0, 0.4, 80.0, 3.0, 20.0};   // I_0 changed
+    double params3[7] = {5.0, 5.0, 10.0, 0.4, 80.0, 3.0, 25.0};   // (fixed) I_sky changed
+    double *paramsList[3] = {params1, params2, params3};
+    vector<mp_par>  parameterInfo;
+    mp_par  currentParameterInfo;
+    int  nCols = 10;
+    int  nRows = 10;
+  
+    for (int i = 0; i < 7; i++) {
+      currentParameterInfo.fixed = 0;
+      currentParameterInfo.limited[0] = currentParameterInfo.limited[1] = 0;
+      currentParameterInfo.limits[0] = currentParameterInfo.limits[1] = 0.0;
+      parameterInfo.push_back(currentParameterInfo);
+    }
+    parameterInfo[0].fixed = parameterInfo[1].fixed = parameterInfo[6].fixed = 1;
+
+    modelObj1->SetupModelImage(nCols, nRows);
+    modelObj4->SetupModelImage(nCols, nRows);
+    modelObj4->UseFrozenComponentCache(true);
+    TS_ASSERT_EQUALS(modelObj4->GetNFrozenComponents(), 0);
+    modelObj4->AddParameterInfo(parameterInfo);
+    TS_ASSERT_EQUALS(modelObj4->GetNFrozenComponents(), 1);
+    for (int n = 0; n < 3; n++) {
+      modelObj1->CreateModelImage(paramsList[n]);
+      modelObj4->CreateModelImage(paramsList[n]);
+      outputModelVect = modelObj1->GetModelImageVector();
+      outputModelVect_frozen = modelObj4->GetModelImageVector();
+      for (int i = 0; i < nCols*nRows; i++)
+        TS_ASSERT_DELTA(outputModelVect_frozen[i], outputModelVect[i], 1.0e-12);
+    }
+  }
  
  
   void testSetExtraParams( void )
@@ -1060,6 +1172,376 @@ public:
     delete modelObj5a2;
   }
 
+  // Planar background functions are added after PSF convolution (as shifted, scaled
+  // copies) instead of being convolved; results must match brute-force convolution
+  // of the background, and must be the same with and without the component cache
+  // (which reuses the convolved image when only background parameters change)
+  void testBackgroundAddedAfterConvolution( void )
+  {
+    int  nColumns = 12;
+    int  nRows = 10;
+    int  nColumns_psf = 4;
+    int  nRows_psf = 3;
+    int  nPixels_psf = 12;
+    double  asymmetricPSF[12] = {0.1, 0.3, 0.2, 0.0, 0.4, 1.0, 0.7, 0.2, 0.0, 0.5, 0.3, 0.6};
+    // X0, Y0, Gaussian params (PA, ell, I_0, sigma), TiltedSkyPlane params (I_0, m_x, m_y)
+    double  params1[9] = {6.0, 5.0, 30.0, 0.2, 100.0, 1.5, 10.0, 0.3, -0.2};
+    double  params2[9] = {6.0, 5.0, 30.0, 0.2, 100.0, 1.5, 12.0, 0.5, -0.2};   // sky changed
+    double  params3[9] = {6.0, 5.0, 30.0, 0.2, 100.0, 2.0, 12.0, 0.5, -0.2};   // sigma changed
+    double  *paramsList[3] = {params1, params2, params3};
+    double  psfSum = 0.0;
+    double  *outputModelVect, *outputModelVect_cached;
+    vector<string>  functionNames, functionLabels;
+    vector<int>  functionSetIndices(1, 0);
+
+    functionNames.push_back("Gaussian");
+    functionNames.push_back("TiltedSkyPlane");
+    functionLabels.assign(2, "");
+    ModelObject *modelObjSky = new ModelObject();
+    ModelObject *modelObjA = new ModelObject();
+    ModelObject *modelObjB = new ModelObject();
+    status = AddFunctions(modelObjSky, vector<string>(1, "TiltedSkyPlane"), functionLabels, 
+    						functionSetIndices, true, -1);
+    status = AddFunctions(modelObjA, functionNames, functionLabels, functionSetIndices, 
+    						true, -1);
+    status = AddFunctions(modelObjB, functionNames, functionLabels, functionSetIndices, 
+    						true, -1);
+    modelObjSky->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, asymmetricPSF);
+    modelObjA->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, asymmetricPSF);
+    modelObjB->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, asymmetricPSF);
+    modelObjSky->SetupModelImage(nColumns, nRows);
+    modelObjA->SetupModelImage(nColumns, nRows);
+    modelObjB->SetupModelImage(nColumns, nRows);
+    modelObjB->UseComponentCache(true);
+
+    // brute-force convolution of the tilted plane (PSF center = pixel [1,2])
+    double  skyParams[5] = {6.0, 5.0, 10.0, 0.3, -0.2};
+    modelObjSky->CreateModelImage(skyParams);
+    outputModelVect = modelObjSky->GetModelImageVector();
+    for (int k = 0; k < nPixels_psf; k++)
+      psfSum += asymmetricPSF[k];
+    for (int i = 0; i < nRows; i++) {
+      for (int j = 0; j < nColumns; j++) {
+        double  sum = 0.0;
+        for (int k = 0; k < nRows_psf; k++) {
+          for (int l = 0; l < nColumns_psf; l++) {
+            double  x = (j + 1) + 2 - l;
+            double  y = (i + 1) + 1 - k;
+            sum += asymmetricPSF[k*nColumns_psf + l] * (10.0 + 0.3*(x - 6.0) - 0.2*(y - 5.0));
+          }
+        }
+        TS_ASSERT_DELTA(outputModelVect[i*nColumns + j], sum/psfSum, 1.0e-10);
+      }
+    }
+
+    for (int n = 0; n < 3; n++) {
+      modelObjA->CreateModelImage(paramsList[n]);
+      modelObjB->CreateModelImage(paramsList[n]);
+      outputModelVect = modelObjA->GetModelImageVector();
+      outputModelVect_cached = modelObjB->GetModelImageVector();
+      // (the two models may use different convolution methods)
+      for (int i = 0; i < nColumns*nRows; i++)
+        TS_ASSERT_DELTA(outputModelVect_cached[i], outputModelVect[i], 1.0e-10);
+    }
+
+    delete modelObjSky;
+    delete modelObjA;
+    delete modelObjB;
+  }
+
+  // PSF basis with spatially constant coefficients should give the same result as
+  // convolution with the (unnormalized) linear combination of the basis PSFs
+  void testPSFBasisWithConstantCoefficients( void )
+  {
+    int  nColumns = 12;
+    int  nRows = 10;
+    int  nColumns_psf = 4;
+    int  nRows_psf = 3;
+    int  nPixels_psf = 12;
+    double  psf1[12] = {0.1, 0.3, 0.2, 0.0, 0.4, 1.0, 0.7, 0.2, 0.0, 0.5, 0.3, 0.6};
+    double  psf2[12] = {0.0, 0.2, 0.1, 0.0, 0.1, 0.8, 0.9, 0.1, 0.0, 0.1, 0.2, 0.0};
+    double  combinedPSF[12];
+    // X0, Y0, Gaussian params (PA, ell, I_0, sigma), TiltedSkyPlane params (I_0, m_x, m_y)
+    double  params[9] = {6.0, 5.0, 30.0, 0.2, 100.0, 1.5, 10.0, 0.3, -0.2};
+    double  *outputModelVect, *outputModelVect_basis;
+    vector<string>  functionNames, functionLabels;
+    vector<int>  functionSetIndices(1, 0);
+    vector<double *>  basisPixels, coeffMaps;
+
+    for (int k = 0; k < nPixels_psf; k++)
+      combinedPSF[k] = 0.6*psf1[k] + 0.4*psf2[k];
+    double  *coeffs1 = (double *)calloc(nColumns*nRows, sizeof(double));
+    double  *coeffs2 = (double *)calloc(nColumns*nRows, sizeof(double));
+    for (int i = 0; i < nColumns*nRows; i++) {
+      coeffs1[i] = 0.6;
+      coeffs2[i] = 0.4;
+    }
+    basisPixels.push_back(psf1);
+    basisPixels.push_back(psf2);
+    coeffMaps.push_back(coeffs1);
+    coeffMaps.push_back(coeffs2);
+
+    functionNames.push_back("Gaussian");
+    functionNames.push_back("TiltedSkyPlane");
+    functionLabels.assign(2, "");
+    ModelObject *modelObjA = new ModelObject();
+    ModelObject *modelObjB = new ModelObject();
+    status = AddFunctions(modelObjA, functionNames, functionLabels, functionSetIndices,
+    						true, -1);
+    status = AddFunctions(modelObjB, functionNames, functionLabels, functionSetIndices,
+    						true, -1);
+    modelObjA->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, combinedPSF, false);
+    status = modelObjB->AddPSFBasis(basisPixels, nColumns_psf, nRows_psf, coeffMaps,
+    						nColumns, nRows);
+    TS_ASSERT_EQUALS(status, 0);
+    modelObjA->SetupModelImage(nColumns, nRows);
+    status = modelObjB->SetupModelImage(nColumns, nRows);
+    TS_ASSERT_EQUALS(status, 0);
+
+    modelObjA->CreateModelImage(params);
+    modelObjB->CreateModelImage(params);
+    outputModelVect = modelObjA->GetModelImageVector();
+    outputModelVect_basis = modelObjB->GetModelImageVector();
+    for (int i = 0; i < nColumns*nRows; i++)
+      TS_ASSERT_DELTA(outputModelVect_basis[i], outputModelVect[i], 1.0e-10);
+
+    delete modelObjA;
+    delete modelObjB;
+    free(coeffs1);
+    free(coeffs2);
+  }
+
+  // PointSource functions are only evaluated within their footprints; the result
+  // should match the sum of the (full-image) single-function images
+  void testPointSourceFootprints( void )
+  {
+    int  nColumns = 40;
+    int  nRows = 30;
+    int  nColumns_psf = 9;
+    int  nRows_psf = 7;
+    int  nPixels_psf = 63;
+    double  psfImage[63];
+    // PointSource (X0, Y0, I_tot); PointSourceRot (X0, Y0, PA, I_tot); FlatSky
+    // (X0, Y0, I_sky); the second point source is partly off the image
+    double  params[10] = {12.3, 9.6, 1000.0, 37.8, 26.2, 30.0, 500.0, 20.0, 15.0, 2.0};
+    vector<string>  functionNames, functionLabels;
+    vector<int>  functionSetIndices;
+    vector<double>  summedImage(nColumns*nRows, 0.0);
+    double  *singleImage, *outputModelVect;
+
+    for (int i = 0; i < nRows_psf; i++)
+      for (int j = 0; j < nColumns_psf; j++)
+        psfImage[i*nColumns_psf + j] = exp(-0.3*(j - 4.2)*(j - 4.2) - 0.5*(i - 3)*(i - 3));
+    functionNames.push_back("PointSource");
+    functionNames.push_back("PointSourceRot");
+    functionNames.push_back("FlatSky");
+    functionLabels.assign(3, "");
+    functionSetIndices.push_back(0);
+    functionSetIndices.push_back(1);
+    functionSetIndices.push_back(2);
+    // (PSF must be added before PointSource functions)
+    ModelObject *modelObj = new ModelObject();
+    modelObj->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, psfImage);
+    status = AddFunctions(modelObj, functionNames, functionLabels, functionSetIndices,
+    						true, -1);
+    TS_ASSERT_EQUALS(status, 0);
+    modelObj->SetupModelImage(nColumns, nRows);
+
+    for (int n = 0; n < 3; n++) {
+      singleImage = modelObj->GetSingleFunctionImage(params, n);
+      for (int k = 0; k < nColumns*nRows; k++)
+        summedImage[k] += singleImage[k];
+    }
+    modelObj->CreateModelImage(params);
+    outputModelVect = modelObj->GetModelImageVector();
+    for (int k = 0; k < nColumns*nRows; k++)
+      TS_ASSERT_DELTA(outputModelVect[k], summedImage[k], 1.0e-10);
+    // pixels far from both point sources should just have the sky value
+    TS_ASSERT_DELTA(outputModelVect[2*nColumns + 35], 2.0, 1.0e-10);
+
+    // Same model, with an oversampled region around the first point source;
+    // outside the region, the result should be unchanged, and repeated calls
+    // should give the same result (point sources must be reset to the standard
+    // pixel scale after the oversampled region is computed)
+    int  nColumns_osamp = 15;
+    int  nRows_osamp = 15;
+    double  *osampPSF = (double *)malloc(nColumns_osamp*nRows_osamp*sizeof(double));
+    for (int i = 0; i < nRows_osamp; i++)
+      for (int j = 0; j < nColumns_osamp; j++)
+        osampPSF[i*nColumns_osamp + j] = exp(-0.05*((j - 7)*(j - 7) + (i - 7)*(i - 7)));
+    PsfOversamplingInfo *osampleInfo = new PsfOversamplingInfo(osampPSF, nColumns_osamp,
+    												nRows_osamp, 3, "8:16,5:14");
+    ModelObject *modelObjOsamp = new ModelObject();
+    modelObjOsamp->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, psfImage);
+    status = AddFunctions(modelObjOsamp, functionNames, functionLabels, functionSetIndices,
+    						true, -1);
+    modelObjOsamp->SetupModelImage(nColumns, nRows);
+    status = modelObjOsamp->AddOversampledPsfInfo(osampleInfo);
+    TS_ASSERT_EQUALS(status, 0);
+    modelObjOsamp->CreateModelImage(params);
+    vector<double>  firstImage(modelObjOsamp->GetModelImageVector(),
+    							modelObjOsamp->GetModelImageVector() + nColumns*nRows);
+    modelObjOsamp->CreateModelImage(params);
+    outputModelVect = modelObjOsamp->GetModelImageVector();
+    for (int i = 0; i < nRows; i++) {
+      for (int j = 0; j < nColumns; j++) {
+        int  k = i*nColumns + j;
+        TS_ASSERT_DELTA(outputModelVect[k], firstImage[k], 1.0e-10);
+        if ((j < 7) || (j > 15) || (i < 4) || (i > 13))
+          TS_ASSERT_DELTA(outputModelVect[k], summedImage[k], 1.0e-10);
+      }
+    }
+
+    delete modelObj;
+    delete modelObjOsamp;
+    delete osampleInfo;
+  }
+
+  // Several oversampled regions (two of them overlapping), which are computed
+  // concurrently by CreateModelImage; the result should match the sum of the 
+  // individual function images (where the regions are computed one at a time)
+  void testMultipleOversampledRegions( void )
+  {
+    int  nColumns = 40;
+    int  nRows = 30;
+    int  nColumns_psf = 9;
+    int  nRows_psf = 7;
+    int  nPixels_psf = 63;
+    int  nColumns_osamp = 15;
+    int  nRows_osamp = 15;
+    double  psfImage[63];
+    // PointSource (X0, Y0, I_tot); Gaussian (X0, Y0, PA, ell, I_0, sigma); 
+    // PointSource (X0, Y0, I_tot); FlatSky (X0, Y0, I_sky)
+    double  params[15] = {8.3, 7.6, 1000.0, 15.4, 12.1, 20.0, 0.3, 50.0, 3.0, 
+    						30.2, 22.7, 500.0, 20.0, 15.0, 2.0};
+    const char  *regionStrings[3] = {"4:12,4:12", "10:20,8:16", "25:35,18:28"};
+    vector<string>  functionNames, functionLabels;
+    vector<int>  functionSetIndices;
+    vector<double>  summedImage(nColumns*nRows, 0.0);
+    vector<PsfOversamplingInfo *>  osampleInfos;
+    double  *singleImage, *outputModelVect;
+
+    for (int i = 0; i < nRows_psf; i++)
+      for (int j = 0; j < nColumns_psf; j++)
+        psfImage[i*nColumns_psf + j] = exp(-0.3*(j - 4.2)*(j - 4.2) - 0.5*(i - 3)*(i - 3));
+    functionNames.push_back("PointSource");
+    functionNames.push_back("Gaussian");
+    functionNames.push_back("PointSource");
+    functionNames.push_back("FlatSky");
+    functionLabels.assign(4, "");
+    for (int n = 0; n < 4; n++)
+      functionSetIndices.push_back(n);
+    ModelObject *modelObj = new ModelObject();
+    modelObj->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, psfImage);
+    status = AddFunctions(modelObj, functionNames, functionLabels, functionSetIndices,
+    						true, -1);
+    TS_ASSERT_EQUALS(status, 0);
+    modelObj->SetupModelImage(nColumns, nRows);
+    for (int r = 0; r < 3; r++) {
+      // (PsfOversamplingInfo frees the PSF pixels when it is deleted)
+      double  *osampPSF = (double *)malloc(nColumns_osamp*nRows_osamp*sizeof(double));
+      for (int i = 0; i < nRows_osamp; i++)
+        for (int j = 0; j < nColumns_osamp; j++)
+          osampPSF[i*nColumns_osamp + j] = exp(-0.05*((j - 7 + 0.5*r)*(j - 7 + 0.5*r) 
+          										+ (i - 7)*(i - 7)));
+      osampleInfos.push_back(new PsfOversamplingInfo(osampPSF, nColumns_osamp,
+    												nRows_osamp, 3, regionStrings[r]));
+      status = modelObj->AddOversampledPsfInfo(osampleInfos[r]);
+      TS_ASSERT_EQUALS(status, 0);
+    }
+
+    for (int n = 0; n < 4; n++) {
+      singleImage = modelObj->GetSingleFunctionImage(params, n);
+      for (int k = 0; k < nColumns*nRows; k++)
+        summedImage[k] += singleImage[k];
+    }
+    // do it twice, to check that point sources are properly reset between regions
+    for (int m = 0; m < 2; m++) {
+      modelObj->CreateModelImage(params);
+      outputModelVect = modelObj->GetModelImageVector();
+      for (int k = 0; k < nColumns*nRows; k++)
+        TS_ASSERT_DELTA(outputModelVect[k], summedImage[k], 1.0e-8);
+    }
+
+    delete modelObj;
+    for (int r = 0; r < 3; r++)
+      delete osampleInfos[r];
+  }
+
+  // Crowded field: many point sources (plus convolved and post-convolution
+  // components), with small image tiles. Results with the component cache (where
+  // only tiles around changed point sources are recomputed) should match those
+  // without it, including when a point source moves to different tiles.
+  void testCrowdedFieldPointSources( void )
+  {
+    int  nColumns = 60;
+    int  nRows = 50;
+    int  nColumns_psf = 7;
+    int  nRows_psf = 7;
+    int  nPixels_psf = 49;
+    int  nStars = 40;
+    int  nParams = 9 + 3*nStars;
+    double  psfImage[49];
+    double  *outputModelVect, *outputModelVect_cached;
+    vector<string>  functionNames, functionLabels;
+    vector<int>  functionSetIndices;
+    vector<double>  params(nParams);
+
+    for (int i = 0; i < nRows_psf; i++)
+      for (int j = 0; j < nColumns_psf; j++)
+        psfImage[i*nColumns_psf + j] = exp(-0.2*(j - 3.1)*(j - 3.1) - 0.3*(i - 2.9)*(i - 2.9));
+    // first function set: Gaussian + TiltedSkyPlane (X0, Y0, PA, ell, I_0, sigma,
+    // I_0, m_x, m_y); then one function set per star (X0, Y0, I_tot)
+    functionNames.push_back("Gaussian");
+    functionNames.push_back("TiltedSkyPlane");
+    functionSetIndices.push_back(0);
+    double  initialParams[9] = {30.0, 25.0, 30.0, 0.2, 100.0, 5.0, 10.0, 0.03, -0.02};
+    for (int k = 0; k < 9; k++)
+      params[k] = initialParams[k];
+    for (int n = 0; n < nStars; n++) {
+      functionNames.push_back("PointSource");
+      functionSetIndices.push_back(n + 2);
+      // (some stars are partly off the image)
+      params[9 + 3*n] = fmod(7.3*n + 0.41, 63.0) - 1.0;
+      params[9 + 3*n + 1] = fmod(11.7*n + 3.17, 52.0);
+      params[9 + 3*n + 2] = 100.0 + 10.0*n;
+    }
+    functionLabels.assign(nStars + 2, "");
+    
+    ModelObject *modelObjA = new ModelObject();
+    ModelObject *modelObjB = new ModelObject();
+    modelObjA->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, psfImage);
+    modelObjB->AddPSFVector(nPixels_psf, nColumns_psf, nRows_psf, psfImage);
+    status = AddFunctions(modelObjA, functionNames, functionLabels, functionSetIndices, 
+    						true, -1);
+    TS_ASSERT_EQUALS(status, 0);
+    status = AddFunctions(modelObjB, functionNames, functionLabels, functionSetIndices, 
+    						true, -1);
+    modelObjA->SetupModelImage(nColumns, nRows);
+    modelObjB->SetupModelImage(nColumns, nRows);
+    modelObjA->SetOMPTileSize(4, 8);
+    modelObjB->SetOMPTileSize(4, 8);
+    modelObjB->UseComponentCache(true);
+
+    // sequence of changes, as in computing a Jacobian (one parameter at a time),
+    // including moving a star by several tiles and back
+    vector<int>  changedParam = {-1, 9 + 3*5 + 2, 9 + 3*5, 9 + 3*5, 9 + 3*17 + 1, 6, 5, -1};
+    vector<double>  delta = {0.0, 1.5, 11.3, -11.3, 0.001, 0.5, 0.3, 0.0};
+    for (int m = 0; m < (int)changedParam.size(); m++) {
+      if (changedParam[m] >= 0)
+        params[changedParam[m]] += delta[m];
+      modelObjA->CreateModelImage(params.data());
+      modelObjB->CreateModelImage(params.data());
+      outputModelVect = modelObjA->GetModelImageVector();
+      outputModelVect_cached = modelObjB->GetModelImageVector();
+      for (int k = 0; k < nColumns*nRows; k++)
+        TS_ASSERT_DELTA(outputModelVect_cached[k], outputModelVect[k], 1.0e-10);
+    }
+
+    delete modelObjA;
+    delete modelObjB;
+  }
+
   // make sure ModelObject complains if we add oversampled PSF with NaN pixel values
 //   void testCatchBadOversampledPSF( void )
 //   {
@@ -88,6 +88,93 @@ public:
 };
 
 
+// Reference values are the same as for PsfInterpolator_bicubic (GSL)
+class TestPsfInterpolator_bicubic_native : public CxxTest::TestSuite 
+{
+  // data members
+  int  nColsPsf, nRowsPsf;
+  double  *psfPixels;
+  PsfInterpolator *psfInterp;
+  
+public:
+  void setUp()
+  {
+    psfPixels = ReadImageAsVector(psfImage_filename, &nColsPsf, &nRowsPsf);
+    psfInterp = new PsfInterpolator_bicubic_native(psfPixels, nColsPsf, nRowsPsf);
+  }
+
+  void tearDown()
+  {
+    delete psfInterp;
+    free(psfPixels);
+  }
+
+
+  // and now the actual tests
+
+  void testGetInterpolatorType( void )
+  {
+    int returnVal = psfInterp->GetInterpolatorType();
+    TS_ASSERT_EQUALS( returnVal, kInterpolator_bicubic );
+  }
+
+  void testGetValues_noshift( void )
+  {
+    double returnVal0, returnVal1, returnVal2;
+    
+    // central pixel
+    returnVal0 = psfInterp->GetValue(0.0,0.0);
+    TS_ASSERT_DELTA( returnVal0, 0.73212016, DELTA );
+    // 1 pixel to right of center
+    returnVal1 = psfInterp->GetValue(1.0,0.0);
+    TS_ASSERT_DELTA( returnVal1, 0.16868566, DELTA );
+    // 1 pixel above center
+    returnVal1 = psfInterp->GetValue(0.0,1.0);
+    TS_ASSERT_DELTA( returnVal1, 0.16868566, DELTA );
+    // 2 pixels below center
+    returnVal2 = psfInterp->GetValue(0.0,-2.0);
+    TS_ASSERT_DELTA( returnVal2, 0.0014417765, DELTA );
+  }
+
+  void testGetValues_shifted( void )
+  {
+    double returnVal0, returnVal1;
+    
+    // 0.5 pixels to right of central pixel
+    returnVal0 = psfInterp->GetValue(0.5,0.0);
+    TS_ASSERT_DELTA( returnVal0, 0.51973038, DELTA );
+    // 1.5 pixels to right of center, 0.5 above
+    returnVal1 = psfInterp->GetValue(1.5,0.5);
+    TS_ASSERT_DELTA( returnVal1, 0.00880937, DELTA );
+    // 1.5 pixels above center
+    returnVal1 = psfInterp->GetValue(0.0,1.5);
+    TS_ASSERT_DELTA( returnVal1, 0.01243073, DELTA );
+  }
+
+  void testOutsidePSF( void )
+  {
+    TS_ASSERT_EQUALS( psfInterp->GetValue(2.01, 0.0), 0.0 );
+    TS_ASSERT_EQUALS( psfInterp->GetValue(0.0, -2.01), 0.0 );
+    // upper edges are inside
+    TS_ASSERT_DELTA( psfInterp->GetValue(2.0, 2.0), psfPixels[24], DELTA );
+  }
+
+  // span evaluation should match GetValue (including points outside the PSF)
+  void testGetValues_span( void )
+  {
+    double  values[40];
+    double  xStart = -3.1;
+    double  deltaX = 0.17;
+    
+    for (double y : {-2.0, -0.73, 0.0, 1.5, 2.0, 2.2}) {
+      psfInterp->GetValues(xStart, deltaX, y, 40, values);
+      for (int k = 0; k < 40; k++)
+        TS_ASSERT_DELTA( values[k], psfInterp->GetValue(xStart + k*deltaX, y), 1.0e-14 );
+    }
+  }
+};
+
+
 class TestPsfInterpolator_lanczos2 : public CxxTest::TestSuite 
 {
   // data members
@@ -190,6 +277,143 @@ public:
 
 
 
+// Tests for ShiftedPsfStamp and PsfInterpolator::MakeShiftedStamp, using an
+// asymmetric, non-square PSF (7 columns x 5 rows)
+
+const int  N_COLS_ASYM = 7;
+const int  N_ROWS_ASYM = 5;
+
+void MakeAsymmetricPSF( vector<double>& psf )
+{
+  psf.resize(N_COLS_ASYM*N_ROWS_ASYM);
+  for (int j = 0; j < N_ROWS_ASYM; j++)
+    for (int i = 0; i < N_COLS_ASYM; i++)
+      psf[j*N_COLS_ASYM + i] = exp(-0.5*(pow((i - 3.3)/1.2, 2) + pow((j - 1.8)/0.9, 2)))
+      						+ 0.01*i + 0.002*j;
+}
+
+// Checks that stamp values match GetValue at all lattice points, and that
+// off-lattice points aren't looked up
+void CheckStampAgainstGetValue( PsfInterpolator *psfInterp, double xFrac, double yFrac )
+{
+  ShiftedPsfStamp  stamp;
+  double  x, y, value;
+
+  psfInterp->MakeShiftedStamp(xFrac, yFrac, stamp);
+  TS_ASSERT( stamp.ready );
+  TS_ASSERT( stamp.nColumns > 0 );
+  TS_ASSERT( stamp.nRows > 0 );
+  for (int ky = -1; ky <= stamp.nRows; ky++) {
+    for (int kx = -1; kx <= stamp.nColumns; kx++) {
+      x = stamp.XValue(kx);
+      y = stamp.YValue(ky);
+      if ((kx < 0) || (kx >= stamp.nColumns) || (ky < 0) || (ky >= stamp.nRows)) {
+        // outside stamp: no lookup, and GetValue should give 0
+        TS_ASSERT( ! stamp.Lookup(x, y, value) );
+        TS_ASSERT_EQUALS( psfInterp->GetValue(x, y), 0.0 );
+      }
+      else {
+        TS_ASSERT( stamp.Lookup(x, y, value) );
+        TS_ASSERT_DELTA( value, psfInterp->GetValue(x, y), 1.0e-12 );
+        TS_ASSERT( ! stamp.Lookup(x + 0.25, y, value) );
+        TS_ASSERT( ! stamp.Lookup(x, y - 0.1, value) );
+      }
+    }
+  }
+}
+
+
+class TestShiftedPsfStamp : public CxxTest::TestSuite 
+{
+  vector<double>  psfPixels;
+  
+public:
+  void setUp()
+  {
+    MakeAsymmetricPSF(psfPixels);
+  }
+
+  // Lanczos interpolation at PSF pixel centers should reproduce the PSF pixels
+  // (checks row/column ordering of PSF data)
+  void testLanczos_PixelCenters( void )
+  {
+    PsfInterpolator_lanczos2  interp2(psfPixels.data(), N_COLS_ASYM, N_ROWS_ASYM);
+    PsfInterpolator_lanczos3  interp3(psfPixels.data(), N_COLS_ASYM, N_ROWS_ASYM);
+    
+    for (int j = 0; j < N_ROWS_ASYM; j++) {
+      for (int i = 0; i < N_COLS_ASYM; i++) {
+        double  x = i - 3.0;
+        double  y = j - 2.0;
+        TS_ASSERT_DELTA( interp2.GetValue(x, y), psfPixels[j*N_COLS_ASYM + i], DELTA );
+        TS_ASSERT_DELTA( interp3.GetValue(x, y), psfPixels[j*N_COLS_ASYM + i], DELTA );
+      }
+    }
+  }
+
+  void testStampLattice( void )
+  {
+    ShiftedPsfStamp  stamp;
+    
+    // bounds for 7 x 5 PSF are x = -3 to 3, y = -2 to 2
+    stamp.SetLattice(0.0, 0.0, -3.0, 3.0, -2.0, 2.0);
+    TS_ASSERT_EQUALS( stamp.nColumns, 7 );
+    TS_ASSERT_EQUALS( stamp.nRows, 5 );
+    TS_ASSERT_DELTA( stamp.XValue(0), -3.0, DELTA );
+    TS_ASSERT_DELTA( stamp.YValue(0), -2.0, DELTA );
+    stamp.SetLattice(0.3, 0.75, -3.0, 3.0, -2.0, 2.0);
+    TS_ASSERT_EQUALS( stamp.nColumns, 6 );
+    TS_ASSERT_EQUALS( stamp.nRows, 4 );
+    TS_ASSERT_DELTA( stamp.XValue(0), -2.7, DELTA );
+    TS_ASSERT_DELTA( stamp.YValue(3), 1.75, DELTA );
+    // stamp isn't usable until values are filled in
+    double  value;
+    TS_ASSERT( ! stamp.Lookup(-2.7, -1.25, value) );
+  }
+
+  void testLanczos2Stamp( void )
+  {
+    PsfInterpolator_lanczos2  interp(psfPixels.data(), N_COLS_ASYM, N_ROWS_ASYM);
+    CheckStampAgainstGetValue(&interp, 0.0, 0.0);
+    CheckStampAgainstGetValue(&interp, 0.5, 0.0);
+    CheckStampAgainstGetValue(&interp, 0.37, 0.81);
+  }
+
+  void testLanczos3Stamp( void )
+  {
+    PsfInterpolator_lanczos3  interp(psfPixels.data(), N_COLS_ASYM, N_ROWS_ASYM);
+    CheckStampAgainstGetValue(&interp, 0.0, 0.0);
+    CheckStampAgainstGetValue(&interp, 0.5, 0.0);
+    CheckStampAgainstGetValue(&interp, 0.37, 0.81);
+  }
+
+  void testBicubicStamp( void )
+  {
+    PsfInterpolator_bicubic  interp(psfPixels.data(), N_COLS_ASYM, N_ROWS_ASYM);
+    CheckStampAgainstGetValue(&interp, 0.0, 0.0);
+    CheckStampAgainstGetValue(&interp, 0.37, 0.81);
+  }
+
+  void testBicubicNativeStamp( void )
+  {
+    PsfInterpolator_bicubic_native  interp(psfPixels.data(), N_COLS_ASYM, N_ROWS_ASYM);
+    CheckStampAgainstGetValue(&interp, 0.0, 0.0);
+    CheckStampAgainstGetValue(&interp, 0.37, 0.81);
+  }
+
+  // native bicubic interpolation should match GSL's version
+  void testBicubicNative_vs_GSL( void )
+  {
+    PsfInterpolator_bicubic  interpGSL(psfPixels.data(), N_COLS_ASYM, N_ROWS_ASYM);
+    PsfInterpolator_bicubic_native  interp(psfPixels.data(), N_COLS_ASYM, N_ROWS_ASYM);
+    
+    for (double y = -2.0; y <= 2.0; y += 0.125)
+      for (double x = -3.0; x <= 3.0; x += 0.1)
+        TS_ASSERT_DELTA( interp.GetValue(x, y), interpGSL.GetValue(x, y), 1.0e-10 );
+  }
+};
+
+
+
 // Tests for auxiliary functions
 
 class TestLanczosFunction : public CxxTest::TestSuite